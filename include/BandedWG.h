@@ -5,7 +5,7 @@
 #include "DelayL.h"
 #include "BowTable.h"
 #include "ADSR.h"
-#include "BiQuad.h"
+#include "BiQuadBank.h"
 
 namespace stk {
 
@@ -102,7 +102,7 @@ class BandedWG : public Instrmnt
   int presetModes_;
   BowTable bowTable_;
   ADSR     adsr_;
-  BiQuad   bandpass_[MAX_BANDED_MODES];
+  BiQuadBank bandpass_;
   DelayL   delay_[MAX_BANDED_MODES];
   StkFloat maxVelocity_;
   StkFloat modes_[MAX_BANDED_MODES];
@@ -148,6 +148,18 @@ public:
   */
   void setEqualGainZeroes( void );
 
+  //! Clears all internal states of the filter.
+  void clear( void );
+
+  //! Set the number of adjacent interleaved channels filtered by the StkFrames tick() functions (default = 1).
+  /*!
+    Each channel has its own filter state, using the same
+    coefficients and gain, and lastFrame() holds the last output of
+    each.  The single-sample tick() function should only be used with
+    a single channel.  The filter states are cleared.
+  */
+  void setChannels( unsigned int nChannels );
+
   //! Return the last computed output value.
   StkFloat lastOut( void ) const { return lastFrame_[0]; };
 
@@ -162,6 +174,10 @@ public:
     However, range checking is only performed if _STK_DEBUG_ is
     defined during compilation, in which case an out-of-range value
     will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
@@ -173,6 +189,10 @@ public:
     by 0).  However, range checking is only performed if _STK_DEBUG_
     is defined during compilation, in which case an out-of-range value
     will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
   */
   StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
 
@@ -180,6 +200,10 @@ public:
 
   virtual void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
   
+  // Filter nFrames frames of the (interleaved) input and output,
+  // which may be the same.
+  void tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames );
+
   // Helper function to update the three intermediate values for the predefined filter types
   // along with the feedback filter coefficients. Performs the debug check for fc and Q-factor arguments.
   void setCommonFilterValues( StkFloat fc, StkFloat Q );
@@ -187,17 +211,28 @@ public:
   StkFloat K_;
   StkFloat kSqr_;
   StkFloat denom_;
+
+  // The recursive part of the filter is accumulated and stored in
+  // double precision, even when StkFloat is single precision, so that
+  // high-Q resonances are not swamped by rounding noise.
+  double y1_;
+  double y2_;
+
+  // The recursive states of all channels (y[n-1], then y[n-2]) when
+  // filtering more than one channel.
+  std::vector<double> states_;
 };
 
 inline StkFloat BiQuad :: tick( StkFloat input )
 {
   inputs_[0] = gain_ * input;
-  lastFrame_[0] = b_[0] * inputs_[0] + b_[1] * inputs_[1] + b_[2] * inputs_[2];
-  lastFrame_[0] -= a_[2] * outputs_[2] + a_[1] * outputs_[1];
+  double y = (double) b_[0] * inputs_[0] + (double) b_[1] * inputs_[1] + (double) b_[2] * inputs_[2];
+  y -= a_[2] * y2_ + a_[1] * y1_;
   inputs_[2] = inputs_[1];
   inputs_[1] = inputs_[0];
-  outputs_[2] = outputs_[1];
-  outputs_[1] = lastFrame_[0];
+  y2_ = y1_;
+  y1_ = y;
+  lastFrame_[0] = (StkFloat) y;
 
   return lastFrame_[0];
 }
@@ -205,7 +240,7 @@ inline StkFloat BiQuad :: tick( StkFloat input )
 inline StkFrames& BiQuad :: tick( StkFrames& frames, unsigned int channel )
 {
 #if defined(_STK_DEBUG_)
-  if ( channel >= frames.channels() ) {
+  if ( channel + channelsIn_ > frames.channels() ) {
     oStream_ << "BiQuad::tick(): channel and StkFrames arguments are incompatible!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
@@ -213,43 +248,20 @@ inline StkFrames& BiQuad :: tick( StkFrames& frames, unsigned int channel )
 
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    inputs_[0] = gain_ * *samples;
-    *samples = b_[0] * inputs_[0] + b_[1] * inputs_[1] + b_[2] * inputs_[2];
-    *samples -= a_[2] * outputs_[2] + a_[1] * outputs_[1];
-    inputs_[2] = inputs_[1];
-    inputs_[1] = inputs_[0];
-    outputs_[2] = outputs_[1];
-    outputs_[1] = *samples;
-  }
-
-  lastFrame_[0] = outputs_[1];
+  this->tickFrames( samples, hop, samples, hop, frames.frames() );
   return frames;
 }
 
 inline StkFrames& BiQuad :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
 {
 #if defined(_STK_DEBUG_)
-  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() ) {
+  if ( iChannel + channelsIn_ > iFrames.channels() || oChannel + channelsIn_ > oFrames.channels() ) {
     oStream_ << "BiQuad::tick(): channel and StkFrames arguments are incompatible!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 #endif
 
-  StkFloat *iSamples = &iFrames[iChannel];
-  StkFloat *oSamples = &oFrames[oChannel];
-  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
-  for ( unsigned int i=0; i<iFrames.frames(); i++, iSamples += iHop, oSamples += oHop ) {
-    inputs_[0] = gain_ * *iSamples;
-    *oSamples = b_[0] * inputs_[0] + b_[1] * inputs_[1] + b_[2] * inputs_[2];
-    *oSamples -= a_[2] * outputs_[2] + a_[1] * outputs_[1];
-    inputs_[2] = inputs_[1];
-    inputs_[1] = inputs_[0];
-    outputs_[2] = outputs_[1];
-    outputs_[1] = *oSamples;
-  }
-
-  lastFrame_[0] = outputs_[1];
+  this->tickFrames( &iFrames[iChannel], iFrames.channels(), &oFrames[oChannel], oFrames.channels(), iFrames.frames() );
   return iFrames;
 }
 
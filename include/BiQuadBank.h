@@ -0,0 +1,170 @@
+#ifndef STK_BIQUADBANK_H
+#define STK_BIQUADBANK_H
+
+#include "Stk.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class BiQuadBank
+    \brief STK bank of parallel biquad filter sections.
+
+    This class implements a set of independent two-pole, two-zero
+    filter sections that are ticked together, as used for the modal
+    resonators of the Modal, BandedWG and Shakers classes.  The
+    coefficients and states of all sections are stored in
+    structure-of-arrays form and the number of sections is padded to
+    a multiple of four with silent sections, so that the per-section
+    update is a single branch-free loop which the compiler can
+    vectorize for the target instruction set (SSE/AVX/NEON).
+
+    Each section computes exactly the same difference equation as the
+    BiQuad class, so a bank produces the same output as the
+    equivalent set of BiQuad instances.  The sections are computed in
+    double precision even when StkFloat is single precision, because
+    modal resonators are typically of very high Q.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class BiQuadBank : public Stk
+{
+public:
+
+  //! Default constructor creates a bank of \e nSections pass-through sections.
+  BiQuadBank( unsigned int nSections = 0 );
+
+  //! Class destructor.
+  ~BiQuadBank();
+
+  //! Set the number of sections.
+  /*!
+    Existing sections keep their coefficients and states, and any
+    new sections are initialized as pass-through filters.
+  */
+  void resize( unsigned int nSections );
+
+  //! Return the number of sections in the bank.
+  unsigned int size( void ) const { return nSections_; };
+
+  //! Clear the internal states of all sections.
+  void clear( void );
+
+  //! Set all coefficients of section \e index.
+  void setCoefficients( unsigned int index, StkFloat b0, StkFloat b1, StkFloat b2, StkFloat a1, StkFloat a2, bool clearState = false );
+
+  //! Set the a[1] coefficient value of section \e index.
+  void setA1( unsigned int index, StkFloat a1 ) { data_[A1 * nPadded_ + index] = a1; };
+
+  //! Set the a[2] coefficient value of section \e index.
+  void setA2( unsigned int index, StkFloat a2 ) { data_[A2 * nPadded_ + index] = a2; };
+
+  //! Set the filter coefficients of section \e index for a resonance at \e frequency (in Hz).
+  /*!
+    See BiQuad::setResonance() for a description of the arguments.
+  */
+  void setResonance( unsigned int index, StkFloat frequency, StkFloat radius, bool normalize = false );
+
+  //! Set the numerator coefficients of all sections for equal gain zeroes at +- 1.
+  /*!
+    See BiQuad::setEqualGainZeroes().
+  */
+  void setEqualGainZeroes( void );
+
+  //! Set the input gain of section \e index.
+  void setGain( unsigned int index, StkFloat gain ) { data_[GAIN * nPadded_ + index] = gain; };
+
+  //! Return the input gain of section \e index.
+  StkFloat getGain( unsigned int index ) const { return (StkFloat) data_[GAIN * nPadded_ + index]; };
+
+  //! Return the last output value of section \e index.
+  StkFloat lastOut( unsigned int index ) const { return (StkFloat) data_[Y1 * nPadded_ + index]; };
+
+  //! Return the sum of the last outputs of all sections.
+  StkFloat lastOut( void ) const { return lastOut_; };
+
+  //! Input one sample to all sections and return the sum of their outputs.
+  /*!
+    The input of each section is the product of \e input, its gain
+    and \e scale, computed in that order.
+  */
+  StkFloat tick( StkFloat input, StkFloat scale = 1.0 );
+
+  //! Input one sample to each section and return the sum of their outputs.
+  /*!
+    The \c inputs argument must point to at least size() values, one
+    per section.  Each input is multiplied by the section gain and
+    \e scale, in that order.
+  */
+  StkFloat tick( const StkFloat *inputs, StkFloat scale = 1.0 );
+
+protected:
+
+  // Offsets of the coefficient and state arrays within data_.
+  enum { GAIN, B0, B1, B2, A1, A2, X1, X2, Y1, Y2, N_ARRAYS };
+
+  StkFloat sumOutputs( const double *y1 );
+
+  unsigned int nSections_;
+  unsigned int nPadded_;
+  std::vector<double> data_;
+  StkFloat lastOut_;
+};
+
+inline StkFloat BiQuadBank :: sumOutputs( const double *y1 )
+{
+  // Sum in section order so that results match a loop over BiQuads.
+  lastOut_ = 0.0;
+  for ( unsigned int i=0; i<nSections_; i++ )
+    lastOut_ += (StkFloat) y1[i];
+  return lastOut_;
+}
+
+inline StkFloat BiQuadBank :: tick( StkFloat input, StkFloat scale )
+{
+  if ( nSections_ == 0 ) return lastOut_ = 0.0;
+
+  double *gain = &data_[0];
+  double *b0 = gain + nPadded_, *b1 = b0 + nPadded_, *b2 = b1 + nPadded_;
+  double *a1 = b2 + nPadded_, *a2 = a1 + nPadded_;
+  double *x1 = a2 + nPadded_, *x2 = x1 + nPadded_;
+  double *y1 = x2 + nPadded_, *y2 = y1 + nPadded_;
+  for ( unsigned int i=0; i<nPadded_; i++ ) {
+    double x0 = input * gain[i] * scale;
+    double y0 = b0[i] * x0 + b1[i] * x1[i] + b2[i] * x2[i];
+    y0 -= a2[i] * y2[i] + a1[i] * y1[i];
+    x2[i] = x1[i];
+    x1[i] = x0;
+    y2[i] = y1[i];
+    y1[i] = y0;
+  }
+
+  return sumOutputs( y1 );
+}
+
+inline StkFloat BiQuadBank :: tick( const StkFloat *inputs, StkFloat scale )
+{
+  if ( nSections_ == 0 ) return lastOut_ = 0.0;
+
+  double *gain = &data_[0];
+  double *b0 = gain + nPadded_, *b1 = b0 + nPadded_, *b2 = b1 + nPadded_;
+  double *a1 = b2 + nPadded_, *a2 = a1 + nPadded_;
+  double *x1 = a2 + nPadded_, *x2 = x1 + nPadded_;
+  double *y1 = x2 + nPadded_, *y2 = y1 + nPadded_;
+  for ( unsigned int i=0; i<nSections_; i++ ) {
+    double x0 = inputs[i] * gain[i] * scale;
+    double y0 = b0[i] * x0 + b1[i] * x1[i] + b2[i] * x2[i];
+    y0 -= a2[i] * y2[i] + a1[i] * y1[i];
+    x2[i] = x1[i];
+    x1[i] = x0;
+    y2[i] = y1[i];
+    y1[i] = y0;
+  }
+
+  return sumOutputs( y1 );
+}
+
+} // stk namespace
+
+#endif
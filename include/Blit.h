@@ -25,6 +25,12 @@ namespace stk {
     automatic modification of the number of harmonics is performed by
     the setFrequency() function).
 
+    The two sines of the algorithm are computed by recursive
+    oscillators (rotations of a cosine and sine pair), which are
+    resynchronized with the exact values at each period and near the
+    peaks of the impulses.  See the WaveTable class for a
+    table-based band-limited impulse train.
+
     Original code by Robin Davies, 2005.
     Revisions by Gary Scavone for STK, 2005.
 */
@@ -46,7 +52,7 @@ class Blit: public Generator
   /*!
     Set the phase of the signal, in the range 0 to 1.
   */
-  void setPhase( StkFloat phase ) { phase_ = PI * phase; };
+  void setPhase( StkFloat phase ) { phase_ = PI * phase; this->syncOscillators(); };
 
   //! Get the current phase of the signal.
   /*!
@@ -91,6 +97,8 @@ class Blit: public Generator
  protected:
 
   void updateHarmonics( void );
+  void syncOscillators( void );
+  void setRotations( void );
 
   unsigned int nHarmonics_;
   unsigned int m_;
@@ -98,6 +106,10 @@ class Blit: public Generator
   StkFloat phase_;
   StkFloat p_;
 
+  // Recursive oscillators for sin( phase_ ) and sin( m_ * phase_ ).
+  StkFloat sin_, cos_, sinM_, cosM_;
+  StkFloat sinRate_, cosRate_, sinMRate_, cosMRate_;
+
 };
 
 inline StkFloat Blit :: tick( void )
@@ -106,24 +118,34 @@ inline StkFloat Blit :: tick( void )
   // Smith with an additional scale factor of P / M applied to
   // normalize the output.
 
-  // A fully optimized version of this code would replace the two sin
-  // calls with a pair of fast sin oscillators, for which stable fast
-  // two-multiply algorithms are well known. In the spirit of STK,
-  // which favors clarity over performance, the optimization has not
-  // been made here.
+  // The two sines are computed by recursive oscillators, which are
+  // resynchronized near the sinc peak, where the relative accuracy of
+  // the denominator matters.
+  if ( fabs( sin_ ) < 1.0e-4 ) this->syncOscillators();
 
   // Avoid a divide by zero at the sinc peak, which has a limiting
   // value of 1.0.
-  StkFloat tmp, denominator = sin( phase_ );
+  StkFloat tmp, denominator = sin_;
   if ( denominator <= std::numeric_limits<StkFloat>::epsilon() )
     tmp = 1.0;
   else {
-    tmp =  sin( m_ * phase_ );
+    tmp =  sinM_;
     tmp /= m_ * denominator;
   }
 
   phase_ += rate_;
-  if ( phase_ >= PI ) phase_ -= PI;
+  if ( phase_ >= PI ) {
+    phase_ -= PI;
+    this->syncOscillators();
+  }
+  else {
+    StkFloat temp = sin_;
+    sin_ = temp * cosRate_ + cos_ * sinRate_;
+    cos_ = cos_ * cosRate_ - temp * sinRate_;
+    temp = sinM_;
+    sinM_ = temp * cosMRate_ + cosM_ * sinMRate_;
+    cosM_ = cosM_ * cosMRate_ - temp * sinMRate_;
+  }
 
   lastFrame_[0] = tmp;
 	return lastFrame_[0];
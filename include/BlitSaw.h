@@ -23,6 +23,12 @@ namespace stk {
     automatic modification of the number of harmonics is performed by
     the setFrequency() function).
 
+    The two sines of the algorithm are computed by recursive
+    oscillators (rotations of a cosine and sine pair), which are
+    resynchronized with the exact values at each period and near the
+    peaks of the impulses.  See the WaveTable class for a
+    table-based band-limited sawtooth.
+
     Based on initial code of Robin Davies, 2005.
     Modified algorithm code by Gary Scavone, 2005.
 */
@@ -77,6 +83,8 @@ class BlitSaw: public Generator
  protected:
 
   void updateHarmonics( void );
+  void syncOscillators( void );
+  void setRotations( void );
 
   unsigned int nHarmonics_;
   unsigned int m_;
@@ -87,6 +95,10 @@ class BlitSaw: public Generator
   StkFloat a_;
   StkFloat state_;
 
+  // Recursive oscillators for sin( phase_ ) and sin( m_ * phase_ ).
+  StkFloat sin_, cos_, sinM_, cosM_;
+  StkFloat sinRate_, cosRate_, sinMRate_, cosMRate_;
+
 };
 
 inline StkFloat BlitSaw :: tick( void )
@@ -99,19 +111,18 @@ inline StkFloat BlitSaw :: tick( void )
   // most consistently.  A "leaky integrator" is then applied to the
   // difference of the BLIT output and C2_. (GPS - 1 October 2005)
 
-  // A fully  optimized version of this code would replace the two sin 
-  // calls with a pair of fast sin oscillators, for which stable fast 
-  // two-multiply algorithms are well known. In the spirit of STK,
-  // which favors clarity over performance, the optimization has 
-  // not been made here.
+  // The two sines are computed by recursive oscillators, which are
+  // resynchronized near the sinc peak, where the relative accuracy of
+  // the denominator matters.
+  if ( fabs( sin_ ) < 1.0e-4 ) this->syncOscillators();
 
   // Avoid a divide by zero, or use of a denormalized divisor 
   // at the sinc peak, which has a limiting value of m_ / p_.
-  StkFloat tmp, denominator = sin( phase_ );
+  StkFloat tmp, denominator = sin_;
   if ( fabs(denominator) <= std::numeric_limits<StkFloat>::epsilon() )
     tmp = a_;
   else {
-    tmp =  sin( m_ * phase_ );
+    tmp =  sinM_;
     tmp /= p_ * denominator;
   }
 
@@ -119,7 +130,18 @@ inline StkFloat BlitSaw :: tick( void )
   state_ = tmp * 0.995;
 
   phase_ += rate_;
-  if ( phase_ >= PI ) phase_ -= PI;
+  if ( phase_ >= PI ) {
+    phase_ -= PI;
+    this->syncOscillators();
+  }
+  else {
+    StkFloat temp = sin_;
+    sin_ = temp * cosRate_ + cos_ * sinRate_;
+    cos_ = cos_ * cosRate_ - temp * sinRate_;
+    temp = sinM_;
+    sinM_ = temp * cosMRate_ + cosM_ * sinMRate_;
+    cosM_ = cosM_ * cosMRate_ - temp * sinMRate_;
+  }
     
   lastFrame_[0] = tmp;
 	return lastFrame_[0];
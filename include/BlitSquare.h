@@ -34,6 +34,12 @@ namespace stk {
     Blit waveforms.  This class is not guaranteed to be well behaved
     in the presence of significant aliasing.
 
+    The two sines of the algorithm are computed by recursive
+    oscillators (rotations of a cosine and sine pair), which are
+    resynchronized with the exact values at each period and near the
+    peaks of the impulses.  See the WaveTable class for a
+    table-based band-limited square wave.
+
     Based on initial code of Robin Davies, 2005.
     Modified algorithm code by Gary Scavone, 2005--2006.
 */
@@ -55,7 +61,7 @@ class BlitSquare: public Generator
   /*!
     Set the phase of the signal, in the range 0 to 1.
   */
-  void setPhase( StkFloat phase ) { phase_ = PI * phase; };
+  void setPhase( StkFloat phase ) { phase_ = PI * phase; this->syncOscillators(); };
 
   //! Get the current phase of the signal.
   /*!
@@ -100,6 +106,8 @@ class BlitSquare: public Generator
  protected:
 
   void updateHarmonics( void );
+  void syncOscillators( void );
+  void setRotations( void );
 
   unsigned int nHarmonics_;
   unsigned int m_;
@@ -109,21 +117,24 @@ class BlitSquare: public Generator
   StkFloat a_;
   StkFloat lastBlitOutput_;
   StkFloat dcbState_;
+
+  // Recursive oscillators for sin( phase_ ) and sin( m_ * phase_ ).
+  StkFloat sin_, cos_, sinM_, cosM_;
+  StkFloat sinRate_, cosRate_, sinMRate_, cosMRate_;
 };
 
 inline StkFloat BlitSquare :: tick( void )
 {
   StkFloat temp = lastBlitOutput_;
 
-  // A fully  optimized version of this would replace the two sin calls
-  // with a pair of fast sin oscillators, for which stable fast 
-  // two-multiply algorithms are well known. In the spirit of STK,
-  // which favors clarity over performance, the optimization has 
-  // not been made here.
+  // The two sines are computed by recursive oscillators, which are
+  // resynchronized near the sinc peaks, where the relative accuracy
+  // of the denominator matters.
+  if ( fabs( sin_ ) < 1.0e-4 ) this->syncOscillators();
 
   // Avoid a divide by zero, or use of a denomralized divisor
   // at the sinc peak, which has a limiting value of 1.0.
-  StkFloat denominator = sin( phase_ );
+  StkFloat denominator = sin_;
   if ( fabs( denominator )  < std::numeric_limits<StkFloat>::epsilon() ) {
     // Inexact comparison safely distinguishes betwen *close to zero*, and *close to PI*.
     if ( phase_ < 0.1f || phase_ > TWO_PI - 0.1f )
@@ -132,7 +143,7 @@ inline StkFloat BlitSquare :: tick( void )
       lastBlitOutput_ = -a_;
   }
   else {
-    lastBlitOutput_ =  sin( m_ * phase_ );
+    lastBlitOutput_ =  sinM_;
     lastBlitOutput_ /= p_ * denominator;
   }
 
@@ -143,7 +154,18 @@ inline StkFloat BlitSquare :: tick( void )
   dcbState_ = lastBlitOutput_;
 
   phase_ += rate_;
-  if ( phase_ >= TWO_PI ) phase_ -= TWO_PI;
+  if ( phase_ >= TWO_PI ) {
+    phase_ -= TWO_PI;
+    this->syncOscillators();
+  }
+  else {
+    StkFloat temp = sin_;
+    sin_ = temp * cosRate_ + cos_ * sinRate_;
+    cos_ = cos_ * cosRate_ - temp * sinRate_;
+    temp = sinM_;
+    sinM_ = temp * cosMRate_ + cosM_ * sinMRate_;
+    cosM_ = cosM_ * cosMRate_ - temp * sinMRate_;
+  }
 
 	return lastFrame_[0];
 }
@@ -0,0 +1,230 @@
+#ifndef STK_BOUNDEDQUEUE_H
+#define STK_BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class BoundedQueue
+    \brief STK bounded multi-producer / single-consumer queue.
+
+    This class template implements a bounded, lock-free queue of
+    items of type \e T, which can be pushed by any number of producer
+    threads and popped by one consumer thread.  Each queue cell
+    carries a sequence number which hands it between the producers
+    and the consumer, and the capacity is rounded up to a power of
+    two, so that index wrapping is a simple mask.  It is used by the
+    MessageQueue and ErrorLog classes.
+
+    Neither push() nor pop() blocks, locks or allocates memory.  When
+    the queue is full, push() returns \c false immediately and the
+    overrun counter is incremented.  Items can also be accessed in
+    place, with claim() and publish() by a producer and with front()
+    and release() by the consumer, to avoid copying them.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+template <class T>
+class BoundedQueue
+{
+ public:
+  //! Default constructor.
+  /*!
+    The capacity is rounded up to the next power of two items.
+  */
+  BoundedQueue( unsigned long nItems = 256 );
+
+  //! Resize the queue and discard its contents.
+  /*!
+    The capacity is rounded up to the next power of two items.  This
+    function is not thread-safe and should only be called while no
+    other thread is accessing the queue.
+  */
+  void resize( unsigned long nItems );
+
+  //! Discard the queue contents and reset the overrun counter.
+  /*!
+    This function is not thread-safe and should only be called while
+    no other thread is accessing the queue.
+  */
+  void reset( void );
+
+  //! Return the queue capacity in items.
+  unsigned long capacity( void ) const { return size_; };
+
+  //! Return the approximate number of queued items.
+  unsigned long size( void ) const;
+
+  //! Claim the next free cell and return its item for writing, or NULL if the queue is full.
+  /*!
+    The \c position argument is set to the claimed position, which
+    must be passed to publish() once the item has been written.  If
+    the queue is full, the overrun counter is incremented.
+  */
+  T *claim( unsigned long& position );
+
+  //! Make the item written at a position returned by claim() available to the consumer.
+  void publish( unsigned long position );
+
+  //! Push a copy of an item, returning \c false if the queue is full.
+  bool push( const T& item );
+
+  //! Pop the oldest item, returning \c false if the queue is empty.
+  /*!
+    Must only be called by the consumer thread.
+  */
+  bool pop( T& item );
+
+  //! Return the oldest item for reading, or NULL if the queue is empty.
+  /*!
+    The item must be passed back with release() once it has been
+    read.  Must only be called by the consumer thread.
+  */
+  T *front( void );
+
+  //! Remove the item returned by front() from the queue.
+  void release( void );
+
+  //! Return the number of items rejected because the queue was full, since instantiation or the last reset.
+  unsigned long getOverrunCount( void ) const { return overruns_.load( std::memory_order_relaxed ); };
+
+ protected:
+
+  struct Cell {
+    std::atomic<unsigned long> sequence;
+    T item;
+  };
+
+  std::vector<Cell> cells_;
+  unsigned long size_;
+  unsigned long mask_;
+
+  // Producer and consumer positions are free-running counters, padded
+  // onto separate cache lines to avoid false sharing.
+  char pad0_[64];
+  std::atomic<unsigned long> writeIndex_;
+  char pad1_[64 - sizeof(std::atomic<unsigned long>)];
+  std::atomic<unsigned long> readIndex_;
+  char pad2_[64 - sizeof(std::atomic<unsigned long>)];
+  std::atomic<unsigned long> overruns_;
+};
+
+template <class T>
+BoundedQueue<T> :: BoundedQueue( unsigned long nItems )
+  : size_( 0 ), mask_( 0 ), writeIndex_( 0 ), readIndex_( 0 ), overruns_( 0 )
+{
+  this->resize( nItems );
+}
+
+template <class T>
+void BoundedQueue<T> :: resize( unsigned long nItems )
+{
+  size_ = 1;
+  while ( size_ < nItems ) size_ <<= 1;
+  mask_ = size_ - 1;
+  std::vector<Cell> cells( size_ );
+  cells_.swap( cells );
+  this->reset();
+}
+
+template <class T>
+void BoundedQueue<T> :: reset( void )
+{
+  // A cell can be written at position i when its sequence equals i,
+  // and read when its sequence equals i + 1.
+  for ( unsigned long i=0; i<size_; i++ )
+    cells_[i].sequence.store( i, std::memory_order_relaxed );
+  writeIndex_.store( 0 );
+  readIndex_.store( 0 );
+  overruns_.store( 0 );
+}
+
+template <class T>
+inline unsigned long BoundedQueue<T> :: size( void ) const
+{
+  unsigned long count = writeIndex_.load() - readIndex_.load();
+  return ( count > size_ ) ? size_ : count;
+}
+
+template <class T>
+inline T *BoundedQueue<T> :: claim( unsigned long& position )
+{
+  Cell *cell;
+  position = writeIndex_.load( std::memory_order_relaxed );
+  while ( true ) {
+    cell = &cells_[position & mask_];
+    long difference = (long) ( cell->sequence.load( std::memory_order_acquire ) - position );
+    if ( difference == 0 ) {
+      // Claim the cell.  On failure, position is updated to the
+      // current write index and the loop tries again.
+      if ( writeIndex_.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+        return &cell->item;
+    }
+    else if ( difference < 0 ) {
+      // The consumer has not yet read the item a full lap ago.
+      overruns_.fetch_add( 1, std::memory_order_relaxed );
+      return 0;
+    }
+    else
+      position = writeIndex_.load( std::memory_order_relaxed );
+  }
+}
+
+template <class T>
+inline void BoundedQueue<T> :: publish( unsigned long position )
+{
+  cells_[position & mask_].sequence.store( position + 1, std::memory_order_release );
+}
+
+template <class T>
+inline bool BoundedQueue<T> :: push( const T& item )
+{
+  unsigned long position;
+  T *cellItem = this->claim( position );
+  if ( !cellItem ) return false;
+
+  *cellItem = item;
+  this->publish( position );
+  return true;
+}
+
+template <class T>
+inline T *BoundedQueue<T> :: front( void )
+{
+  unsigned long position = readIndex_.load( std::memory_order_relaxed );
+  Cell& cell = cells_[position & mask_];
+
+  // The queue is empty, or the oldest claimed cell is still being
+  // written, in which case its item is returned by a later call.
+  if ( cell.sequence.load( std::memory_order_acquire ) != position + 1 )
+    return 0;
+
+  return &cell.item;
+}
+
+template <class T>
+inline void BoundedQueue<T> :: release( void )
+{
+  unsigned long position = readIndex_.load( std::memory_order_relaxed );
+  cells_[position & mask_].sequence.store( position + size_, std::memory_order_release );
+  readIndex_.store( position + 1, std::memory_order_relaxed );
+}
+
+template <class T>
+inline bool BoundedQueue<T> :: pop( T& item )
+{
+  T *oldest = this->front();
+  if ( !oldest ) return false;
+
+  item = *oldest;
+  this->release();
+  return true;
+}
+
+} // stk namespace
+
+#endif
@@ -22,9 +22,6 @@ class Chorus : public Effect
 {
  public:
   //! Class constructor, taking the median desired delay length.
-  /*!
-    An StkError can be thrown if the rawwave path is incorrect.
-  */
   Chorus( StkFloat baseDelay = 6000 );
 
   //! Reset and clear all internal state.
@@ -0,0 +1,158 @@
+#ifndef STK_CONVREV_H
+#define STK_CONVREV_H
+
+#include "Effect.h"
+#include "Convolver.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class ConvRev
+    \brief STK convolution reverberator class.
+
+    This class takes a monophonic input signal and produces a stereo
+    output signal by convolving it with a measured or synthesized
+    room impulse response, using the partitioned FFT convolution of
+    the Convolver class, without added latency.  The impulse response
+    is read from a sound file supported by FileRead and resampled to
+    the current STK sample rate if necessary.  A stereo impulse
+    response gives a stereo reverberation, while a mono one gives the
+    same output in both channels.  Only the first two channels of a
+    file are used.
+
+    By default, the impulse response is scaled so that the channel
+    with the largest energy has unit energy, which gives similar
+    levels for impulse responses of different lengths.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class ConvRev : public Effect
+{
+ public:
+  //! Class constructor, which loads an impulse response file if a file name is given.
+  /*!
+    Without an impulse response, the effect output is the input.  An
+    StkError will be thrown if the file is not found or its format is
+    unknown or unsupported.
+  */
+  ConvRev( std::string fileName = "", bool normalize = true );
+
+  //! Load the impulse response from a sound file.
+  /*!
+    An StkError will be thrown if the file is not found or its format
+    is unknown or unsupported.  The impulse response is scaled to unit
+    energy if \e normalize is \c true.  The state is cleared.
+  */
+  void openFile( std::string fileName, bool normalize = true );
+
+  //! Set the impulse response from the first one or two channels of an StkFrames object.
+  /*!
+    The impulse response is scaled to unit energy if \e normalize is
+    \c true.  The state is cleared.
+  */
+  void setImpulse( StkFrames& impulse, bool normalize = true );
+
+  //! Return the length of the impulse response in frames.
+  unsigned long getLength( void ) const { return convolvers_[0].getLength(); };
+
+  //! Set the head size (a power of two, at least 16) and the partitioning type of the convolution (see Convolver).
+  void setPartitioning( unsigned int blockSize, bool uniform = false );
+
+  //! Reset and clear all internal state.
+  void clear( void );
+
+  //! Return the specified channel value of the last computed stereo frame.
+  /*!
+    Use the lastFrame() function to get both values of the last
+    computed stereo frame.  The \c channel argument must be 0 or 1
+    (the first channel is specified by 0).  However, range checking is
+    only performed if _STK_DEBUG_ is defined during compilation, in
+    which case an out-of-range value will trigger an StkError
+    exception.
+  */
+  StkFloat lastOut( unsigned int channel = 0 );
+
+  //! Input one sample to the effect and return the specified \c channel value of the computed stereo frame.
+  /*!
+    Use the lastFrame() function to get both values of the computed
+    stereo output frame. The \c channel argument must be 0 or 1 (the
+    first channel is specified by 0).  However, range checking is only
+    performed if _STK_DEBUG_ is defined during compilation, in which
+    case an out-of-range value will trigger an StkError exception.
+  */
+  StkFloat tick( StkFloat input, unsigned int channel = 0 );
+
+  //! Take a channel of the StkFrames object as inputs to the effect and replace with stereo outputs.
+  /*!
+    The StkFrames argument reference is returned.  The stereo
+    outputs are written to the StkFrames argument starting at the
+    specified \c channel.  Therefore, the \c channel argument must be
+    less than ( channels() - 1 ) of the StkFrames argument (the first
+    channel is specified by 0).  However, range checking is only
+    performed if _STK_DEBUG_ is defined during compilation, in which
+    case an out-of-range value will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+  //! Take a channel of the \c iFrames object as inputs to the effect and write stereo outputs to the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  The \c iChannel
+    argument must be less than the number of channels in the \c
+    iFrames argument (the first channel is specified by 0).  The \c
+    oChannel argument must be less than ( channels() - 1 ) of the \c
+    oFrames argument.  However, range checking is only performed if
+    _STK_DEBUG_ is defined during compilation, in which case an
+    out-of-range value will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+ protected:
+
+  // The number of frames convolved at once by the StkFrames tick()
+  // functions.
+  static const unsigned int BLOCK_SIZE = 256;
+
+  void tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames );
+
+  Convolver convolvers_[2];
+  unsigned int nChannels_;
+  StkFloat scale_;
+  StkFrames buffer_;
+
+};
+
+inline StkFloat ConvRev :: lastOut( unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel > 1 ) {
+    oStream_ << "ConvRev::lastOut(): channel argument must be less than 2!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  return lastFrame_[channel];
+}
+
+inline StkFloat ConvRev :: tick( StkFloat input, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel > 1 ) {
+    oStream_ << "ConvRev::tick(): channel argument must be less than 2!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat left = scale_ * convolvers_[0].tick( input );
+  StkFloat right = ( nChannels_ > 1 ) ? scale_ * convolvers_[1].tick( input ) : left;
+  StkFloat temp = ( 1.0 - effectMix_ ) * input;
+  lastFrame_[0] = effectMix_ * left + temp;
+  lastFrame_[1] = effectMix_ * right + temp;
+
+  return lastFrame_[channel];
+}
+
+} // stk namespace
+
+#endif
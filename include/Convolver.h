@@ -0,0 +1,145 @@
+#ifndef STK_CONVOLVER_H
+#define STK_CONVOLVER_H
+
+#include "FFT.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class Convolver
+    \brief STK partitioned convolution class.
+
+    This class convolves its input with an impulse response of any
+    length without latency, using partitioned FFT convolution.  The
+    first \e blockSize taps (the head) are computed directly, so that
+    each output depends on the current input.  The remaining taps are
+    divided into partitions, which are convolved in the frequency
+    domain (uniformly partitioned overlap-save convolution) each time
+    a block of inputs is complete, at a cost per sample which grows
+    only logarithmically with the partition size.
+
+    With uniform partitioning, all tail partitions have the head
+    size.  With non-uniform partitioning (the default), the
+    partition size grows by a factor of four every three partitions,
+    up to 16384 frames, so that long impulse responses (hundreds of
+    thousands of taps) need few partitions.  All computations are
+    done synchronously within the tick() functions, so that the
+    processing time of a tick varies: the block at which a large
+    partition is completed takes much longer than the average.
+
+    The tick() functions can be called with single samples or with
+    blocks of any size and give identical outputs.  Memory is only
+    allocated when the impulse response or the partitioning is set.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class Convolver : public Stk
+{
+ public:
+  //! Default constructor creates a pass-through convolver with the given head size (a power of two, default = 64).
+  Convolver( unsigned int blockSize = 64, bool uniform = false );
+
+  //! Class destructor.
+  ~Convolver( void );
+
+  //! Set the impulse response from \e length values, taken every \e stride values from the given array.
+  void setImpulse( const StkFloat *impulse, unsigned long length, unsigned int stride = 1 );
+
+  //! Set the impulse response from a vector of values.
+  void setImpulse( const std::vector<StkFloat> &impulse );
+
+  //! Set the head size (a power of two, at least 16) and the partitioning type of the convolution.
+  /*!
+    Smaller head sizes give a lower cost for short impulse responses
+    and a more even processing time, while larger head sizes reduce
+    the FFT overhead for long impulse responses.  The state is
+    cleared.
+  */
+  void setPartitioning( unsigned int blockSize, bool uniform = false );
+
+  //! Return the length of the impulse response.
+  unsigned long getLength( void ) const { return length_; };
+
+  //! Clear the convolution state.
+  void clear( void );
+
+  //! Return the last computed output value.
+  StkFloat lastOut( void ) const { return lastOut_; };
+
+  //! Input one sample and return one output.
+  StkFloat tick( StkFloat input );
+
+  //! Take a channel of the StkFrames object as inputs and replace with corresponding outputs.
+  /*!
+    The StkFrames argument reference is returned.  The \c channel
+    argument must be less than the number of channels in the
+    StkFrames argument (the first channel is specified by 0).
+    However, range checking is only performed if _STK_DEBUG_ is
+    defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+  //! Take a channel of the \c iFrames object as inputs and write outputs to the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  Each channel
+    argument must be less than the number of channels in the
+    corresponding StkFrames argument (the first channel is specified
+    by 0).  However, range checking is only performed if _STK_DEBUG_
+    is defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+  //! Convolve \e nFrames inputs, taken every \e iHop values, and write the outputs every \e oHop values.
+  /*!
+    The input and output arrays may be the same.
+  */
+  void tick( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames );
+
+ protected:
+
+  // A set of equal size partitions of the impulse response tail,
+  // starting at the tap equal to their size.
+  struct Level {
+    unsigned int size;
+    unsigned int nPartitions;
+    unsigned int newest;               // index of the newest input spectrum
+    FFT fft;
+    std::vector<StkFloat> impulse;     // partition spectra (real, then imaginary parts)
+    std::vector<StkFloat> inputs;      // input block spectra, in the same format
+    std::vector<StkFloat> outputs;     // outputs for the current block
+  };
+
+  // The largest partition size used with non-uniform partitioning.
+  static const unsigned int MAX_PARTITION_SIZE = 16384;
+
+  void configure( void );
+  void processLevel( Level& level );
+  void tickBlock( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned int nFrames );
+
+  std::vector<StkFloat> taps_;
+  unsigned long length_;
+  unsigned int blockSize_;
+  bool uniform_;
+  std::vector<StkFloat> head_;
+  std::vector<Level> levels_;
+  std::vector<StkFloat> history_;      // the most recent inputs, stored twice
+  unsigned int historySize_;
+  unsigned int position_;
+  std::vector<StkFloat> block_;
+  std::vector<StkFloat> work_;
+  StkFloat lastOut_;
+};
+
+inline StkFloat Convolver :: tick( StkFloat input )
+{
+  this->tickBlock( &input, 1, &lastOut_, 1, 1 );
+  return lastOut_;
+}
+
+} // stk namespace
+
+#endif
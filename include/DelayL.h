@@ -145,18 +145,26 @@ inline void DelayL :: setDelay( StkFloat delay )
     handleError( StkError::WARNING ); return;
   }
 
-  StkFloat outPointer = inPoint_ - delay;  // read chases write
+  // Split the delay into its integer and fractional parts before
+  // offsetting the write pointer, so that the fractional part keeps
+  // full precision for long delay lines in single precision.
+  unsigned long integer = (unsigned long) delay;
+  StkFloat fraction = delay - integer;
   delay_ = delay;
 
-  while ( outPointer < 0 )
-    outPointer += inputs_.size(); // modulo maximum length
-
-  outPoint_ = (long) outPointer;   // integer part
-
-  alpha_ = outPointer - outPoint_; // fractional part
+  long outPointer = (long) inPoint_ - (long) integer;  // read chases write
+  if ( fraction > 0.0 ) {
+    outPointer -= 1;
+    alpha_ = (StkFloat) 1.0 - fraction;
+  }
+  else
+    alpha_ = 0.0;
   omAlpha_ = (StkFloat) 1.0 - alpha_;
 
-  if ( outPoint_ == inputs_.size() ) outPoint_ = 0;
+  if ( outPointer < 0 )
+    outPointer += inputs_.size(); // modulo maximum length
+
+  outPoint_ = outPointer;
   doNextOut_ = true;
 }
 
@@ -0,0 +1,125 @@
+#ifndef STK_DISKSTREAM_H
+#define STK_DISKSTREAM_H
+
+#include "Stk.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace stk {
+
+class FileWvIn;
+
+/***************************************************/
+/*! \class DiskStream
+    \brief STK background prefetcher for streamed audio files.
+
+    This class moves the disk reads of a FileWvIn or FileLoop
+    instance that incrementally loads its file in chunks (see the
+    \e chunkThreshold constructor argument of those classes) off the
+    audio thread.  Each stream owns a small set of chunk buffers.
+    While one buffer is being played, the chunks that follow in the
+    current playback direction are read ahead by a process-wide pool
+    of I/O threads.  The number of chunks read ahead grows with the
+    absolute playback rate, so that roughly the same amount of time is
+    buffered at any rate.
+
+    The audio thread never waits for the I/O threads: finished buffers
+    are handed over through an atomic state per buffer.  If a needed
+    chunk has not been read in time (or playback jumped to an
+    unpredicted position), the chunk is read synchronously as without
+    prefetching and the underrun counter of the stream is
+    incremented.  If an I/O thread is reading from the file at that
+    moment, the audio thread does not wait for it either.  Silence is
+    output instead until the chunk has been read by an I/O thread.
+
+    The I/O threads are started when the first stream is created.
+    Their number can be set with setThreadCount() and prefetching can
+    be disabled for subsequently opened files with setEnabled().
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class DiskStream : public Stk
+{
+ public:
+  //! Create a stream of chunks of \e nFrames frames and \e nChannels channels, read by \e owner.
+  DiskStream( FileWvIn *owner, unsigned long nFrames, unsigned int nChannels );
+
+  //! Class destructor.
+  /*!
+    Waits for any read of this stream in progress on an I/O thread to
+    complete.
+  */
+  ~DiskStream( void );
+
+  //! Make the chunk starting at \e pointer current, synchronously reading it if necessary, and return its data.
+  const StkFrames& fetch( long pointer );
+
+  //! Return the data of the current chunk.
+  /*!
+    If the last chunk fetched could not be read without waiting, this
+    returns silence until the chunk has been read by an I/O thread.
+  */
+  const StkFrames& data( void ) { if ( pending_ >= 0 ) this->takePending(); return slots_[current_].frames; };
+
+  //! Schedule the chunks that follow the current chunk at the given playback rate to be read ahead.
+  void prefetch( StkFloat rate );
+
+  //! Return the number of chunks that were not read ahead in time.
+  unsigned long getUnderrunCount( void ) const { return underruns_.load( std::memory_order_relaxed ); };
+
+  //! Reset the underrun counter to zero.
+  void resetUnderrunCount( void ) { underruns_.store( 0, std::memory_order_relaxed ); };
+
+  //! Set the number of I/O threads shared by all streams (default = 2).
+  static void setThreadCount( unsigned int nThreads );
+
+  //! Return the number of I/O threads shared by all streams.
+  static unsigned int getThreadCount( void );
+
+  //! Enable or disable prefetching for subsequently opened files (default = enabled).
+  static void setEnabled( bool enabled );
+
+  //! Return whether prefetching is enabled.
+  static bool isEnabled( void );
+
+ protected:
+
+  enum SlotState { FREE, QUEUED, LOADING, READY };
+
+  struct Slot {
+    StkFrames frames;
+    long pointer;
+    std::atomic<int> state;
+    Slot() : pointer( -1 ), state( FREE ) {}
+  };
+
+  // Return the index of the slot holding or loading the chunk at pointer, or -1.
+  int findSlot( long pointer ) const;
+
+  // Make the pending chunk current if it has been read.
+  void takePending( void );
+
+  // Return true if a chunk is queued for reading.
+  bool hasWork( void ) const;
+
+  // Claim a queued chunk and read it, returning false if there was none.
+  bool service( void );
+
+  // The I/O thread function.
+  static void ioThread( unsigned int index );
+
+  FileWvIn *owner_;
+  std::vector<Slot> slots_;
+  unsigned int current_;
+  long pending_;
+  std::mutex readMutex_;
+  std::atomic<unsigned int> busy_;
+  std::atomic<unsigned long> underruns_;
+};
+
+} // stk namespace
+
+#endif
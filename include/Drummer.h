@@ -15,7 +15,8 @@ namespace stk {
     synthesizer using WvIn objects and one-pole
     filters.  The drum rawwave files are sampled
     at 22050 Hz, but will be appropriately
-    interpolated for other sample rates.  You can
+    interpolated for other sample rates, with
+    band-limited (Resampler::MEDIUM) interpolation.  You can
     specify the maximum polyphony (maximum number
     of simultaneous voices) via a #define in the
     Drummer.h.
@@ -0,0 +1,184 @@
+#ifndef STK_EVENTSCHEDULER_H
+#define STK_EVENTSCHEDULER_H
+
+#include "Skini.h"
+#include "Voicer.h"
+#include <vector>
+
+namespace stk {
+
+class Messager;
+
+/***************************************************/
+/*! \class EventScheduler
+    \brief STK sample-accurate control event scheduler.
+
+    This class holds time-stamped control messages (Skini::Message
+    structures) and applies each one at its exact sample frame while
+    audio is computed in blocks.  Rather than polling for control
+    input every few frames, an audio callback asks the scheduler for
+    the number of frames until the next event with dispatch(), which
+    first applies all events that are due, and then computes that many
+    frames at once.  The tick() function does this for a Voicer or a
+    single instrument, splitting the given block exactly at the event
+    boundaries.
+
+    Events can be scheduled at an absolute frame, with SKINI score
+    timing (delta or absolute times in seconds, as read from a
+    scorefile), from raw MIDI bytes (for example, from MidiFileIn),
+    or collected from a Messager with pollMessages().  Realtime
+    messages from a Messager are placed according to their arrival
+    time stamps, with a constant latency of one audio block, so that
+    their relative timing is preserved within the block.
+
+    Due events are passed to a user-supplied handler function if one
+    is set.  Otherwise, note, control change, aftertouch and pitch
+    messages are applied to the Voicer (in its default group) or
+    instrument.  A handler can call postpone() to delay the current
+    event and all later ones, for example to let voices settle before
+    a program change.
+
+    Events are kept in a preallocated heap, so scheduling and
+    dispatching do not allocate memory.  Events scheduled for the
+    same frame are dispatched in the order in which they were
+    scheduled.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class EventScheduler : public Stk
+{
+ public:
+  //! A function which handles a due control message.
+  typedef void (*EventHandler)( const Skini::Message& message, void *userData );
+
+  //! Class constructor, taking the maximum number of pending events.
+  EventScheduler( unsigned long nEvents = 1024 );
+
+  //! Class destructor.
+  ~EventScheduler( void );
+
+  //! Set a function to handle due events, replacing the default Voicer or instrument dispatching (NULL to clear).
+  void setHandler( EventHandler handler, void *userData = 0 );
+
+  //! Set a Voicer to which events are dispatched and which is computed by tick().
+  void setVoicer( Voicer *voicer );
+
+  //! Set an instrument to which events are dispatched and which is computed by tick().
+  void setInstrument( Instrmnt *instrument );
+
+  //! Discard all pending events and reset the frame count and score time to zero.
+  void reset( void );
+
+  //! Return the number of frames computed since instantiation or the last reset.
+  unsigned long getFrame( void ) const { return frame_; };
+
+  //! Return the number of pending events.
+  unsigned long getEventCount( void ) const { return (unsigned long) events_.size(); };
+
+  //! Return the number of events which could not be scheduled because the maximum number of pending events was reached.
+  unsigned long getOverrunCount( void ) const { return overruns_; };
+
+  //! Schedule a message at the given absolute frame, returning \c false if there is no room.
+  /*!
+    A message scheduled for a frame which has already been computed
+    is dispatched at the next call to dispatch().
+  */
+  bool schedule( const Skini::Message& message, unsigned long frame );
+
+  //! Schedule a message with SKINI score timing, returning \c false if there is no room.
+  /*!
+    A non-negative message time is a delay in seconds from the
+    previous message scheduled with this function (or from the
+    current frame, if that is later), while a negative time is an
+    absolute time in seconds since the last reset.  As in the demo
+    program, delays are truncated to whole frames per message.
+  */
+  bool scheduleMessage( const Skini::Message& message );
+
+  //! Schedule a MIDI channel message from raw bytes at the given absolute frame, returning \c false if it is not a valid channel message or there is no room.
+  /*!
+    The bytes are converted in the same way as MIDI input by the
+    Messager class.  For a MidiFileIn, the frame of an event is the
+    sum of the preceding event delta ticks times the value of
+    getTickSeconds() times the sample rate.
+  */
+  bool scheduleMidi( const unsigned char *bytes, size_t nBytes, unsigned long frame );
+
+  //! Collect the available messages from a Messager for the next block of \e nFrames frames and return their number.
+  /*!
+    This function should be called once at the start of each audio
+    block.  For scorefile input, messages are read with SKINI score
+    timing until the first message beyond the block, or an exit
+    message, is reached.  For realtime input, all queued messages are
+    taken and each is placed in the block at its arrival time
+    relative to the previous call, plus any message delay.
+  */
+  unsigned long pollMessages( Messager& messager, unsigned long nFrames );
+
+  //! Delay all pending events, including the one being dispatched, by \e nFrames frames.
+  /*!
+    When called from a handler, the current event is dispatched
+    again after the delay, before any other event scheduled for the
+    same frame.
+  */
+  void postpone( unsigned long nFrames );
+
+  //! Apply all due events, then advance by and return the number of frames until the next event, at most \e nFrames.
+  /*!
+    The returned number of frames must be computed by the caller
+    before dispatch() is called again.  A typical audio callback
+    looks like this:
+
+    \code
+    while ( nFrames > 0 ) {
+      unsigned long n = scheduler.dispatch( nFrames );
+      // compute n frames ...
+      nFrames -= n;
+    }
+    \endcode
+  */
+  unsigned long dispatch( unsigned long nFrames );
+
+  //! Fill a channel of the StkFrames object with computed outputs of the Voicer or instrument, applying due events at their exact frames, and return the same reference.
+  /*!
+    The Voicer or instrument may write more than one channel,
+    starting at \e channel, as with its own tick() function.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+ protected:
+
+  struct Event {
+    unsigned long frame;
+    unsigned long sequence;
+    Skini::Message message;
+  };
+
+  // Heap ordering, so that the earliest (and first scheduled) event is on top.
+  static bool later( const Event& a, const Event& b );
+
+  bool insert( const Skini::Message& message, unsigned long frame, unsigned long sequence );
+  void apply( const Skini::Message& message );
+
+  std::vector<Event> events_;
+  unsigned long capacity_;
+  unsigned long sequence_;
+  unsigned long frame_;
+  unsigned long scoreFrame_;
+  unsigned long postponed_;
+  Skini::Message message_;
+  unsigned long overruns_;
+  double pollTime_;
+  bool scoreEnded_;
+  EventHandler handler_;
+  void *userData_;
+  Voicer *voicer_;
+  Instrmnt *instrument_;
+  StkFrames segment_;
+};
+
+} // stk namespace
+
+#endif
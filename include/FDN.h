@@ -0,0 +1,270 @@
+#ifndef STK_FDN_H
+#define STK_FDN_H
+
+#include "Stk.h"
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class FDN
+    \brief STK feedback delay network class.
+
+    This class implements the core of a reverberator: a set of delay
+    lines in parallel with feedback, each with a one-pole lowpass
+    (damping) filter in its loop.  The feedback of each line is either
+    independent of the others (a bank of parallel comb filters, as in
+    the JCRev, NRev and FreeVerb classes) or mixed between all the
+    lines by a Householder matrix (a feedback delay network).  The
+    monophonic input is added to all the lines, and the lines are
+    mixed to 1 - 16 output channels by an output matrix.
+
+    The delay lines are stored one after another in a single buffer,
+    and the tick( StkFrames& ) function processes blocks of up to 64
+    samples (limited by the shortest delay) one delay line at a time,
+    in contiguous segments of the lines without wrap tests.  The
+    loops over the samples of a block, other than the damping filter
+    recursions, can be vectorized by the compiler.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class FDN : public Stk
+{
+ public:
+  //! Feedback mixing matrices.
+  enum Mixing {
+    DIAGONAL,     /*!< Parallel comb filters, without mixing (default). */
+    HOUSEHOLDER   /*!< Householder matrix, I - 2/N for all lines. */
+  };
+
+  //! Class constructor, taking the number of delay lines and output channels.
+  /*!
+    The default delays are mutually prime lengths between about 25
+    and 47 milliseconds, the feedback gains give a T60 decay time of
+    one second and each line feeds one output channel in turn.  An
+    StkError will be thrown if the number of lines is zero or the
+    number of channels is not between 1 and 16.
+  */
+  FDN( unsigned int nLines = 8, unsigned int nChannels = 2 );
+
+  //! Class destructor.
+  ~FDN( void );
+
+  //! Reset and clear all internal state.
+  void clear( void );
+
+  //! Return the number of delay lines.
+  unsigned int getLines( void ) const { return nLines_; };
+
+  //! Return the number of output channels for the class.
+  unsigned int channelsOut( void ) const { return nChannels_; };
+
+  //! Set the delay of a line, in samples, and the delay of its output.
+  /*!
+    The input of the line is delayed by \e delay samples in the
+    feedback loop.  By default (\e outputDelay = 0), the output of the
+    line is its current input; otherwise, it is its input delayed by
+    \e outputDelay samples, which must not be larger than \e delay.
+    The line is cleared.
+  */
+  void setDelay( unsigned int line, unsigned long delay, unsigned long outputDelay = 0 );
+
+  //! Return the feedback delay of a line.
+  unsigned long getDelay( unsigned int line ) const;
+
+  //! Set the feedback gain of a line.
+  void setFeedback( unsigned int line, StkFloat gain );
+
+  //! Set the feedback gains of all lines for a T60 decay time in seconds.
+  void setT60( StkFloat T60 );
+
+  //! Set the pole of the lowpass damping filters (0.0 - 1.0, default = 0.0).
+  /*!
+    The damping filters have a unity gain at DC and no effect for a
+    pole of 0.0.
+  */
+  void setDamping( StkFloat pole );
+
+  //! Set the feedback mixing matrix (default = DIAGONAL).
+  void setMixing( Mixing mixing );
+
+  //! Set the gain from a line to an output channel.
+  void setOutputGain( unsigned int line, unsigned int channel, StkFloat gain );
+
+  //! Return an StkFrames reference to the last output sample frame.
+  const StkFrames& lastFrame( void ) const { return lastFrame_; };
+
+  //! Return the specified channel value of the last computed frame.
+  StkFloat lastOut( unsigned int channel = 0 );
+
+  //! Input one sample and return the specified \c channel value of the computed frame.
+  /*!
+    Use the lastFrame() function to get all values of the computed
+    frame.  The \c channel argument must be less than the number of
+    output channels.  However, range checking is only performed if
+    _STK_DEBUG_ is defined during compilation, in which case an
+    out-of-range value will trigger an StkError exception.
+  */
+  StkFloat tick( StkFloat input, unsigned int channel = 0 );
+
+  //! Take a channel of the \c iFrames object as inputs and write the output channels to the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  The \c iChannel
+    argument must be less than the number of channels in the \c
+    iFrames argument (the first channel is specified by 0).  The
+    outputs are written starting at channel \c oChannel, which must be
+    less than the number of channels of \c oFrames minus channelsOut(),
+    and \c oFrames must have at least as many frames as \c iFrames.
+    However, range checking is only performed if _STK_DEBUG_ is
+    defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+ protected:
+
+  // The maximal number of samples processed together.
+  static const unsigned int BLOCK_SIZE = 64;
+
+  struct Line {
+    unsigned long offset;       // start of the line in the buffer
+    unsigned long length;       // length of the line in the buffer
+    unsigned long inPoint;      // write position in the line
+    unsigned long readPoint;    // position of the delayed value
+    unsigned long tapPoint;     // position of the output value
+    unsigned long delay;
+    unsigned long outputDelay;
+    StkFloat gain;              // feedback gain
+    StkFloat state;             // damping filter output
+  };
+
+  // Move the delay lines in a new buffer, after the size of one of
+  // them has changed.
+  void allocate( void );
+
+  // Set the read and output tap positions of a line from its write
+  // position.
+  void setPoints( Line& l );
+
+  unsigned int nLines_;
+  unsigned int nChannels_;
+  unsigned long blockSize_;             // min( BLOCK_SIZE, shortest delay )
+
+  std::vector<StkFloat> buffer_;        // all the delay lines, one after another
+  std::vector<Line> lines_;
+  std::vector<StkFloat> outputGains_;   // nLines_ x nChannels_
+  std::vector<StkFloat> block_;         // nLines_ x BLOCK_SIZE line values
+  std::vector<StkFloat> outputs_;       // nChannels_ x BLOCK_SIZE output values
+  StkFloat pole_;
+  StkFloat b0_;
+  Mixing mixing_;
+  StkFrames lastFrame_;
+};
+
+inline StkFloat FDN :: lastOut( unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel >= nChannels_ ) {
+    oStream_ << "FDN::lastOut(): channel argument is invalid!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  return lastFrame_[channel];
+}
+
+inline StkFloat FDN :: tick( StkFloat input, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel >= nChannels_ ) {
+    oStream_ << "FDN::tick(): channel argument is invalid!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *x = &block_[0];
+  StkFloat *buffer = &buffer_[0];
+  Line *lines = &lines_[0];
+  const StkFloat *gains = &outputGains_[0];
+  const StkFloat b0 = b0_, pole = pole_;
+  const bool damped = ( pole != 0.0 );
+  StkFloat sum, out = 0.0;
+  unsigned int i, c;
+
+  // Each line is damped (unless the pole is zero), written and read at
+  // its output tap, which is the new value for a line without an output
+  // delay, and the taps are mixed to the first output channel.  With
+  // 32-bit floats, the filter outputs are clamped to zero before they
+  // decay into the denormal range (see FreeVerb).  The Householder
+  // matrix needs all the damped values before any line is written.
+  if ( mixing_ == HOUSEHOLDER ) {
+    sum = 0.0;
+    for ( i=0; i<nLines_; i++ ) {
+      Line& l = lines[i];
+      StkFloat state = buffer[l.offset + l.readPoint];
+      if ( damped ) state = b0 * state + pole * l.state;
+#if defined(__STK_FLOAT32__)
+      state += 9.8607615E-32f;
+      state -= 9.8607615E-32f;
+#endif
+      l.state = state;
+      x[i] = l.gain * state;
+      sum += x[i];
+    }
+    sum *= 2.0 / nLines_;
+    for ( i=0; i<nLines_; i++ ) {
+      Line& l = lines[i];
+      StkFloat *line = buffer + l.offset;
+      unsigned long length = l.length, inPoint = l.inPoint, tapPoint = l.tapPoint;
+      line[inPoint] = input + ( x[i] - sum );
+      x[i] = line[tapPoint];
+      out += gains[i * nChannels_] * x[i];
+      if ( ++inPoint == length ) inPoint = 0;
+      if ( ++tapPoint == length ) tapPoint = 0;
+      if ( ++l.readPoint == length ) l.readPoint = 0;
+      l.inPoint = inPoint;
+      l.tapPoint = tapPoint;
+    }
+  }
+  else {
+    for ( i=0; i<nLines_; i++ ) {
+      Line& l = lines[i];
+      StkFloat *line = buffer + l.offset;
+      unsigned long length = l.length, inPoint = l.inPoint, readPoint = l.readPoint, tapPoint = l.tapPoint;
+      StkFloat state = line[readPoint];
+      if ( damped ) state = b0 * state + pole * l.state;
+#if defined(__STK_FLOAT32__)
+      state += 9.8607615E-32f;
+      state -= 9.8607615E-32f;
+#endif
+      l.state = state;
+      line[inPoint] = input + l.gain * state;
+      x[i] = line[tapPoint];
+      out += gains[i * nChannels_] * x[i];
+      if ( ++inPoint == length ) inPoint = 0;
+      if ( ++readPoint == length ) readPoint = 0;
+      if ( ++tapPoint == length ) tapPoint = 0;
+      l.inPoint = inPoint;
+      l.readPoint = readPoint;
+      l.tapPoint = tapPoint;
+    }
+  }
+  lastFrame_[0] = out;
+
+  // Mix the lines to the other output channels, in the order of the lines.
+  for ( c=1; c<nChannels_; c++ ) {
+    gains = &outputGains_[c];
+    sum = 0.0;
+    for ( i=0; i<nLines_; i++, gains += nChannels_ )
+      sum += *gains * x[i];
+    lastFrame_[c] = sum;
+  }
+
+  return lastFrame_[channel];
+}
+
+} // stk namespace
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef STK_FFT_H
+#define STK_FFT_H
+
+#include "Stk.h"
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class FFT
+    \brief STK real-input fast Fourier transform class.
+
+    This class computes the discrete Fourier transform of a block of
+    real values, the size of which must be a power of two, and its
+    inverse.  The transform of N real values is computed with a
+    complex radix-2 transform of N/2 points, and the N/2 + 1
+    non-redundant frequency bins (from DC to the Nyquist frequency)
+    are stored in separate arrays of real and imaginary parts, so
+    that spectra can be combined in loops which the compiler can
+    vectorize.
+
+    The forward transform is unscaled and the inverse transform is
+    scaled by 1/N, so that the inverse of the forward transform
+    returns the original values.  The tables and work buffers are
+    allocated when the size is set, so that the transforms do not
+    allocate memory.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class FFT : public Stk
+{
+ public:
+  //! Class constructor, taking the transform size (a power of two, at least 4, or 0 for none).
+  FFT( unsigned int size = 0 );
+
+  //! Class destructor.
+  ~FFT( void );
+
+  //! Set the transform size, which must be a power of two and at least 4.
+  void setSize( unsigned int size );
+
+  //! Return the transform size.
+  unsigned int getSize( void ) const { return size_; };
+
+  //! Compute the spectrum of \e size real input values.
+  /*!
+    The \e real and \e imag arrays must each have room for \e size /
+    2 + 1 values.  The imaginary parts of the DC and Nyquist bins
+    are zero.
+  */
+  void forward( const StkFloat *input, StkFloat *real, StkFloat *imag );
+
+  //! Compute \e size real output values from a spectrum of \e size / 2 + 1 bins.
+  /*!
+    The imaginary parts of the DC and Nyquist bins are ignored.  The
+    output may not overlap the spectrum arrays.
+  */
+  void inverse( const StkFloat *real, const StkFloat *imag, StkFloat *output );
+
+ protected:
+
+  // Complex transform of size_ / 2 points in place.
+  void transform( StkFloat *real, StkFloat *imag, bool inverse );
+
+  unsigned int size_;
+  std::vector<unsigned int> bitReverse_;
+  std::vector<StkFloat> cosine_;     // cos( 2 pi k / size_ ), k <= size_ / 2
+  std::vector<StkFloat> sine_;       // sin( 2 pi k / size_ ), k <= size_ / 2
+  std::vector<StkFloat> workReal_;
+  std::vector<StkFloat> workImag_;
+};
+
+} // stk namespace
+
+#endif
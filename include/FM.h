@@ -24,6 +24,9 @@ namespace stk {
        - LFO Depth = 1
        - ADSR 2 & 4 Target = 128
 
+    Operator waves use the shared SineWave table by default, and
+    can be read from rawwave files with loadWaves().
+
     The basic Chowning/Stanford FM patent expired
     in 1995, but there exist follow-on patents,
     mostly assigned to Yamaha.  If you are of the
@@ -47,6 +50,11 @@ class FM : public Instrmnt
   virtual ~FM( void );
 
   //! Load the rawwave filenames in waves.
+  /*!
+    An StkError will be thrown if a file is not found, its format
+    is unknown, or a read error occurs.  Without files, the waves
+    are sinusoids computed from the shared SineWave table.
+  */
   void loadWaves( const char **filenames );
 
   //! Set instrument parameters for a particular frequency.
@@ -97,8 +105,24 @@ class FM : public Instrmnt
 
  protected:
 
+  // An operator wave, computed from the shared sine table unless a
+  // rawwave file is opened.
+  class Wave {
+  public:
+    Wave( void ) : loop_( 0 ) {};
+    ~Wave( void ) { delete loop_; };
+    void openFile( std::string fileName );
+    void setFrequency( StkFloat frequency ) { if ( loop_ ) loop_->setFrequency( frequency ); else sine_.setFrequency( frequency ); };
+    void addPhaseOffset( StkFloat phaseOffset ) { if ( loop_ ) loop_->addPhaseOffset( phaseOffset ); else sine_.addPhaseOffset( phaseOffset ); };
+    StkFloat tick( void ) { return ( loop_ ) ? loop_->tick() : sine_.tick(); };
+
+  private:
+    SineWave sine_;
+    FileLoop *loop_;
+  };
+
   std::vector<ADSR *> adsr_; 
-  std::vector<FileLoop *> waves_;
+  std::vector<Wave *> waves_;
   SineWave vibrato_;
   TwoZero  twozero_;
   unsigned int nOperators_;
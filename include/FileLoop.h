@@ -85,6 +85,12 @@ class FileLoop : protected FileWvIn
   */
   StkFloat getFileRate( void ) const { return data_.dataRate(); };
 
+  //! Query whether the file data is shared with other instances through the WaveCache.
+  bool isShared( void ) const { return FileWvIn::isShared(); };
+
+  //! Return the number of chunks that were not read ahead in time when incrementally loading from disk.
+  unsigned long getUnderrunCount( void ) const { return FileWvIn::getUnderrunCount(); };
+
   //! Set the data read rate in samples.  The rate can be negative.
   /*!
     If the rate value is negative, the data is read in reverse order.
@@ -100,6 +106,18 @@ class FileLoop : protected FileWvIn
   */
   void setFrequency( StkFloat frequency ) { this->setRate( fileSize_ * frequency / Stk::sampleRate() ); };
 
+  //! Set the interpolation quality (default = Resampler::LINEAR).
+  /*!
+    With the windowed-sinc qualities, the data is also low-pass
+    filtered to avoid aliasing when the read rate magnitude is greater
+    than one.  Data incrementally loaded from disk always uses linear
+    interpolation.
+  */
+  void setInterpolationQuality( Resampler::Quality quality ) { FileWvIn::setInterpolationQuality( quality ); };
+
+  //! Return the interpolation quality.
+  Resampler::Quality getInterpolationQuality( void ) const { return FileWvIn::getInterpolationQuality(); };
+
   //! Increment the read pointer by \e time samples, modulo file size.
   void addTime( StkFloat time );
 
@@ -155,6 +173,10 @@ class FileLoop : protected FileWvIn
 
  protected:
 
+  long findChunk( StkFloat time, long pointer );
+  long nextChunk( long pointer, bool forward );
+  void readChunk( StkFrames& frames, long pointer );
+
   StkFrames firstFrame_;
   StkFloat phaseOffset_;
 
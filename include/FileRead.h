@@ -82,6 +82,22 @@ public:
   //! Return the data format of the file.
   StkFormat format( void ) const { return dataType_; };
 
+  //! Enable or disable memory-mapped reading of subsequently opened files.
+  /*!
+    When enabled (and supported by the operating system), the file
+    is mapped into memory when it is opened and read() converts
+    samples directly from the mapped region, without any intermediate
+    copy or seek.  The kernel is advised that the file will be read
+    sequentially and the region following each read is prefetched.
+    If the file cannot be mapped, stdio reading is used instead.  The
+    default is disabled.  The setting takes effect the next time a
+    file is opened.
+  */
+  void setMemoryMapping( bool enable = true ) { useMap_ = enable; };
+
+  //! Returns \e true if the currently open file is memory mapped.
+  bool isMemoryMapped( void ) const { return map_ != 0; };
+
   //! Return the file sample rate in Hz.
   /*!
     WAV, SND, and AIF formatted files specify a sample rate in
@@ -126,6 +142,12 @@ protected:
   // Helper function for MAT-file parsing.
   bool findNextMatArray( SINT32 *chunkSize, SINT32 *rows, SINT32 *columns, SINT32 *nametype );
 
+  // Map the open file into memory, if possible.
+  void mapFile( void );
+
+  // Convert raw file data to StkFloat samples.
+  void convert( const unsigned char *data, StkFloat *samples, unsigned long nSamples, bool doNormalize );
+
   FILE *fd_;
   bool byteswap_;
   bool wavFile_;
@@ -134,6 +156,10 @@ protected:
   unsigned int channels_;
   StkFormat dataType_;
   StkFloat fileRate_;
+  bool useMap_;
+  void *map_;
+  unsigned long mapSize_;
+  std::vector<unsigned char> readBuffer_;
 };
 
 } // stk namespace
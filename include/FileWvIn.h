@@ -3,6 +3,9 @@
 
 #include "WvIn.h"
 #include "FileRead.h"
+#include "WaveCache.h"
+#include "DiskStream.h"
+#include "Resampler.h"
 
 namespace stk {
 
@@ -14,7 +17,10 @@ namespace stk {
     interface to the FileRead class.  It also provides variable-rate
     playback functionality.  Audio file support is provided by the
     FileRead class.  Linear interpolation is used for fractional read
-    rates.
+    rates by default.  Band-limited interpolation with the Resampler
+    class, which avoids the aliasing of linear interpolation when data
+    is transposed, can be selected with setInterpolationQuality() for
+    data read completely into local memory.
 
     FileWvIn supports multi-channel data.  It is important to
     distinguish the tick() method that computes a single frame (and
@@ -27,11 +33,18 @@ namespace stk {
     This behavior is controlled by the optional constructor arguments
     \e chunkThreshold and \e chunkSize.  File sizes greater than \e
     chunkThreshold (in sample frames) will be read incrementally in
-    chunks of \e chunkSize each (also in sample frames).
+    chunks of \e chunkSize each (also in sample frames).  The chunks
+    that follow the one being played are read ahead by background I/O
+    threads (see the DiskStream class), so that the tick() functions
+    do not normally access the disk.
 
     For file data read completely into local memory, the \e doNormalize
     flag can be used to normalize all values with respect to the maximum
-    absolute value of the data.
+    absolute value of the data.  Such data is shared through the
+    WaveCache class by all instances that load the same file with the
+    same arguments, so that opening a file which is already in use
+    does not read it again.  The shared data is only copied if it is
+    subsequently normalized by one of the instances.
 
     If the file data format is fixed point, the flag \e doInt2FloatScaling
     can be used to control whether the values are scaled with respect to
@@ -111,6 +124,19 @@ public:
   */
   virtual StkFloat getFileRate( void ) const { return data_.dataRate(); };
 
+  //! Query whether the file data is shared with other instances through the WaveCache.
+  bool isShared( void ) const { return (bool) sharedData_; };
+
+  //! Enable or disable memory-mapped reading for subsequently opened files.
+  /*!
+    This only affects files that are incrementally loaded from disk
+    (see FileRead::setMemoryMapping()).
+  */
+  void setMemoryMapping( bool enable = true ) { file_.setMemoryMapping( enable ); };
+
+  //! Return the number of chunks that were not read ahead in time when incrementally loading from disk.
+  unsigned long getUnderrunCount( void ) const { return stream_ ? stream_->getUnderrunCount() : 0; };
+
   //! Query whether a file is open.
   bool isOpen( void ) { return file_.isOpen(); };
 
@@ -138,6 +164,19 @@ public:
   */
   void setInterpolate( bool doInterpolate ) { interpolate_ = doInterpolate; };
 
+  //! Set the interpolation quality (default = Resampler::LINEAR).
+  /*!
+    With the windowed-sinc qualities, the data is also low-pass
+    filtered to avoid aliasing when the read rate magnitude is greater
+    than one, in which case interpolation is used for integer rates
+    too.  Data incrementally loaded from disk always uses linear
+    interpolation.
+  */
+  void setInterpolationQuality( Resampler::Quality quality );
+
+  //! Return the interpolation quality.
+  Resampler::Quality getInterpolationQuality( void ) const { return resampler_.getQuality(); };
+
   //! Return the specified channel value of the last computed frame.
   /*!
     If no file is loaded, the returned value is 0.0.  The \c
@@ -174,8 +213,40 @@ public:
 
 protected:
 
+  friend class DiskStream;
+
   void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
 
+  // Return the start of the chunk containing time, stepping from the
+  // chunk starting at pointer.
+  virtual long findChunk( StkFloat time, long pointer );
+
+  // Return the start of the chunk that follows the one starting at
+  // pointer in the given direction, or -1 if there is none.
+  virtual long nextChunk( long pointer, bool forward );
+
+  // Read the chunk starting at pointer into frames.  This is called
+  // from the I/O threads when prefetching.
+  virtual void readChunk( StkFrames& frames, long pointer );
+
+  // Return the WaveCache variant value for the given openFile() arguments.
+  static unsigned int cacheVariant( bool raw, bool doNormalize, bool doInt2FloatScaling, bool loop );
+
+  // Use data from the WaveCache if available, returning true on
+  // success.  The cached data holds extraFrames frames beyond the
+  // file size.
+  bool openShared( const std::string& fileName, unsigned int variant, unsigned long extraFrames );
+
+  // Move the completely loaded data_ into the WaveCache.
+  void shareData( const std::string& fileName, unsigned int variant );
+
+  // Set the interpolation flag and the resampler rate for the
+  // current read rate.
+  void setInterpolation( void );
+
+  // Return the data being read (shared or local).
+  const StkFrames& readData( void ) { return sharedData_ ? *sharedData_ : ( stream_ ? stream_->data() : data_ ); };
+
   FileRead file_;
   bool finished_;
   bool interpolate_;
@@ -187,6 +258,9 @@ protected:
   unsigned long chunkThreshold_;
   unsigned long chunkSize_;
   long chunkPointer_;
+  std::shared_ptr<const StkFrames> sharedData_;
+  DiskStream *stream_;
+  Resampler resampler_;
 
 };
 
@@ -15,6 +15,17 @@ namespace stk {
     filter subclasses.  It is general enough to support both
     monophonic and polyphonic input/output classes.
 
+    By default, a filter processes a single channel.  After a call to
+    setChannels(), the StkFrames tick() functions of the OnePole,
+    OneZero, TwoPole, TwoZero, PoleZero, BiQuad and Fir subclasses
+    filter several adjacent interleaved channels at once, each with
+    its own state, in loops over the channels which the compiler can
+    vectorize for the target instruction set (SSE/AVX/NEON).  The Fir
+    class instead vectorizes each channel over blocks of frames.
+    With a single channel, these tick() functions keep the filter
+    state in local variables rather than in the inputs_ and outputs_
+    members, which the compiler must assume might alias the samples.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
 /***************************************************/
@@ -68,6 +79,9 @@ public:
 
 protected:
 
+  // Set the number of channels of the filter states and clear them.
+  void setStateChannels( unsigned int nChannels );
+
   StkFloat gain_;
   unsigned int channelsIn_;
   StkFrames lastFrame_;
@@ -90,6 +104,20 @@ inline void Filter :: clear( void )
     lastFrame_[i] = 0.0;  
 }
 
+inline void Filter :: setStateChannels( unsigned int nChannels )
+{
+  if ( nChannels == 0 ) {
+    oStream_ << "Filter::setChannels: number of channels must be greater than zero!";
+    handleError( StkError::FUNCTION_ARGUMENT ); return;
+  }
+
+  channelsIn_ = nChannels;
+  inputs_.resize( inputs_.frames(), nChannels );
+  outputs_.resize( outputs_.frames(), nChannels );
+  lastFrame_.resize( 1, nChannels );
+  this->clear();
+}
+
 inline StkFloat Filter :: phaseDelay( StkFloat frequency )
 {
   if ( frequency <= 0.0 || frequency > 0.5 * Stk::sampleRate() ) {
@@ -2,6 +2,7 @@
 #define STK_FIR_H
 
 #include "Filter.h"
+#include "Convolver.h"
 
 namespace stk {
 
@@ -23,6 +24,12 @@ namespace stk {
     This structure results in one extra multiply per computed sample,
     but allows easy control of the overall filter gain.
 
+    The direct form computation has a cost proportional to the number
+    of coefficients for each sample.  For long impulse responses, the
+    setPartitioning() function selects a partitioned FFT convolution
+    (see the Convolver class) without added latency, in which case the
+    gain is applied at the filter output.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
 /***************************************************/
@@ -51,6 +58,29 @@ public:
   */
   void setCoefficients( std::vector<StkFloat> &coefficients, bool clearState = false );
 
+  //! Set the number of adjacent interleaved channels filtered by the StkFrames tick() functions (default = 1).
+  /*!
+    Each channel has its own filter state, using the same
+    coefficients and gain, and lastFrame() holds the last output of
+    each.  The single-sample tick() function should only be used with
+    a single channel.  The filter states are cleared.
+  */
+  void setChannels( unsigned int nChannels );
+
+  //! Select the partitioned FFT convolution with the given head size (a power of two, at least 16), or the direct form if \e blockSize is 0 (the default).
+  /*!
+    The partitioned convolution is much faster than the direct form
+    for more than a few hundred coefficients.  With non-uniform
+    partitioning (the default), the partition sizes grow with the
+    position in the impulse response, which is best for very long
+    impulse responses.  See the Convolver class for details.  The
+    filter states are cleared.
+  */
+  void setPartitioning( unsigned int blockSize, bool uniform = false );
+
+  //! Clears the internal states of the filter.
+  void clear( void );
+
   //! Return the last computed output value.
   StkFloat lastOut( void ) const { return lastFrame_[0]; };
 
@@ -65,6 +95,10 @@ public:
     However, range checking is only performed if _STK_DEBUG_ is
     defined during compilation, in which case an out-of-range value
     will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
@@ -76,77 +110,82 @@ public:
     by 0).  However, range checking is only performed if _STK_DEBUG_
     is defined during compilation, in which case an out-of-range value
     will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
   */
   StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
 
 protected:
 
+  // The number of frames computed at once by tickFrames().
+  static const unsigned int BLOCK_SIZE = 64;
+
+  // Filter nFrames frames of the (interleaved) input and output,
+  // which may be the same.
+  void tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames );
+
+  // Set up one convolver per channel for the partitioned convolution.
+  void setConvolvers( void );
+
+  // The previous and current block inputs of a channel.
+  std::vector<StkFloat> buffer_;
+
+  // The inputs are stored twice in a circular buffer (inputs_), so
+  // that the most recent ones, starting at this position, are always
+  // contiguous.
+  unsigned int position_;
+
+  std::vector<Convolver> convolvers_;
+  unsigned int partitionSize_;
+  bool uniform_;
 };
 
 inline StkFloat Fir :: tick( StkFloat input )
 {
-  lastFrame_[0] = 0.0;
-  inputs_[0] = gain_ * input;
+  if ( !convolvers_.empty() )
+    return lastFrame_[0] = gain_ * convolvers_[0].tick( input );
 
-  for ( unsigned int i=(unsigned int)(b_.size())-1; i>0; i-- ) {
-    lastFrame_[0] += b_[i] * inputs_[i];
-    inputs_[i] = inputs_[i-1];
-  }
-  lastFrame_[0] += b_[0] * inputs_[0];
+  unsigned int i, length = (unsigned int) b_.size();
+  position_ = ( position_ == 0 ? length : position_ ) - 1;
+  StkFloat *x = &inputs_[position_];
+  x[0] = x[length] = gain_ * input;
 
-  return lastFrame_[0];
+  StkFloat y = 0.0;
+  for ( i=length-1; i>0; i-- )
+    y += b_[i] * x[i];
+  y += b_[0] * x[0];
+
+  lastFrame_[0] = y;
+  return y;
 }
 
 inline StkFrames& Fir :: tick( StkFrames& frames, unsigned int channel )
 {
 #if defined(_STK_DEBUG_)
-  if ( channel >= frames.channels() ) {
+  if ( channel + channelsIn_ > frames.channels() ) {
     oStream_ << "Fir::tick(): channel and StkFrames arguments are incompatible!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 #endif
 
   StkFloat *samples = &frames[channel];
-  unsigned int i, hop = frames.channels();
-  for ( unsigned int j=0; j<frames.frames(); j++, samples += hop ) {
-    inputs_[0] = gain_ * *samples;
-    *samples = 0.0;
-
-    for ( i=(unsigned int)b_.size()-1; i>0; i-- ) {
-      *samples += b_[i] * inputs_[i];
-      inputs_[i] = inputs_[i-1];
-    }
-    *samples += b_[0] * inputs_[0];
-  }
-
-  lastFrame_[0] = *(samples-hop);
+  unsigned int hop = frames.channels();
+  this->tickFrames( samples, hop, samples, hop, frames.frames() );
   return frames;
 }
 
 inline StkFrames& Fir :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
 {
 #if defined(_STK_DEBUG_)
-  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() ) {
+  if ( iChannel + channelsIn_ > iFrames.channels() || oChannel + channelsIn_ > oFrames.channels() ) {
     oStream_ << "Fir::tick(): channel and StkFrames arguments are incompatible!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 #endif
 
-  StkFloat *iSamples = &iFrames[iChannel];
-  StkFloat *oSamples = &oFrames[oChannel];
-  unsigned int i, iHop = iFrames.channels(), oHop = oFrames.channels();
-  for ( unsigned int j=0; j<iFrames.frames(); j++, iSamples += iHop, oSamples += oHop ) {
-    inputs_[0] = gain_ * *iSamples;
-    *oSamples = 0.0;
-
-    for ( i=(unsigned int)b_.size()-1; i>0; i-- ) {
-      *oSamples += b_[i] * inputs_[i];
-      inputs_[i] = inputs_[i-1];
-    }
-    *oSamples += b_[0] * inputs_[0];
-  }
-
-  lastFrame_[0] = *(oSamples-oHop);
+  this->tickFrames( &iFrames[iChannel], iFrames.channels(), &oFrames[oChannel], oFrames.channels(), iFrames.frames() );
   return iFrames;
 }
 
@@ -3,7 +3,7 @@
 
 #include "Effect.h"
 #include "Delay.h"
-#include "OnePole.h"
+#include "FDN.h"
 
 namespace stk {
 
@@ -19,6 +19,10 @@ namespace stk {
     stereo, and the output signal is stereo.  The delay lengths are
     optimized for a sample rate of 44100 Hz.
 
+    The comb filters of both channels are computed together by the
+    FDN class, which processes blocks of samples in the tick(
+    StkFrames& ) functions.
+
     Ported to STK by Gregory Burlet, 2012.
 */
 /***********************************************************************/
@@ -120,13 +124,22 @@ class FreeVerb : public Effect
   //! Update interdependent parameters.
   void update( void );
 
+  // Compute the allpass filters and the output mix of one frame
+  // from the outputs of the comb filters.
+  void tickAllpasses( StkFloat outL, StkFloat outR, StkFloat inputL, StkFloat inputR );
+
   // Clamp very small floats to zero, version from
   // http://music.columbia.edu/pipermail/linux-audio-user/2004-July/013489.html .
-  // However, this is for 32-bit floats only.
-  //static inline StkFloat undenormalize( volatile StkFloat s ) { 
-  //  s += 9.8607615E-32f; 
-  //  return s - 9.8607615E-32f; 
-  //}
+  // This is for 32-bit floats only, which decay into the denormal
+  // range within seconds of silence in the comb and allpass loops.
+#if defined(__STK_FLOAT32__)
+  static inline StkFloat undenormalize( volatile StkFloat s ) { 
+    s += 9.8607615E-32f; 
+    return s - 9.8607615E-32f; 
+  }
+#else
+  static inline StkFloat undenormalize( StkFloat s ) { return s; }
+#endif
     
   static const int nCombs = 8;
   static const int nAllpasses = 4;
@@ -151,11 +164,10 @@ class FreeVerb : public Effect
   StkFloat width_;
   bool frozenMode_;
 
-  // LBFC: Lowpass Feedback Comb Filters
-  Delay combDelayL_[nCombs];
-  Delay combDelayR_[nCombs];
-  OnePole combLPL_[nCombs];
-  OnePole combLPR_[nCombs];
+  // LBFC: Lowpass Feedback Comb Filters, left channel lines first.
+  FDN combs_;
+  StkFrames combInputs_;
+  StkFrames combOutputs_;
         
   // AP: Allpass Filters
   Delay allPassDelayL_[nAllpasses];
@@ -174,39 +186,12 @@ inline StkFloat FreeVerb :: lastOut( unsigned int channel )
   return lastFrame_[channel];
 }
 
-inline StkFloat FreeVerb::tick( StkFloat inputL, StkFloat inputR, unsigned int channel )
+inline void FreeVerb::tickAllpasses( StkFloat outL, StkFloat outR, StkFloat inputL, StkFloat inputR )
 {
-#if defined(_STK_DEBUG_)
-  if ( channel > 1 ) {
-    oStream_ << "FreeVerb::tick(): channel argument must be less than 2!";
-    handleError(StkError::FUNCTION_ARGUMENT);
-  }
-#endif
-
-  StkFloat fInput = (inputL + inputR) * gain_;
-  StkFloat outL = 0.0;
-  StkFloat outR = 0.0;
-
-  // Parallel LBCF filters
-  for ( int i = 0; i < nCombs; i++ ) {
-    // Left channel
-    //StkFloat yn = fInput + (roomSize_ * FreeVerb::undenormalize(combLPL_[i].tick(FreeVerb::undenormalize(combDelayL_[i].nextOut()))));
-    StkFloat yn = fInput + (roomSize_ * combLPL_[i].tick( combDelayL_[i].nextOut() ) );
-    combDelayL_[i].tick(yn);
-    outL += yn;
-
-    // Right channel
-    //yn = fInput + (roomSize_ * FreeVerb::undenormalize(combLPR_[i].tick(FreeVerb::undenormalize(combDelayR_[i].nextOut()))));
-    yn = fInput + (roomSize_ * combLPR_[i].tick( combDelayR_[i].nextOut() ) );
-    combDelayR_[i].tick(yn);
-    outR += yn;
-  }
-
   // Series allpass filters
   for ( int i = 0; i < nAllpasses; i++ ) {
     // Left channel
-    //StkFloat vn_m = FreeVerb::undenormalize(allPassDelayL_[i].nextOut());
-    StkFloat vn_m = allPassDelayL_[i].nextOut();
+    StkFloat vn_m = FreeVerb::undenormalize(allPassDelayL_[i].nextOut());
     StkFloat vn = outL + (g_ * vn_m);
     allPassDelayL_[i].tick(vn);
         
@@ -214,8 +199,7 @@ inline StkFloat FreeVerb::tick( StkFloat inputL, StkFloat inputR, unsigned int c
     outL = -vn + (1.0 + g_)*vn_m;
 
     // Right channel
-    //vn_m = FreeVerb::undenormalize(allPassDelayR_[i].nextOut());
-    vn_m = allPassDelayR_[i].nextOut();
+    vn_m = FreeVerb::undenormalize(allPassDelayR_[i].nextOut());
     vn = outR + (g_ * vn_m);
     allPassDelayR_[i].tick(vn);
 
@@ -226,6 +210,19 @@ inline StkFloat FreeVerb::tick( StkFloat inputL, StkFloat inputR, unsigned int c
   // Mix output
   lastFrame_[0] = outL*wet1_ + outR*wet2_ + inputL*dry_;
   lastFrame_[1] = outR*wet1_ + outL*wet2_ + inputR*dry_;
+}
+
+inline StkFloat FreeVerb::tick( StkFloat inputL, StkFloat inputR, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel > 1 ) {
+    oStream_ << "FreeVerb::tick(): channel argument must be less than 2!";
+    handleError(StkError::FUNCTION_ARGUMENT);
+  }
+#endif
+
+  combs_.tick( (inputL + inputR) * gain_ );
+  tickAllpasses( combs_.lastOut( 0 ), combs_.lastOut( 1 ), inputL, inputR );
 
   /*
   // Hard limiter ... there's not much else we can do at this point
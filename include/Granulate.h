@@ -98,6 +98,14 @@ class Granulate: public Generator
    */
   void setRandomFactor( StkFloat randomness = 0.1 );
 
+  //! Seed the random number generator used for grain parameters.
+  /*!
+    A non-zero seed gives the same grain sequence on every run.  If
+    the seed value is zero, the generator is seeded with the current
+    system time.
+  */
+  void setSeed( unsigned int seed = 0 ) { noise.setSeed( seed ); };
+
   //! Return the specified channel value of the last computed frame.
   /*!
     The \c channel argument must be less than the number of output
@@ -27,6 +27,11 @@ namespace stk {
     This structure results in one extra multiply per computed sample,
     but allows easy control of the overall filter gain.
 
+    High-order filters in this direct form are sensitive to coefficient
+    rounding.  They can instead be implemented as a cascade of
+    second-order sections with the setSections() function, which is
+    numerically more robust and faster.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
 /***************************************************/
@@ -79,6 +84,24 @@ public:
   */
   void setDenominator( std::vector<StkFloat> &aCoefficients, bool clearState = false );
 
+  //! Set the filter as a cascade of second-order sections.
+  /*!
+    Each section is given by six coefficients, b[0], b[1], b[2],
+    a[0], a[1] and a[2], in that order, and is computed in transposed
+    direct form II.  An StkError can be thrown if the vector size is
+    zero or not a multiple of six, or if an a[0] coefficient is equal
+    to zero.  The numerator and denominator of the filter are set to
+    the products of those of the sections, so that phaseDelay()
+    remains valid.  The setCoefficients(), setNumerator() and
+    setDenominator() functions return to the direct form.  The
+    internal state of the filter is not cleared unless the \e
+    clearState flag is \c true or the number of sections changes.
+  */
+  void setSections( std::vector<StkFloat> &sections, bool clearState = false );
+
+  //! Clears the internal states of the filter.
+  void clear( void );
+
   //! Return the last computed output value.
   StkFloat lastOut( void ) const { return lastFrame_[0]; };
 
@@ -109,27 +132,64 @@ public:
 
 protected:
 
+  // Compute one output of the second-order sections.
+  StkFloat tickSections( StkFloat input );
+
+  // Filter nFrames input values, taken every iHop values, and write
+  // the outputs every oHop values (the arrays may be the same).
+  void tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames );
+
+  // The inputs and outputs are stored twice in circular buffers
+  // (inputs_ and outputs_), so that the most recent values, starting
+  // at these positions, are always contiguous.
+  unsigned int inPosition_;
+  unsigned int outPosition_;
+
+  // Normalized coefficients b[0], b[1], b[2], a[1], a[2] and the two
+  // states of each second-order section.
+  std::vector<StkFloat> sections_;
+  std::vector<StkFloat> sectionStates_;
 };
 
-inline StkFloat Iir :: tick( StkFloat input )
+inline StkFloat Iir :: tickSections( StkFloat input )
 {
-  size_t i;
-
-  outputs_[0] = 0.0;
-  inputs_[0] = gain_ * input;
-  for ( i=b_.size()-1; i>0; i-- ) {
-    outputs_[0] += b_[i] * inputs_[i];
-    inputs_[i] = inputs_[i-1];
+  const StkFloat *c = &sections_[0];
+  StkFloat *state = &sectionStates_[0];
+  for ( size_t i=0; i<sectionStates_.size(); i+=2, c+=5 ) {
+    StkFloat output = c[0] * input + state[i];
+    state[i] = c[1] * input - c[3] * output + state[i+1];
+    state[i+1] = c[2] * input - c[4] * output;
+    input = output;
   }
-  outputs_[0] += b_[0] * inputs_[0];
 
-  for ( i=a_.size()-1; i>0; i-- ) {
-    outputs_[0] += -a_[i] * outputs_[i];
-    outputs_[i] = outputs_[i-1];
+  return input;
+}
+
+inline StkFloat Iir :: tick( StkFloat input )
+{
+  if ( !sections_.empty() ) {
+    lastFrame_[0] = this->tickSections( gain_ * input );
+    return lastFrame_[0];
   }
 
-  lastFrame_[0] = outputs_[0];
-  return lastFrame_[0];
+  size_t i, nb = b_.size(), na = a_.size();
+  inPosition_ = (unsigned int) ( inPosition_ == 0 ? nb : inPosition_ ) - 1;
+  StkFloat *x = &inputs_[inPosition_];
+  x[0] = x[nb] = gain_ * input;
+
+  StkFloat y = 0.0;
+  for ( i=nb-1; i>0; i-- )
+    y += b_[i] * x[i];
+  y += b_[0] * x[0];
+
+  outPosition_ = (unsigned int) ( outPosition_ == 0 ? na : outPosition_ ) - 1;
+  StkFloat *yp = &outputs_[outPosition_];
+  for ( i=na-1; i>0; i-- )
+    y += -a_[i] * yp[i];
+  yp[0] = yp[na] = y;
+
+  lastFrame_[0] = y;
+  return y;
 }
 
 inline StkFrames& Iir :: tick( StkFrames& frames, unsigned int channel )
@@ -142,26 +202,8 @@ inline StkFrames& Iir :: tick( StkFrames& frames, unsigned int channel )
 #endif
 
   StkFloat *samples = &frames[channel];
-  size_t i;
   unsigned int hop = frames.channels();
-  for ( unsigned int j=0; j<frames.frames(); j++, samples += hop ) {
-    outputs_[0] = 0.0;
-    inputs_[0] = gain_ * *samples;
-    for ( i=b_.size()-1; i>0; i-- ) {
-      outputs_[0] += b_[i] * inputs_[i];
-      inputs_[i] = inputs_[i-1];
-    }
-    outputs_[0] += b_[0] * inputs_[0];
-
-    for ( i=a_.size()-1; i>0; i-- ) {
-      outputs_[0] += -a_[i] * outputs_[i];
-      outputs_[i] = outputs_[i-1];
-    }
-
-    *samples = outputs_[0];
-  }
-
-  lastFrame_[0] = *(samples-hop);
+  this->tickFrames( samples, hop, samples, hop, frames.frames() );
   return frames;
 }
 
@@ -174,28 +216,7 @@ inline StkFrames& Iir :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned
   }
 #endif
 
-  StkFloat *iSamples = &iFrames[iChannel];
-  StkFloat *oSamples = &oFrames[oChannel];
-  size_t i;
-  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
-  for ( unsigned int j=0; j<iFrames.frames(); j++, iSamples += iHop, oSamples += oHop ) {
-    outputs_[0] = 0.0;
-    inputs_[0] = gain_ * *iSamples;
-    for ( i=b_.size()-1; i>0; i-- ) {
-      outputs_[0] += b_[i] * inputs_[i];
-      inputs_[i] = inputs_[i-1];
-    }
-    outputs_[0] += b_[0] * inputs_[0];
-
-    for ( i=a_.size()-1; i>0; i-- ) {
-      outputs_[0] += -a_[i] * outputs_[i];
-      outputs_[i] = outputs_[i-1];
-    }
-
-    *oSamples = outputs_[0];
-  }
-
-  lastFrame_[0] = *(oSamples-oHop);
+  this->tickFrames( &iFrames[iChannel], iFrames.channels(), &oFrames[oChannel], oFrames.channels(), iFrames.frames() );
   return iFrames;
 }
 
@@ -3,7 +3,7 @@
 
 #include "Effect.h"
 #include "Delay.h"
-#include "OnePole.h"
+#include "FDN.h"
 
 namespace stk {
 
@@ -22,7 +22,10 @@ namespace stk {
 
     Although not in the original JC reverberator,
     one-pole lowpass filters have been added inside
-    the feedback comb filters.
+    the feedback comb filters.  The comb filters are
+    computed together by the FDN class, which
+    processes blocks of samples in the tick(
+    StkFrames& ) functions.
 
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
@@ -87,13 +90,19 @@ class JCRev : public Effect
 
  protected:
 
+  // Compute the series allpass filters.
+  StkFloat tickAllpasses( StkFloat input );
+
+  // Compute the output frame from the sum of the comb filters.
+  void tickOutputs( StkFloat filtout, StkFloat input );
+
   Delay allpassDelays_[3];
-  Delay combDelays_[4];
-  OnePole combFilters_[4];
+  FDN combs_;
+  StkFrames combInputs_;
+  StkFrames combOutputs_;
   Delay outLeftDelay_;
   Delay outRightDelay_;
   StkFloat allpassCoefficient_;
-  StkFloat combCoefficient_[4];
 
 };
 
@@ -109,54 +118,46 @@ inline StkFloat JCRev :: lastOut( unsigned int channel )
   return lastFrame_[channel];
 }
 
-inline StkFloat JCRev :: tick( StkFloat input, unsigned int channel )
+inline StkFloat JCRev :: tickAllpasses( StkFloat input )
 {
-#if defined(_STK_DEBUG_)
-  if ( channel > 1 ) {
-    oStream_ << "JCRev::tick(): channel argument must be less than 2!";
-    handleError( StkError::FUNCTION_ARGUMENT );
-  }
-#endif
-
-  StkFloat temp, temp0, temp1, temp2, temp3, temp4, temp5, temp6;
-  StkFloat filtout;
+  StkFloat temp, temp0, temp1, temp2;
 
   temp = allpassDelays_[0].lastOut();
   temp0 = allpassCoefficient_ * temp;
   temp0 += input;
   allpassDelays_[0].tick(temp0);
   temp0 = -(allpassCoefficient_ * temp0) + temp;
-    
   temp = allpassDelays_[1].lastOut();
   temp1 = allpassCoefficient_ * temp;
   temp1 += temp0;
   allpassDelays_[1].tick(temp1);
   temp1 = -(allpassCoefficient_ * temp1) + temp;
-    
   temp = allpassDelays_[2].lastOut();
   temp2 = allpassCoefficient_ * temp;
   temp2 += temp1;
   allpassDelays_[2].tick(temp2);
-  temp2 = -(allpassCoefficient_ * temp2) + temp;
-    
-  temp3 = temp2 + ( combFilters_[0].tick( combCoefficient_[0] * combDelays_[0].lastOut() ) );
-  temp4 = temp2 + ( combFilters_[1].tick( combCoefficient_[1] * combDelays_[1].lastOut() ) );
-  temp5 = temp2 + ( combFilters_[2].tick( combCoefficient_[2] * combDelays_[2].lastOut() ) );
-  temp6 = temp2 + ( combFilters_[3].tick( combCoefficient_[3] * combDelays_[3].lastOut() ) );
-
-  combDelays_[0].tick(temp3);
-  combDelays_[1].tick(temp4);
-  combDelays_[2].tick(temp5);
-  combDelays_[3].tick(temp6);
-
-  filtout = temp3 + temp4 + temp5 + temp6;
+  return -(allpassCoefficient_ * temp2) + temp;
+}
 
+inline void JCRev :: tickOutputs( StkFloat filtout, StkFloat input )
+{
   lastFrame_[0] = effectMix_ * (outLeftDelay_.tick(filtout));
   lastFrame_[1] = effectMix_ * (outRightDelay_.tick(filtout));
-  temp = (1.0 - effectMix_) * input;
+  StkFloat temp = (1.0 - effectMix_) * input;
   lastFrame_[0] += temp;
   lastFrame_[1] += temp;
-    
+}
+
+inline StkFloat JCRev :: tick( StkFloat input, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel > 1 ) {
+    oStream_ << "JCRev::tick(): channel argument must be less than 2!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  tickOutputs( combs_.tick( tickAllpasses( input ) ), input );
   return 0.7 * lastFrame_[channel];
 }
 
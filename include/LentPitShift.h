@@ -3,6 +3,7 @@
 
 #include "Effect.h"
 #include "Delay.h"
+#include "PitchTracker.h"
 
 namespace stk {
 
@@ -11,7 +12,8 @@ namespace stk {
     \brief Pitch shifter effect class based on the Lent algorithm.
 
     This class implements a pitch shifter using pitch 
-    tracking and sample windowing and shifting.
+    tracking and sample windowing and shifting.  The
+    pitch is tracked by the PitchTracker class.
 
     by Francois Germain, 2009.
 */
@@ -24,10 +26,7 @@ class LentPitShift : public Effect
   LentPitShift( StkFloat periodRatio = 1.0, int tMax = RT_BUFFER_SIZE );
 
   ~LentPitShift( void ) {
-    delete window;
-    delete dt;
-    delete dpt;
-    delete cumDt;
+    delete [] window;
   }
 
   //! Reset and clear all internal state.
@@ -88,11 +87,8 @@ class LentPitShift : public Effect
   // It is also the size of the window used by the pitch tracker and
   // the size of the frames that can be computed by the tick function
 
-  StkFloat threshold_; // Threshold of detection for the pitch tracker
+  PitchTracker tracker_;  // Pitch tracker with frames of tMax_ samples
   unsigned long lastPeriod_;    // Result of the last pitch tracking loop
-  StkFloat* dt;        // Array containing the euclidian distance coefficients
-  StkFloat* cumDt;     // Array containing the cumulative sum of the coefficients in dt
-  StkFloat* dpt;       // Array containing the pitch tracking function coefficients
 
   // Pitch shifter variables
   StkFloat env[2];     // Coefficients for the linear interpolation when modifying the output samples
@@ -108,64 +104,14 @@ class LentPitShift : public Effect
 
 inline void LentPitShift::process()
 {
-  StkFloat x_t;    // input coefficient
-  StkFloat x_t_T;  // previous input coefficient at T samples
-  StkFloat coeff;  // new coefficient for the difference function
-
-  unsigned long alternativePitch = tMax_;  // Global minimum storage
-  lastPeriod_ = tMax_+1;         // Storage of the lowest local minimum under the threshold
-
-  // Loop variables
-  unsigned long delay_;
-  unsigned int n;
-
-  // Initialization of the dt coefficients.  Since the
-  // frames are of tMax_ length, there is no overlapping
-  // between the successive windows where pitch tracking
-  // is performed.
-  for ( delay_=1; delay_<=tMax_; delay_++ )
-    dt[delay_] = 0.;
-
-  // Calculation of the dt coefficients and update of the input delay line.
-  for ( n=0; n<inputFrames.size(); n++ ) {
-    x_t = inputLine_.tick( inputFrames[ n ] );
-    for ( delay_=1; delay_<= tMax_; delay_++ ) {
-      x_t_T = inputLine_.tapOut( delay_ );
-      coeff = x_t - x_t_T;
-      dt[delay_] += coeff * coeff;
-    }
-  }
-
-  // Calculation of the pitch tracking function and test for the minima.
-  for ( delay_=1; delay_<=tMax_; delay_++ ) {
-    cumDt[delay_] = dt[delay_] + cumDt[delay_-1];
-    dpt[delay_] = dt[delay_] * delay_ / cumDt[delay_];
-
-    // Look for a minimum
-    if ( delay_ > 1 && dpt[delay_-1]-dpt[delay_-2] < 0 && dpt[delay_]-dpt[delay_-1] > 0 ) {
-      // Check if the minimum is under the threshold
-      if ( dpt[delay_-1] < threshold_ ){
-        lastPeriod_ = delay_-1;
-        // If a minimum is found, we can stop the loop
-        break;
-      }
-      else if ( dpt[alternativePitch] > dpt[delay_-1] )
-        // Otherwise we store it if it is the current global minimum
-        alternativePitch = delay_-1;
-    }
-  }
-
-  // Test for the last period length.
-  if ( dpt[delay_]-dpt[delay_-1] < 0 ) {
-    if ( dpt[delay_] < threshold_ )
-      lastPeriod_ = delay_;
-    else if ( dpt[alternativePitch] > dpt[delay_] )
-      alternativePitch = delay_;
-  }
-
-  if ( lastPeriod_ == tMax_+1 )
-    // No period has been under the threshold so we used the global minimum
-    lastPeriod_ = alternativePitch;
+  // Update of the input delay line.  Since the frames are of tMax_
+  // length, there is no overlapping between the successive windows
+  // where pitch tracking is performed.
+  for ( unsigned int n=0; n<inputFrames.size(); n++ )
+    inputLine_.tick( inputFrames[ n ] );
+
+  // Pitch tracking of the new frame.
+  lastPeriod_ = tracker_.analyze( &inputFrames[0] );
 
   // We put the new zero output coefficients in the output delay line and 
   // we get the previous calculated coefficients
@@ -3,6 +3,9 @@
 
 #include "Instrmnt.h"
 #include "OnePole.h"
+#include <vector>
+#include <thread>
+#include <atomic>
 
 namespace stk {
 
@@ -17,6 +20,16 @@ namespace stk {
     Waveguide Mesh", Proceedings of the 1993
     International Computer Music Conference.
 
+    The wave variables are stored in contiguous
+    rows, so that the junctions of a row are
+    updated by vectorizable loops, and the mesh
+    dimensions are only limited by memory.  The
+    dimension control changes cover sizes up to
+    NXMAX and NYMAX, while larger meshes can be set
+    with setNX() and setNY().  The rows of large
+    meshes can be computed by several threads (see
+    setThreads()).
+
     This is a digital waveguide model, making its
     use possibly subject to patents held by Stanford
     University, Yamaha, and others.
@@ -48,11 +61,33 @@ class Mesh2D : public Instrmnt
   void clear( void );
 
   //! Set the x dimension size in samples.
+  /*!
+    The mesh storage is enlarged if necessary, in which case memory is
+    allocated and the wave variables of the current mesh are copied.
+  */
   void setNX( unsigned short lenX );
 
   //! Set the y dimension size in samples.
+  /*!
+    The mesh storage is enlarged if necessary, in which case memory is
+    allocated and the wave variables of the current mesh are copied.
+  */
   void setNY( unsigned short lenY );
 
+  //! Set the number of threads computing the junctions of the mesh (default = 1).
+  /*!
+    The rows of the mesh are divided into bands, one for each thread,
+    with the calling thread computing the first one.  The threads are
+    synchronized twice for each output sample and wait actively for
+    the next sample, so that additional threads are only useful with
+    large meshes (several thousand junctions) which are computed
+    continuously.  The output is the same for any number of threads.
+  */
+  void setThreads( unsigned int nThreads );
+
+  //! Return the number of threads computing the junctions of the mesh.
+  unsigned int getThreads( void ) const { return nThreads_; };
+
   //! Set the x, y input position on a 0.0 - 1.0 scale.
   void setInputPosition( StkFloat xFactor, StkFloat yFactor );
 
@@ -89,27 +124,39 @@ class Mesh2D : public Instrmnt
 
  protected:
 
-  StkFloat tick0();
-  StkFloat tick1();
-  void clearMesh();
+  // The wave variables of one time step, each stored by rows of
+  // constant x, with stride_ values per row.
+  struct Waves {
+    StkFloat *xp;   // positive-x velocity wave
+    StkFloat *xm;   // negative-x velocity wave
+    StkFloat *yp;   // positive-y velocity wave
+    StkFloat *ym;   // negative-y velocity wave
+  };
+
+  StkFloat tickMesh( void );
+  void tickRows( unsigned short xBegin, unsigned short xEnd );
+  void clearMesh( void );
+  void resize( unsigned short maxX, unsigned short maxY );
+  void runThread( unsigned int index, unsigned long step );
+  void stopThreads( void );
 
   unsigned short NX_, NY_;
+  unsigned short maxX_, maxY_;       // allocated dimensions
+  size_t stride_;
   unsigned short xInput_, yInput_;
-  OnePole  filterX_[NXMAX];
-  OnePole  filterY_[NYMAX];
-  StkFloat v_[NXMAX-1][NYMAX-1]; // junction velocities
-  StkFloat vxp_[NXMAX][NYMAX];   // positive-x velocity wave
-  StkFloat vxm_[NXMAX][NYMAX];   // negative-x velocity wave
-  StkFloat vyp_[NXMAX][NYMAX];   // positive-y velocity wave
-  StkFloat vym_[NXMAX][NYMAX];   // negative-y velocity wave
-
-  // Alternate buffers
-  StkFloat vxp1_[NXMAX][NYMAX];  // positive-x velocity wave
-  StkFloat vxm1_[NXMAX][NYMAX];  // negative-x velocity wave
-  StkFloat vyp1_[NXMAX][NYMAX];  // positive-y velocity wave
-  StkFloat vym1_[NXMAX][NYMAX];  // negative-y velocity wave
+  StkFloat decay_;
+  std::vector<OnePole> filterX_;
+  std::vector<OnePole> filterY_;
+  std::vector<StkFloat> data_;
+  Waves waves_[2];                   // current and alternate buffers
 
   int counter_; // time in samples
+
+  unsigned int nThreads_;
+  std::vector<std::thread> threads_;
+  std::atomic<unsigned long> step_;      // incremented to start a step
+  std::atomic<unsigned int> finished_;   // threads done with the step
+  std::atomic<bool> running_;
 };
 
 inline StkFrames& Mesh2D :: tick( StkFrames& frames, unsigned int channel )
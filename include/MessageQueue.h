@@ -0,0 +1,105 @@
+#ifndef STK_MESSAGEQUEUE_H
+#define STK_MESSAGEQUEUE_H
+
+#include "Skini.h"
+#include "BoundedQueue.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class MessageQueue
+    \brief STK multi-producer / single-consumer control message queue.
+
+    This class implements a bounded, lock-free queue of
+    Skini::Message structures for passing control messages from any
+    number of producer threads (for example, MIDI, socket and stdin
+    input threads) to one consumer thread (typically an audio
+    callback), using the BoundedQueue class template.
+
+    Neither push() nor pop() blocks, locks or allocates memory.  When
+    the queue is full, push() returns \c false immediately and the
+    overrun counter is incremented, leaving it to the producer to
+    drop or retry the message.  Each message is stored with the time
+    at which it was pushed, measured by currentTime(), so that the
+    consumer can place it at the corresponding frame of its next
+    audio block.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class MessageQueue : public Stk
+{
+ public:
+  //! Default constructor.
+  /*!
+    The capacity is rounded up to the next power of two messages.
+  */
+  MessageQueue( unsigned long nMessages = 256 );
+
+  //! Class destructor.
+  ~MessageQueue( void );
+
+  //! Resize the queue and discard its contents.
+  /*!
+    The capacity is rounded up to the next power of two messages.
+    This function is not thread-safe and should only be called while
+    no other thread is accessing the queue.
+  */
+  void resize( unsigned long nMessages );
+
+  //! Discard the queue contents and reset the overrun counter.
+  /*!
+    This function is not thread-safe and should only be called while
+    no other thread is accessing the queue.
+  */
+  void reset( void );
+
+  //! Return the queue capacity in messages.
+  unsigned long capacity( void ) const { return queue_.capacity(); };
+
+  //! Return the approximate number of queued messages.
+  unsigned long size( void ) const { return queue_.size(); };
+
+  //! Push a message stamped with the current time, returning \c false if the queue is full.
+  bool push( const Skini::Message& message ) { return push( message, currentTime() ); };
+
+  //! Push a message with the given time stamp, returning \c false if the queue is full.
+  /*!
+    This function can be called concurrently by any number of
+    producer threads.  If the queue is full, the message is not
+    queued and the overrun counter is incremented.
+  */
+  bool push( const Skini::Message& message, double timeStamp );
+
+  //! Pop the oldest message, returning \c false if the queue is empty.
+  /*!
+    If \c timeStamp is not NULL, the time at which the message was
+    pushed is written to it.  Must only be called by the consumer
+    thread.
+  */
+  bool pop( Skini::Message& message, double *timeStamp = 0 );
+
+  //! Return the number of messages rejected because the queue was full, since instantiation or the last reset.
+  unsigned long getOverrunCount( void ) const { return queue_.getOverrunCount(); };
+
+  //! Return the current time in seconds on the clock used for message time stamps.
+  /*!
+    The clock is monotonic and its origin is unspecified, so only
+    differences between its values are meaningful.
+  */
+  static double currentTime( void );
+
+ protected:
+
+  struct Item {
+    Skini::Message message;
+    double timeStamp;
+  };
+
+  BoundedQueue<Item> queue_;
+};
+
+} // stk namespace
+
+#endif
@@ -3,11 +3,11 @@
 
 #include "Stk.h"
 #include "Skini.h"
-#include <queue>
+#include "MessageQueue.h"
+#include <atomic>
 
 #if defined(__STK_REALTIME__)
 
-#include "Mutex.h"
 #include "Thread.h"
 #include "TcpServer.h"
 #include "RtMidi.h"
@@ -43,6 +43,15 @@ namespace stk {
     an "exit" or "Exit" message is received from stdin or when all
     socket connections close and no stdin thread is running.
 
+    The queue is a lock-free MessageQueue, so popMessage() never
+    blocks or allocates memory and can be called from an audio
+    callback.  When the queue is full, MIDI messages are dropped
+    (see getOverrunCount()), while the stdin and socket threads hold
+    their current message and retry after a millisecond.  Each queued
+    message carries the time at which it arrived, which can be
+    retrieved with popMessage() to place the message at the
+    corresponding frame of the next audio block.
+
     This class is primarily for use in STK example programs but it is
     generic enough to work in many other contexts.
 
@@ -60,12 +69,10 @@ class Messager : public Stk
   // messager threads.  It must be public.
   struct MessagerData {
     Skini skini;
-    std::queue<Skini::Message> queue;
-    unsigned int queueLimit;
-    int sources;
+    MessageQueue queue;
+    std::atomic<int> sources;
 
 #if defined(__STK_REALTIME__)
-    Mutex mutex;
     RtMidiIn *midi;
     TcpServer *socket;
     std::vector<int> fd;
@@ -74,7 +81,7 @@ class Messager : public Stk
 
     // Default constructor.
     MessagerData()
-      :queueLimit(0), sources(0) {}
+      :queue(DEFAULT_QUEUE_LIMIT), sources(0) {}
   };
 
   //! Default constructor.
@@ -88,12 +95,18 @@ class Messager : public Stk
     Invalid messages (or an empty queue) are indicated by type
     values of zero, in which case all other message structure values
     are undefined.  The user MUST verify the returned message type is
-    valid before reading other message values.
+    valid before reading other message values.  If \c timeStamp is
+    not NULL, the arrival time of the message is written to it, in
+    seconds on the MessageQueue::currentTime() clock.  This function
+    never blocks.
   */
-  void popMessage( Skini::Message& message );
+  void popMessage( Skini::Message& message, double *timeStamp = 0 );
+
+  //! Push the referenced message onto the message queue, returning \c false if the queue is full.
+  bool pushMessage( Skini::Message& message );
 
-  //! Push the referenced message onto the message stack.
-  void pushMessage( Skini::Message& message );
+  //! Return the number of times a message could not be queued because the queue was full.
+  unsigned long getOverrunCount( void ) const { return data_.queue.getOverrunCount(); };
 
   //! Specify a SKINI formatted scorefile from which messages should be read.
   /*!
@@ -106,6 +119,9 @@ class Messager : public Stk
   */
   bool setScoreFile( const char* filename );
 
+  //! Return \c true if messages are read from a scorefile rather than from realtime input.
+  bool isScoreInput( void ) const;
+
 #if defined(__STK_REALTIME__)
   //! Initiate the "realtime" retreival from stdin of control messages into the queue.
   /*!
@@ -5,7 +5,7 @@
 #include "Envelope.h"
 #include "FileLoop.h"
 #include "SineWave.h"
-#include "BiQuad.h"
+#include "BiQuadBank.h"
 #include "OnePole.h"
 
 namespace stk {
@@ -85,7 +85,7 @@ protected:
 
   Envelope envelope_; 
   FileWvIn *wave_;
-  BiQuad **filters_;
+  BiQuadBank filters_;
   OnePole  onepole_;
   SineWave vibrato_;
 
@@ -105,9 +105,7 @@ inline StkFloat Modal :: tick( unsigned int )
 {
   StkFloat temp = masterGain_ * onepole_.tick( wave_->tick() * envelope_.tick() );
 
-  StkFloat temp2 = 0.0;
-  for ( unsigned int i=0; i<nModes_; i++ )
-    temp2 += filters_[i]->tick(temp);
+  StkFloat temp2 = filters_.tick( temp );
 
   temp2  -= temp2 * directGain_;
   temp2 += directGain_ * temp;
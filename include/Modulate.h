@@ -24,9 +24,6 @@ class Modulate : public Generator
 {
  public:
   //! Class constructor.
-  /*!
-    An StkError can be thrown if the rawwave path is incorrect.
-   */
   Modulate( void );
 
   //! Class destructor.
@@ -98,11 +95,21 @@ inline StkFrames& Modulate :: tick( StkFrames& frames, unsigned int channel )
   }
 #endif
 
+  // Compute the periodic modulation for the whole block and add the
+  // random modulation.
+  vibrato_.tick( frames, channel );
+
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop )
-    *samples = Modulate::tick();
+  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
+    if ( noiseCounter_++ >= noiseRate_ ) {
+      noise_.tick();
+      noiseCounter_ = 0;
+    }
+    *samples = vibratoGain_ * *samples + filter_.tick( noise_.lastOut() );
+  }
 
+  if ( frames.frames() ) lastFrame_[0] = *(samples-hop);
   return frames;
 }
 
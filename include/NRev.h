@@ -3,6 +3,7 @@
 
 #include "Effect.h"
 #include "Delay.h"
+#include "FDN.h"
 
 namespace stk {
 
@@ -16,7 +17,9 @@ namespace stk {
     filters.  This particular arrangement consists of 6 comb filters
     in parallel, followed by 3 allpass filters, a lowpass filter, and
     another allpass in series, followed by two allpass filters in
-    parallel with corresponding right and left outputs.
+    parallel with corresponding right and left outputs.  The comb
+    filters are computed together by the FDN class, which processes
+    blocks of samples in the tick( StkFrames& ) functions.
 
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
@@ -81,10 +84,15 @@ class NRev : public Effect
 
  protected:
 
+  // Compute the allpass and lowpass filters and the output frame
+  // from the sum of the comb filters.
+  void tickOutputs( StkFloat temp0, StkFloat input );
+
   Delay allpassDelays_[8];
-  Delay combDelays_[6];
+  FDN combs_;
+  StkFrames combInputs_;
+  StkFrames combOutputs_;
   StkFloat allpassCoefficient_;
-  StkFloat combCoefficient_[6];
 	StkFloat lowpassState_;
 
 };
@@ -101,24 +109,11 @@ inline StkFloat NRev :: lastOut( unsigned int channel )
   return lastFrame_[channel];
 }
 
-inline StkFloat NRev :: tick( StkFloat input, unsigned int channel )
+inline void NRev :: tickOutputs( StkFloat temp0, StkFloat input )
 {
-#if defined(_STK_DEBUG_)
-  if ( channel > 1 ) {
-    oStream_ << "NRev::tick(): channel argument must be less than 2!";
-    handleError( StkError::FUNCTION_ARGUMENT );
-  }
-#endif
-
-  StkFloat temp, temp0, temp1, temp2, temp3;
+  StkFloat temp, temp1, temp2, temp3;
   int i;
 
-  temp0 = 0.0;
-  for ( i=0; i<6; i++ ) {
-    temp = input + (combCoefficient_[i] * combDelays_[i].lastOut());
-    temp0 += combDelays_[i].tick(temp);
-  }
-
   for ( i=0; i<3; i++ )	{
     temp = allpassDelays_[i].lastOut();
     temp1 = allpassCoefficient_ * temp;
@@ -150,7 +145,18 @@ inline StkFloat NRev :: tick( StkFloat input, unsigned int channel )
   temp = ( 1.0 - effectMix_ ) * input;
   lastFrame_[0] += temp;
   lastFrame_[1] += temp;
-    
+}
+
+inline StkFloat NRev :: tick( StkFloat input, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel > 1 ) {
+    oStream_ << "NRev::tick(): channel argument must be less than 2!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  tickOutputs( combs_.tick( input ), input );
   return lastFrame_[channel];
 }
 
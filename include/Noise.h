@@ -2,7 +2,6 @@
 #define STK_NOISE_H
 
 #include "Generator.h"
-#include <stdlib.h>
 
 namespace stk {
 
@@ -10,9 +9,13 @@ namespace stk {
 /*! \class Noise
     \brief STK noise generator.
 
-    Generic random number generation using the
-    C rand() function.  The quality of the rand()
-    function varies from one OS to another.
+    Generic random number generation using a per-instance
+    xorshift128+ generator, which is much faster than the C rand()
+    function, is reentrant (so that separate instances can be used in
+    separate threads) and gives the same sequence for a given seed on
+    all platforms.  Each instance has its own state, so a render with
+    fixed seeds is reproducible regardless of the number of noise
+    generators or threads in use.
 
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
@@ -25,7 +28,8 @@ public:
   //! Default constructor that can also take a specific seed value.
   /*!
     If the seed value is zero (the default value), the random number generator is
-    seeded with the system time.
+    seeded with the system time, combined with a count of the seeded instances
+    so that generators created at the same time produce different sequences.
   */
   Noise( unsigned int seed = 0 );
 
@@ -54,11 +58,33 @@ public:
 
 protected:
 
+  // Advance the generator state and return a value in [-1.0, 1.0).
+  static StkFloat next( unsigned long long& s0, unsigned long long& s1 );
+
+  unsigned long long state_[2];
 };
 
+inline StkFloat Noise :: next( unsigned long long& s0, unsigned long long& s1 )
+{
+  unsigned long long x = s0;
+  const unsigned long long y = s1;
+  s0 = y;
+  x ^= x << 23;
+  s1 = x ^ y ^ ( x >> 17 ) ^ ( y >> 26 );
+
+  // The upper bits scaled to [0.0, 2.0) and offset.  Only as many
+  // bits are used as StkFloat can represent, so that rounding never
+  // gives 1.0.
+#if defined(__STK_FLOAT32__)
+  return (StkFloat) ( ( ( s1 + y ) >> 40 ) * ( 1.0 / 8388608.0 ) - 1.0 );
+#else
+  return (StkFloat) ( ( ( s1 + y ) >> 11 ) * ( 1.0 / 4503599627370496.0 ) - 1.0 );
+#endif
+}
+
 inline StkFloat Noise :: tick( void )
 {
-  return lastFrame_[0] = (StkFloat) ( 2.0 * rand() / (RAND_MAX + 1.0) - 1.0 );
+  return lastFrame_[0] = next( state_[0], state_[1] );
 }
 
 inline StkFrames& Noise :: tick( StkFrames& frames, unsigned int channel )
@@ -70,11 +96,15 @@ inline StkFrames& Noise :: tick( StkFrames& frames, unsigned int channel )
   }
 #endif
 
+  // The state is kept in locals so that it stays in registers.
+  unsigned long long s0 = state_[0], s1 = state_[1];
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
   for ( unsigned int i=0; i<frames.frames(); i++, samples += hop )
-    *samples = (StkFloat) ( 2.0 * rand() / (RAND_MAX + 1.0) - 1.0 );
+    *samples = next( s0, s1 );
 
+  state_[0] = s0;
+  state_[1] = s1;
   lastFrame_[0] = *(samples-hop);
   return frames;
 }
@@ -47,6 +47,15 @@ public:
   */
   void setPole( StkFloat thePole );
 
+  //! Set the number of adjacent interleaved channels filtered by the StkFrames tick() functions (default = 1).
+  /*!
+    Each channel has its own filter state, using the same
+    coefficients and gain, and lastFrame() holds the last output of
+    each.  The single-sample tick() function should only be used with
+    a single channel.  The filter states are cleared.
+  */
+  void setChannels( unsigned int nChannels ) { this->setStateChannels( nChannels ); };
+
   //! Return the last computed output value.
   StkFloat lastOut( void ) const { return lastFrame_[0]; };
 
@@ -61,6 +70,10 @@ public:
     However, range checking is only performed if _STK_DEBUG_ is
     defined during compilation, in which case an out-of-range value
     will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
@@ -72,9 +85,19 @@ public:
     by 0).  However, range checking is only performed if _STK_DEBUG_
     is defined during compilation, in which case an out-of-range value
     will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
   */
   StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
 
+ protected:
+
+  // Filter nFrames frames of the (interleaved) input and output,
+  // which may be the same.
+  void tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames );
+
 };
 
 inline StkFloat OnePole :: tick( StkFloat input )
@@ -89,7 +112,7 @@ inline StkFloat OnePole :: tick( StkFloat input )
 inline StkFrames& OnePole :: tick( StkFrames& frames, unsigned int channel )
 {
 #if defined(_STK_DEBUG_)
-  if ( channel >= frames.channels() ) {
+  if ( channel + channelsIn_ > frames.channels() ) {
     oStream_ << "OnePole::tick(): channel and StkFrames arguments are incompatible!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
@@ -97,35 +120,20 @@ inline StkFrames& OnePole :: tick( StkFrames& frames, unsigned int channel )
 
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    inputs_[0] = gain_ * *samples;
-    *samples = b_[0] * inputs_[0] - a_[1] * outputs_[1];
-    outputs_[1] = *samples;
-  }
-
-  lastFrame_[0] = outputs_[1];
+  this->tickFrames( samples, hop, samples, hop, frames.frames() );
   return frames;
 }
 
 inline StkFrames& OnePole :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
 {
 #if defined(_STK_DEBUG_)
-  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() ) {
+  if ( iChannel + channelsIn_ > iFrames.channels() || oChannel + channelsIn_ > oFrames.channels() ) {
     oStream_ << "OnePole::tick(): channel and StkFrames arguments are incompatible!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 #endif
 
-  StkFloat *iSamples = &iFrames[iChannel];
-  StkFloat *oSamples = &oFrames[oChannel];
-  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
-  for ( unsigned int i=0; i<iFrames.frames(); i++, iSamples += iHop, oSamples += oHop ) {
-    inputs_[0] = gain_ * *iSamples;
-    *oSamples = b_[0] * inputs_[0] - a_[1] * outputs_[1];
-    outputs_[1] = *oSamples;
-  }
-
-  lastFrame_[0] = outputs_[1];
+  this->tickFrames( &iFrames[iChannel], iFrames.channels(), &oFrames[oChannel], oFrames.channels(), iFrames.frames() );
   return iFrames;
 }
 
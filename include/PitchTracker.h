@@ -0,0 +1,105 @@
+#ifndef STK_PITCHTRACKER_H
+#define STK_PITCHTRACKER_H
+
+#include "Stk.h"
+#include "FFT.h"
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class PitchTracker
+    \brief STK pitch tracking class based on the difference function.
+
+    This class estimates the period of its input signal for
+    successive frames of samples, with the cumulative mean normalized
+    difference function of the YIN algorithm (de Cheveigne and
+    Kawahara, 2002), as in the LentPitShift class.  The size of the
+    frames is the maximal period which can be detected.
+
+    The difference function of a frame of N samples and the N
+    previous ones is computed for all periods up to N from the
+    autocorrelation, which is computed with an FFT of 2N points (or
+    the next power of two), and the energies of the frame and of the
+    delayed frames.  This takes O(N log N) operations instead of the
+    O(N^2) of the direct computation.
+
+    The detected period is the first minimum of the normalized
+    difference function below the threshold or, without such a
+    minimum, the smallest minimum.  The confidence is one minus the
+    value of the normalized difference function at the period, which
+    is close to one for periodic signals and close to zero for noise.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class PitchTracker : public Stk
+{
+ public:
+  //! Class constructor, taking the frame size (the maximal period in samples) and the detection threshold.
+  PitchTracker( unsigned long tMax = RT_BUFFER_SIZE, StkFloat threshold = 0.1 );
+
+  //! Class destructor.
+  ~PitchTracker( void );
+
+  //! Reset and clear all internal state.
+  void clear( void );
+
+  //! Set the threshold of the normalized difference function for the detection of a period (default = 0.1).
+  void setThreshold( StkFloat threshold );
+
+  //! Return the frame size, which is also the maximal period in samples.
+  unsigned long getFrameSize( void ) const { return tMax_; };
+
+  //! Return the period in samples detected in the last frame.
+  unsigned long getPeriod( void ) const { return period_; };
+
+  //! Return the frequency corresponding to the period detected in the last frame.
+  StkFloat getFrequency( void ) const { return Stk::sampleRate() / period_; };
+
+  //! Return the confidence (0.0 - 1.0) of the period detected in the last frame.
+  StkFloat getConfidence( void ) const { return confidence_; };
+
+  //! Analyze a frame of getFrameSize() samples and return the detected period in samples.
+  /*!
+    The samples are read from \e input with the given \e stride.
+  */
+  unsigned long analyze( const StkFloat *input, unsigned int stride = 1 );
+
+  //! Input one sample and return the period in samples detected in the last complete frame.
+  StkFloat tick( StkFloat input );
+
+ protected:
+
+  unsigned long tMax_;
+  StkFloat threshold_;
+  unsigned long period_;
+  StkFloat confidence_;
+  unsigned long inputCount_;
+
+  FFT fft_;
+  std::vector<StkFloat> history_;    // previous and current frames, zero padded
+  std::vector<StkFloat> frame_;      // current frame, zero padded
+  std::vector<StkFloat> real_;
+  std::vector<StkFloat> imag_;
+  std::vector<StkFloat> frameReal_;
+  std::vector<StkFloat> frameImag_;
+  std::vector<StkFloat> correlation_;
+  std::vector<StkFloat> dpt_;        // normalized difference function
+};
+
+inline StkFloat PitchTracker :: tick( StkFloat input )
+{
+  frame_[inputCount_++] = input;
+  if ( inputCount_ == tMax_ ) {
+    inputCount_ = 0;
+    this->analyze( &frame_[0] );
+  }
+
+  return period_;
+}
+
+} // stk namespace
+
+#endif
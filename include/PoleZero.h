@@ -58,6 +58,15 @@ class PoleZero : public Filter
   */
   void setBlockZero( StkFloat thePole = 0.99 );
 
+  //! Set the number of adjacent interleaved channels filtered by the StkFrames tick() functions (default = 1).
+  /*!
+    Each channel has its own filter state, using the same
+    coefficients and gain, and lastFrame() holds the last output of
+    each.  The single-sample tick() function should only be used with
+    a single channel.  The filter states are cleared.
+  */
+  void setChannels( unsigned int nChannels ) { this->setStateChannels( nChannels ); };
+
   //! Return the last computed output value.
   StkFloat lastOut( void ) const { return lastFrame_[0]; };
 
@@ -71,9 +80,34 @@ class PoleZero : public Filter
     by 0).  However, range checking is only performed if _STK_DEBUG_
     is defined during compilation, in which case an out-of-range value
     will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
+  //! Take a channel of the \c iFrames object as inputs to the filter and write outputs to the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  Each channel
+    argument must be less than the number of channels in the
+    corresponding StkFrames argument (the first channel is specified
+    by 0).  However, range checking is only performed if _STK_DEBUG_
+    is defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+
+    If the filter has more than one channel (see setChannels()),
+    that many adjacent channels, starting at the given channel, are
+    filtered.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+ protected:
+
+  // Filter nFrames frames of the (interleaved) input and output,
+  // which may be the same.
+  void tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames );
+
 };
 
 inline StkFloat PoleZero :: tick( StkFloat input )
@@ -89,7 +123,7 @@ inline StkFloat PoleZero :: tick( StkFloat input )
 inline StkFrames& PoleZero :: tick( StkFrames& frames, unsigned int channel )
 {
 #if defined(_STK_DEBUG_)
-  if ( channel >= frames.channels() ) {
+  if ( channel + channelsIn_ > frames.channels() ) {
     oStream_ << "PoleZero::tick(): channel and StkFrames arguments are incompatible!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
@@ -97,15 +131,21 @@ inline StkFrames& PoleZero :: tick( StkFrames& frames, unsigned int channel )
 
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    inputs_[0] = gain_ * *samples;
-    *samples = b_[0] * inputs_[0] + b_[1] * inputs_[1] - a_[1] * outputs_[1];
-    inputs_[1] = inputs_[0];
-    outputs_[1] = *samples;
+  this->tickFrames( samples, hop, samples, hop, frames.frames() );
+  return frames;
+}
+
+inline StkFrames& PoleZero :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel + channelsIn_ > iFrames.channels() || oChannel + channelsIn_ > oFrames.channels() ) {
+    oStream_ << "PoleZero::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
   }
+#endif
 
-  lastFrame_[0] = outputs_[1];
-  return frames;
+  this->tickFrames( &iFrames[iChannel], iFrames.channels(), &oFrames[oChannel], oFrames.channels(), iFrames.frames() );
+  return iFrames;
 }
 
 } // stk namespace
@@ -0,0 +1,137 @@
+#ifndef STK_RESAMPLER_H
+#define STK_RESAMPLER_H
+
+#include "Stk.h"
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class Resampler
+    \brief STK band-limited interpolation and sample rate conversion class.
+
+    This class computes values of sampled data at arbitrary fractional
+    times with windowed-sinc (Kaiser window) interpolation filters,
+    which avoids most of the aliasing and imaging of linear
+    interpolation.  The filters are tabulated for 256 fractional
+    positions (phases) between samples, with linear interpolation
+    between the phases, so that any rate can be used and the rate can
+    change at any time.  When the data is read faster than its sample
+    rate (a rate greater than one), the filter bandwidth is reduced
+    accordingly and the number of filter taps increases.
+
+    The tables are computed once, when a quality level is first used,
+    and are shared by all instances.  The LINEAR quality uses linear
+    interpolation (a triangular filter, with reduced bandwidth for
+    rates greater than one) and the LOW, MEDIUM and HIGH qualities use
+    windowed-sinc filters with 8, 16 and 32 taps at rates up to one.
+
+    The interpolate() function computes the value of a multi-channel
+    frame at any time of an StkFrames object, as used by the FileWvIn
+    and FileLoop classes.  The process() function provides a streaming
+    converter between arbitrary rates, with an output delay of
+    getLatency() input frames.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class Resampler : public Stk
+{
+ public:
+  //! Interpolation quality levels.
+  enum Quality {
+    LINEAR,    /*!< Linear interpolation. */
+    LOW,       /*!< Windowed-sinc interpolation with 8 taps. */
+    MEDIUM,    /*!< Windowed-sinc interpolation with 16 taps. */
+    HIGH       /*!< Windowed-sinc interpolation with 32 taps. */
+  };
+
+  //! Class constructor, taking the quality level and the number of channels of the streaming converter.
+  Resampler( Quality quality = MEDIUM, unsigned int nChannels = 1 );
+
+  //! Class destructor.
+  ~Resampler( void );
+
+  //! Set the interpolation quality level.
+  void setQuality( Quality quality );
+
+  //! Return the interpolation quality level.
+  Quality getQuality( void ) const { return quality_; };
+
+  //! Set the number of input frames per output frame (default = 1.0).
+  /*!
+    The rate must be positive.  It can be changed at any time,
+    including between calls to process().
+  */
+  void setRate( StkFloat rate );
+
+  //! Return the number of input frames per output frame.
+  StkFloat getRate( void ) const { return rate_; };
+
+  //! Set the number of channels of the streaming converter and clear its state.
+  void setChannels( unsigned int nChannels );
+
+  //! Return the number of input frames by which the output of the streaming converter is delayed at the current rate.
+  unsigned long getLatency( void ) const { return taps_; };
+
+  //! Clear the state of the streaming converter.
+  void clear( void );
+
+  //! Compute the frame of \e data at the fractional frame index \e time.
+  /*!
+    The values of all channels of the data are written to \e frame,
+    which must have at least as many channels.  Frames outside of the
+    data are zero, unless \e loopSize is greater than zero, in which
+    case the frame indices are taken modulo \e loopSize.
+  */
+  void interpolate( const StkFrames& data, StkFloat time, StkFrames& frame, unsigned long loopSize = 0 );
+
+  //! Convert the \e input frames and write the results to \e output, returning the number of output frames written.
+  /*!
+    Both StkFrames objects must have the number of channels set with
+    setChannels().  The input frames are added to those previously
+    given and as many output frames as possible are computed, up to
+    the size of \e output.  About input.frames() / getRate() output
+    frames are computed for each call, so that input frames are
+    buffered when the output is too small.
+  */
+  unsigned long process( const StkFrames& input, StkFrames& output );
+
+ protected:
+
+  // The number of tabulated phases between samples.
+  static const unsigned int PHASES = 256;
+
+  // The filter of a quality level, with one side of its impulse
+  // response tabulated for each phase p as h( k + p / PHASES ), k <
+  // zeroCrossings, followed by the next phase.
+  struct Table {
+    Table( Quality quality );
+    unsigned int zeroCrossings;
+    std::vector<StkFloat> coefficients;
+    std::vector<StkFloat> differences;     // with the next phase
+  };
+
+  static const Table& getTable( Quality quality );
+
+  // Compute the weights of the taps on each side of the given time.
+  void setWeights( StkFloat time );
+
+  // Compute a frame of the first nFrames frames of data.
+  void compute( const StkFrames& data, unsigned long nFrames, StkFloat time, StkFloat *output, unsigned long loopSize );
+
+  Quality quality_;
+  const Table *table_;
+  StkFloat rate_;
+  unsigned int taps_;                  // taps on each side of the time
+  std::vector<StkFloat> weights_;
+  unsigned int nChannels_;
+  StkFrames history_;
+  unsigned long historyFrames_;
+  StkFloat time_;
+};
+
+} // stk namespace
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef STK_RINGBUFFER_H
+#define STK_RINGBUFFER_H
+
+#include "Stk.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace stk {
+
+/***************************************************/
+/*! \class RingBuffer
+    \brief STK single-producer / single-consumer audio ring buffer.
+
+    This class implements a wait-free ring buffer of interleaved
+    StkFloat sample frames for passing audio between exactly one
+    producer thread and one consumer thread (for example, a user
+    thread and an RtAudio callback).  The read and write positions are
+    atomic counters kept on separate cache lines and the storage is
+    rounded up to a power of two frames, so that index wrapping is a
+    simple mask.  The buffer never holds more than the requested
+    number of frames, so that the latency it adds does not depend on
+    the rounding.
+
+    The read(), write() and region functions never block or lock and
+    can be called from a realtime audio callback.  A short read() is
+    counted as an underrun and a short write() is counted as an
+    overrun.  The waitForData() and waitForSpace() functions allow the
+    non-realtime side to block on a condition variable until the
+    other side has made progress, rather than polling with
+    Stk::sleep().  The realtime side only touches the condition
+    variable while the other side is actually blocked.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class RingBuffer : public Stk
+{
+ public:
+  //! Default constructor creates a buffer which holds up to \c nFrames frames.
+  RingBuffer( unsigned long nFrames = 0, unsigned int nChannels = 1 );
+
+  //! Class destructor.
+  ~RingBuffer( void );
+
+  //! Resize the buffer to hold up to \c nFrames frames and discard its contents.
+  /*!
+    This function is not thread-safe and should only be called while
+    no other thread is accessing the buffer.
+  */
+  void resize( unsigned long nFrames, unsigned int nChannels = 1 );
+
+  //! Discard the buffer contents and reset the underrun and overrun counters.
+  /*!
+    This function is not thread-safe and should only be called while
+    no other thread is accessing the buffer.
+  */
+  void reset( void );
+
+  //! Return the buffer capacity in frames.
+  unsigned long frames( void ) const { return limit_; };
+
+  //! Return the number of channels per frame.
+  unsigned int channels( void ) const { return nChannels_; };
+
+  //! Return the number of frames available for reading.
+  unsigned long framesAvailable( void ) const;
+
+  //! Return the number of frames that can currently be written.
+  unsigned long framesFree( void ) const { return limit_ - framesAvailable(); };
+
+  //! Write up to \c nFrames interleaved frames without blocking and return the number written.
+  /*!
+    If fewer than \c nFrames frames fit, the remainder is dropped and
+    the overrun counter is incremented.  Must only be called by the
+    producer thread.
+  */
+  unsigned long write( const StkFloat *samples, unsigned long nFrames );
+
+  //! Read up to \c nFrames interleaved frames without blocking and return the number read.
+  /*!
+    If fewer than \c nFrames frames are available, the remainder of
+    \c samples is left untouched and the underrun counter is
+    incremented.  Must only be called by the consumer thread.
+  */
+  unsigned long read( StkFloat *samples, unsigned long nFrames );
+
+  //! Return a pointer to the contiguous writable region and its length in frames.
+  /*!
+    After filling some or all of the region, the producer must call
+    commitWrite() to make the frames visible to the consumer.
+  */
+  StkFloat *writeRegion( unsigned long *nFrames );
+
+  //! Publish \c nFrames frames previously written into the write region.
+  void commitWrite( unsigned long nFrames );
+
+  //! Return a pointer to the contiguous readable region and its length in frames.
+  /*!
+    After using some or all of the region, the consumer must call
+    commitRead() to release the frames back to the producer.
+  */
+  StkFloat *readRegion( unsigned long *nFrames );
+
+  //! Release \c nFrames frames previously obtained from the read region.
+  void commitRead( unsigned long nFrames );
+
+  //! Block the consumer until at least \c nFrames frames can be read.
+  void waitForData( unsigned long nFrames = 1 );
+
+  //! Block the producer until at least \c nFrames frames can be written.
+  void waitForSpace( unsigned long nFrames = 1 );
+
+  //! Return the number of short reads since instantiation or the last reset.
+  unsigned long getUnderrunCount( void ) const { return underruns_.load( std::memory_order_relaxed ); };
+
+  //! Return the number of short writes since instantiation or the last reset.
+  unsigned long getOverrunCount( void ) const { return overruns_.load( std::memory_order_relaxed ); };
+
+ protected:
+
+  void wake( void );
+
+  StkFrames data_;
+  unsigned long size_;   // storage in frames (a power of two)
+  unsigned long mask_;
+  unsigned long limit_;  // capacity in frames
+  unsigned int nChannels_;
+
+  // Producer and consumer positions are free-running counters, padded
+  // onto separate cache lines to avoid false sharing.
+  char pad0_[64];
+  std::atomic<unsigned long> writeIndex_;
+  char pad1_[64 - sizeof(std::atomic<unsigned long>)];
+  std::atomic<unsigned long> readIndex_;
+  char pad2_[64 - sizeof(std::atomic<unsigned long>)];
+  std::atomic<unsigned long> underruns_;
+  std::atomic<unsigned long> overruns_;
+  std::atomic<bool> waiting_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+};
+
+inline unsigned long RingBuffer :: framesAvailable( void ) const
+{
+  return writeIndex_.load() - readIndex_.load();
+}
+
+} // stk namespace
+
+#endif
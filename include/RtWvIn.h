@@ -3,7 +3,7 @@
 
 #include "WvIn.h"
 #include "RtAudio.h"
-#include "Mutex.h"
+#include "RingBuffer.h"
 
 namespace stk {
 
@@ -13,9 +13,9 @@ namespace stk {
 
     This class provides a simplified interface to RtAudio for realtime
     audio input.  It is a subclass of WvIn.  This class makes use of
-    RtAudio's callback functionality by creating a large ring-buffer
-    from which data is read.  This class should not be used when
-    low-latency is desired.
+    RtAudio's callback functionality by creating a large lock-free
+    ring-buffer (see RingBuffer) from which data is read.  This class
+    should not be used when low-latency is desired.
 
     RtWvIn supports multi-channel data in both interleaved and
     non-interleaved formats.  It is important to distinguish the
@@ -94,6 +94,14 @@ public:
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
+  //! Return the number of audio buffer overruns since instantiation.
+  /*!
+    An overrun occurs when the audio callback supplies more data than
+    there is free space in the buffer, in which case the newest input
+    frames are discarded.
+  */
+  unsigned long getOverrunCount( void ) const { return buffer_.getOverrunCount(); };
+
   // This function is not intended for general use but must be
   // public for access from the audio callback function.
   void fillBuffer( void *buffer, unsigned int nFrames );
@@ -101,11 +109,8 @@ public:
 protected:
 
 	RtAudio adc_;
-  Mutex mutex_;
+  RingBuffer buffer_;
   bool stopped_;
-  unsigned int readIndex_;
-  unsigned int writeIndex_;
-  unsigned int framesFilled_;
 
 };
 
@@ -3,7 +3,7 @@
 
 #include "WvOut.h"
 #include "RtAudio.h"
-#include "Mutex.h"
+#include "RingBuffer.h"
 
 namespace stk {
 
@@ -13,9 +13,9 @@ namespace stk {
 
     This class provides a simplified interface to RtAudio for realtime
     audio output.  It is a subclass of WvOut.  This class makes use of
-    RtAudio's callback functionality by creating a large ring-buffer
-    into which data is written.  This class should not be used when
-    low-latency is desired.
+    RtAudio's callback functionality by creating a large lock-free
+    ring-buffer (see RingBuffer) into which data is written.  This
+    class should not be used when low-latency is desired.
 
     RtWvOut supports multi-channel data in interleaved format.  It is
     important to distinguish the tick() method that outputs a single
@@ -75,6 +75,14 @@ class RtWvOut : public WvOut
   */
   void tick( const StkFrames& frames );
 
+  //! Return the number of audio buffer underruns since instantiation.
+  /*!
+    An underrun occurs when the audio callback requests more data
+    than has been written, in which case silence is output for the
+    missing frames.
+  */
+  unsigned long getUnderrunCount( void ) const { return buffer_.getUnderrunCount(); };
+
   // This function is not intended for general use but must be
   // public for access from the audio callback function.
   int readBuffer( void *buffer, unsigned int frameCount );
@@ -82,11 +90,8 @@ class RtWvOut : public WvOut
  protected:
 
   RtAudio dac_;
-  Mutex mutex_;
+  RingBuffer buffer_;
   bool stopped_;
-  unsigned int readIndex_;
-  unsigned int writeIndex_;
-  long framesFilled_;
   unsigned int status_; // running = 0, emptying buffer = 1, finished = 2
 
 };
@@ -40,6 +40,12 @@ class Sampler : public Instrmnt
   //! Stop a note with the given amplitude (speed of decay).
   virtual void noteOff( StkFloat amplitude );
 
+  //! Set the interpolation quality of the attack and looped waves (default = Resampler::LINEAR).
+  /*!
+    This applies to the waves loaded when the function is called.
+  */
+  void setInterpolationQuality( Resampler::Quality quality );
+
   //! Perform the control change specified by \e number and \e value (0.0 - 128.0).
   virtual void controlChange( int number, StkFloat value ) = 0;
 
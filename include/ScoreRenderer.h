@@ -0,0 +1,137 @@
+#ifndef STK_SCORERENDERER_H
+#define STK_SCORERENDERER_H
+
+#include "Voicer.h"
+#include "FileWrite.h"
+#include <string>
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class ScoreRenderer
+    \brief STK offline SKINI score renderer.
+
+    This class renders SKINI scorefiles to audio files as fast as
+    possible, without a realtime audio device.  Each score is played
+    by a Voicer holding one or more instruments, which are created by
+    a user-supplied InstrumentCreator function from a program number
+    (the equivalent of the demo program's voiceByNumber() function),
+    followed by a JCRev reverberator, and is written with FileWvOut.
+    Control messages are handled in the same way as in the demo
+    program, including program changes and the settling period at
+    the end of a score.
+
+    Messages are applied at their exact sample frame, and the audio
+    between messages is computed in blocks with the StkFrames tick()
+    functions rather than one frame at a time.  The render() function
+    that takes a list of jobs renders independent scores in parallel
+    on several threads.  For each score, a Report is returned which
+    includes the ratio of audio duration to rendering time (the
+    realtime factor).
+
+    Each score is rendered within its own RenderContext, at the
+    sample rate of its job or else at the sample rate of the calling
+    thread, so that scores at different rates can be rendered
+    concurrently.  The rawwave path must be set before rendering and
+    must not be changed while rendering.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class ScoreRenderer : public Stk
+{
+ public:
+  //! A function which returns a new instrument for the given program number, or NULL if there is none.
+  /*!
+    When rendering several scores in parallel, this function is
+    called concurrently from several threads.
+  */
+  typedef Instrmnt *(*InstrumentCreator)( int program, void *userData );
+
+  //! A score rendering job.
+  struct Job {
+    std::string scoreFile;             /*!< The SKINI scorefile to render. */
+    std::string outputFile;            /*!< The audio file to write. */
+    int program;                       /*!< The initial program (instrument) number. */
+    unsigned int nVoices;              /*!< The number of voices (instruments) in the Voicer. */
+    StkFloat sampleRate;               /*!< The sample rate, or zero for the sample rate of the calling thread. */
+
+    // Default constructor.
+    Job( const std::string& score = std::string(), const std::string& output = std::string(),
+         int programNumber = 0, unsigned int voices = 1, StkFloat rate = 0.0 )
+      :scoreFile(score), outputFile(output), program(programNumber), nVoices(voices), sampleRate(rate) {}
+  };
+
+  //! The result of rendering one score.
+  struct Report {
+    std::string scoreFile;             /*!< The rendered SKINI scorefile. */
+    std::string outputFile;            /*!< The written audio file. */
+    bool ok;                           /*!< False if an error occurred. */
+    std::string error;                 /*!< A description of the error, if any. */
+    unsigned long messages;            /*!< The number of processed score messages. */
+    unsigned long frames;              /*!< The number of rendered sample frames. */
+    double audioTime;                  /*!< The duration of the rendered audio in seconds. */
+    double renderTime;                 /*!< The wall-clock rendering time in seconds. */
+    double realtimeFactor;             /*!< The ratio of audioTime to renderTime. */
+
+    // Default constructor.
+    Report()
+      :ok(false), messages(0), frames(0), audioTime(0.0), renderTime(0.0), realtimeFactor(0.0) {}
+  };
+
+  //! Class constructor, taking the instrument creation function and an optional pointer passed to it.
+  ScoreRenderer( InstrumentCreator creator, void *userData = 0 );
+
+  //! Class destructor.
+  ~ScoreRenderer( void );
+
+  //! Set the number of frames computed at a time (default = 1024).
+  void setBlockSize( unsigned int nFrames );
+
+  //! Set the number of output channels (1 = the left reverb output, 2 = stereo; default = 1).
+  void setChannels( unsigned int nChannels );
+
+  //! Set the output file type and data format (default = WAV, STK_SINT16).
+  void setFileFormat( FileWrite::FILE_TYPE type, Stk::StkFormat format );
+
+  //! Set the reverberation time in seconds and the initial effect mix (default = 0.75, 0.2).
+  /*!
+    The settling period applied before a program change and at the
+    end of a score is 0.3 times the reverberation time, as in the
+    demo program.
+  */
+  void setReverb( StkFloat t60, StkFloat mix );
+
+  //! Render a single score and return its report.
+  /*!
+    Errors are reported in the returned structure (and as warnings),
+    rather than by throwing an exception.
+  */
+  Report render( const Job& job ) const;
+
+  //! Render several independent scores, using up to \e nThreads threads, and return their reports in the same order.
+  /*!
+    If \e nThreads is zero, one thread per available processor core
+    is used.
+  */
+  std::vector<Report> render( const std::vector<Job>& jobs, unsigned int nThreads = 0 ) const;
+
+ protected:
+
+  bool renderScore( const Job& job, Report& report, std::vector<Instrmnt *>& instruments ) const;
+
+  InstrumentCreator creator_;
+  void *userData_;
+  unsigned int blockSize_;
+  unsigned int nChannels_;
+  FileWrite::FILE_TYPE fileType_;
+  Stk::StkFormat dataFormat_;
+  StkFloat t60_;
+  StkFloat effectMix_;
+};
+
+} // stk namespace
+
+#endif
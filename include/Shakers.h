@@ -2,8 +2,9 @@
 #define STK_SHAKERS_H
 
 #include "Instrmnt.h"
+#include "BiQuadBank.h"
+#include "Noise.h"
 #include <cmath>
-#include <stdlib.h>
 
 namespace stk {
 
@@ -76,6 +77,14 @@ class Shakers : public Instrmnt
   //! Perform the control change specified by \e number and \e value (0.0 - 128.0).
   void controlChange( int number, StkFloat value );
 
+  //! Seed the random number generator used for the collision events.
+  /*!
+    A non-zero seed gives the same output on every run.  If the seed
+    value is zero, the generator is seeded with the current system
+    time.
+  */
+  void setSeed( unsigned int seed = 0 ) { noise_.setSeed( seed ); };
+
   //! Compute and return one output sample.
   StkFloat tick( unsigned int channel = 0 );
 
@@ -112,8 +121,6 @@ class Shakers : public Instrmnt
  protected:
 
   void setType( int type );
-  void setResonance( BiQuad &filter, StkFloat frequency, StkFloat radius );
-  StkFloat tickResonance( BiQuad &filter, StkFloat input );
   void setEqualization( StkFloat b0, StkFloat b1, StkFloat b2 );
   StkFloat tickEqualize( StkFloat input );
   int randomInt( int max );
@@ -139,29 +146,16 @@ class Shakers : public Instrmnt
   StkFloat baseRatchetDelta_;
   int lastRatchetValue_;
 
-  std::vector< BiQuad > filters_;
+  BiQuadBank filters_;
+  std::vector< StkFloat > tubeInputs_;
   std::vector< StkFloat > baseFrequencies_;
   std::vector< StkFloat > baseRadii_;
   std::vector< bool > doVaryFrequency_;
   std::vector< StkFloat > tempFrequencies_;
   StkFloat varyFactor_;
+  Noise noise_;
 };
 
-inline void Shakers :: setResonance( BiQuad &filter, StkFloat frequency, StkFloat radius )
-{
-  filter.a[1] = -2.0 * radius * cos( TWO_PI * frequency / Stk::sampleRate());
-  filter.a[2] = radius * radius;
-}
-
-inline StkFloat Shakers :: tickResonance( BiQuad &filter, StkFloat input )
-{
-  filter.outputs[0] = input * filter.gain * currentGain_;
-  filter.outputs[0] -= filter.a[1] * filter.outputs[1] + filter.a[2] * filter.outputs[2];
-  filter.outputs[2] = filter.outputs[1];
-  filter.outputs[1] = filter.outputs[0];
-  return filter.outputs[0];
-}
-
 inline void Shakers :: setEqualization( StkFloat b0, StkFloat b1, StkFloat b2 )
 {
   equalizer_.b[0] = b0;
@@ -180,17 +174,18 @@ inline StkFloat Shakers :: tickEqualize( StkFloat input )
 
 inline int Shakers :: randomInt( int max ) //  Return random integer between 0 and max-1
 {
-  return (int) ((float)max * rand() / (RAND_MAX + 1.0) );
+  int value = (int) ( max * 0.5 * ( (double) noise_.tick() + 1.0 ) );
+  return ( value < max ) ? value : max - 1;
 }
 
 inline StkFloat Shakers :: randomFloat( StkFloat max ) // Return random float between 0.0 and max
 {	
-  return (StkFloat) (max * rand() / (RAND_MAX + 1.0) );
+  return (StkFloat) ( max * 0.5 * ( (double) noise_.tick() + 1.0 ) );
 }
 
 inline StkFloat Shakers :: noise( void ) //  Return random StkFloat float between -1.0 and 1.0
 {
-  return ( (StkFloat) ( 2.0 * rand() / (RAND_MAX + 1.0) ) - 1.0 );
+  return noise_.tick();
 }
 
 const StkFloat MIN_ENERGY = 0.001;
@@ -201,29 +196,30 @@ inline void Shakers :: waterDrop( void )
   if ( randomInt( 32767 ) < nObjects_) {
     sndLevel_ = shakeEnergy_;   
     unsigned int j = randomInt( 3 );
-    if ( j == 0 && filters_[0].gain == 0.0 ) { // don't change unless fully decayed
+    if ( j == 0 && filters_.getGain(0) == 0.0 ) { // don't change unless fully decayed
       tempFrequencies_[0] = baseFrequencies_[1] * (0.75 + (0.25 * noise()));
-      filters_[0].gain = fabs( noise() );
+      filters_.setGain( 0, fabs( noise() ) );
     }
-    else if (j == 1 && filters_[1].gain == 0.0) {
+    else if (j == 1 && filters_.getGain(1) == 0.0) {
       tempFrequencies_[1] = baseFrequencies_[1] * (1.0 + (0.25 * noise()));
-      filters_[1].gain = fabs( noise() );
+      filters_.setGain( 1, fabs( noise() ) );
     }
-    else if ( filters_[2].gain == 0.0 ) {
+    else if ( filters_.getGain(2) == 0.0 ) {
       tempFrequencies_[2] = baseFrequencies_[1] * (1.25 + (0.25 * noise()));
-      filters_[2].gain = fabs( noise() );
+      filters_.setGain( 2, fabs( noise() ) );
     }
   }
 
   // Sweep center frequencies.
   for ( unsigned int i=0; i<3; i++ ) { // WATER_RESONANCES = 3
-    filters_[i].gain *= baseRadii_[i];
-    if ( filters_[i].gain > 0.001 ) {
+    StkFloat gain = filters_.getGain(i) * baseRadii_[i];
+    if ( gain > 0.001 ) {
       tempFrequencies_[i] *= WATER_FREQ_SWEEP;
-      filters_[i].a[1] = -2.0 * baseRadii_[i] * cos( TWO_PI * tempFrequencies_[i] / Stk::sampleRate() );
+      filters_.setA1( i, -2.0 * baseRadii_[i] * cos( TWO_PI * tempFrequencies_[i] / Stk::sampleRate() ) );
     }
     else
-      filters_[i].gain = 0.0;
+      gain = 0.0;
+    filters_.setGain( i, gain );
   }
 }
 
@@ -265,7 +261,7 @@ inline StkFloat Shakers :: tick( unsigned int )
         for ( unsigned int i=0; i<nResonances_; i++ ) {
           if ( doVaryFrequency_[i] ) {
             StkFloat tempRand = baseFrequencies_[i] * ( 1.0 + ( varyFactor_ * noise() ) );
-            filters_[i].a[1] = -2.0 * baseRadii_[i] * cos( TWO_PI * tempRand / Stk::sampleRate() );
+            filters_.setA1( i, -2.0 * baseRadii_[i] * cos( TWO_PI * tempRand / Stk::sampleRate() ) );
           }
         }
         if ( shakerType_ == 22 ) iTube = randomInt( 7 ); // ANGKLUNG_RESONANCES
@@ -277,19 +273,15 @@ inline StkFloat Shakers :: tick( unsigned int )
   sndLevel_ *= soundDecay_;
 
   // Do resonance filtering
-  lastFrame_[0] = 0.0;
   if ( shakerType_ == 22 ) {
-    for ( unsigned int i=0; i<nResonances_; i++ ) {
-      if ( i == iTube )
-        lastFrame_[0] += tickResonance( filters_[i], input );
-      else
-        lastFrame_[0] += tickResonance( filters_[i], 0.0 );
-    }
-  }
-  else {
+    // Only the selected tube is excited.
     for ( unsigned int i=0; i<nResonances_; i++ )
-      lastFrame_[0] += tickResonance( filters_[i], input );
+      tubeInputs_[i] = 0.0;
+    tubeInputs_[iTube] = input;
+    lastFrame_[0] = filters_.tick( &tubeInputs_[0], currentGain_ );
   }
+  else
+    lastFrame_[0] = filters_.tick( input, currentGain_ );
 
   // Do final FIR filtering (lowpass or highpass)
   lastFrame_[0] = tickEqualize( lastFrame_[0] );
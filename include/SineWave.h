@@ -4,6 +4,7 @@
 const unsigned long TABLE_SIZE = 2048;
 
 #include "Generator.h"
+#include <cmath>
 
 namespace stk {
 
@@ -11,12 +12,18 @@ namespace stk {
 /*! \class SineWave
     \brief STK sinusoid oscillator class.
 
-    This class computes and saves a static sine "table" that can be
-    shared by multiple instances.  It has an interface similar to the
-    WaveLoop class but inherits from the Generator class.  Output
-    values are computed using linear interpolation.
+    This class computes and saves static sine "tables" that are
+    shared by all instances using the same table size.  It has an
+    interface similar to the FileLoop class but inherits from the
+    Generator class.  Output values are computed using linear
+    interpolation by default, or with cubic (Catmull-Rom) or no
+    interpolation (see setInterpolation()).
 
-    The "table" length, set in SineWave.h, is 2048 samples by default.
+    The table length must be a power of two.  It is 2048 samples by
+    default (TABLE_SIZE, set in SineWave.h) and can be set for each
+    instance.  The phase is a 32-bit fixed-point value whose highest
+    bits give the table index and lowest bits the interpolation
+    coefficient, so that it wraps around the table without a test.
 
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
@@ -25,8 +32,19 @@ namespace stk {
 class SineWave : public Generator
 {
 public:
-  //! Default constructor.
-  SineWave( void );
+  //! Interpolation methods for the table lookup.
+  enum Interpolation {
+    TRUNCATE,   /*!< No interpolation, use the table value before the phase. */
+    LINEAR,     /*!< Linear interpolation (default). */
+    CUBIC       /*!< Cubic (Catmull-Rom) interpolation. */
+  };
+
+  //! Default constructor, taking the table size (a power of two).
+  /*!
+    An StkError will be thrown if the table size is not a power of
+    two between 4 and 2^20.
+  */
+  SineWave( unsigned long tableSize = TABLE_SIZE );
 
   //! Class destructor.
   ~SineWave( void );
@@ -34,17 +52,32 @@ public:
   //! Clear output and reset time pointer to zero.
   void reset( void );
 
+  //! Set the table size, which must be a power of two between 4 and 2^20.
+  /*!
+    The frequency and phase of the oscillator are not changed.
+  */
+  void setTableSize( unsigned long tableSize );
+
+  //! Return the table size.
+  unsigned long getTableSize( void ) const { return tableSize_; };
+
+  //! Set the interpolation method for the table lookup (default = LINEAR).
+  void setInterpolation( Interpolation interpolation );
+
+  //! Return the interpolation method for the table lookup.
+  Interpolation getInterpolation( void ) const { return interpolation_; };
+
   //! Set the data read rate in samples.  The rate can be negative.
   /*!
     If the rate value is negative, the data is read in reverse order.
   */
-  void setRate( StkFloat rate ) { rate_ = rate; };
+  void setRate( StkFloat rate );
 
   //! Set the data interpolation rate based on a looping frequency.
   /*!
-    This function determines the interpolation rate based on the file
+    This function determines the interpolation rate based on the table
     size and the current Stk::sampleRate.  The \e frequency value
-    corresponds to file cycles per second.  The frequency can be
+    corresponds to table cycles per second.  The frequency can be
     negative, in which case the loop is read in reverse order.
    */
   void setFrequency( StkFloat frequency );
@@ -63,9 +96,10 @@ public:
   //! Add a normalized phase offset to the read pointer.
   /*!
     A \e phaseOffset = 1.0 corresponds to a 360 degree phase
-    offset.  Positive or negative values are possible.
+    offset.  Positive or negative values are possible.  The offset
+    replaces any previous offset value.
    */
-  void addPhaseOffset( StkFloat phaseOffset );
+  void addPhaseOffset( StkFloat phaseOffset ) { offset_ = toPhase( phaseOffset ); };
 
   //! Return the last computed output value.
   StkFloat lastOut( void ) const { return lastFrame_[0]; };
@@ -87,33 +121,58 @@ protected:
 
   void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
 
-  static StkFrames table_;
-  StkFloat time_;
-  StkFloat rate_;
-  StkFloat phaseOffset_;
-  unsigned int iIndex_;
-  StkFloat alpha_;
+  // Return the shared table of the given size, with one guard point
+  // before and two after for the interpolation.
+  static const StkFloat *getTable( unsigned long tableSize );
+
+  // Round a normalized phase to the fixed-point phase, modulo one cycle.
+  static UINT32 toPhase( double phase )
+  {
+    return (UINT32) (unsigned long long) ( ( phase - floor( phase ) ) * 4294967296.0 + 0.5 );
+  };
+
+  // Return the interpolated table value at a fixed-point phase.
+  StkFloat lookup( UINT32 phase ) const;
+
+  const StkFloat *table_;
+  unsigned long tableSize_;
+  Interpolation interpolation_;
+  unsigned int shift_;   // from the phase to the table index
+  UINT32 mask_;          // fractional part of the phase
+  StkFloat scale_;       // from the fractional part to 0.0 - 1.0
+
+  // The frequency is kept in double precision, even when StkFloat is
+  // single precision, to avoid frequency drift.
+  double cycles_;        // phase increment in cycles per sample
+  UINT32 phase_;
+  UINT32 increment_;
+  UINT32 offset_;
 
 };
 
+inline StkFloat SineWave :: lookup( UINT32 phase ) const
+{
+  UINT32 index = phase >> shift_;
+  StkFloat alpha = ( phase & mask_ ) * scale_;
+  const StkFloat *x = &table_[index];
+
+  switch ( interpolation_ ) {
+  case TRUNCATE:
+    return x[0];
+  case CUBIC:
+    return x[0] + 0.5 * alpha * ( x[1] - x[-1] + alpha * ( 2.0 * x[-1] - 5.0 * x[0] + 4.0 * x[1] - x[2]
+                                                           + alpha * ( 3.0 * ( x[0] - x[1] ) + x[2] - x[-1] ) ) );
+  default:
+    return x[0] + alpha * ( x[1] - x[0] );
+  }
+}
+
 inline StkFloat SineWave :: tick( void )
 {
-  // Check limits of time address ... if necessary, recalculate modulo
-  // TABLE_SIZE.
-  while ( time_ < 0.0 )
-    time_ += TABLE_SIZE;
-  while ( time_ >= TABLE_SIZE )
-    time_ -= TABLE_SIZE;
-
-  iIndex_ = (unsigned int) time_;
-  alpha_ = time_ - iIndex_;
-  StkFloat tmp = table_[ iIndex_ ];
-  tmp += ( alpha_ * ( table_[ iIndex_ + 1 ] - tmp ) );
-
-  // Increment time, which can be negative.
-  time_ += rate_;
-
-  lastFrame_[0] = tmp;
+  lastFrame_[0] = lookup( phase_ + offset_ );
+
+  // Increment the phase, which wraps around modulo one cycle.
+  phase_ += increment_;
   return lastFrame_[0];
 }
 
@@ -126,34 +185,44 @@ inline StkFrames& SineWave :: tick( StkFrames& frames, unsigned int channel )
   }
 #endif
 
+  // The loops use local copies of the state and select the
+  // interpolation method once for the whole block, so that the phase
+  // updates and the lookups of successive samples can overlap.
   StkFloat *samples = &frames[channel];
-  StkFloat tmp = 0.0;
-
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-
-    // Check limits of time address ... if necessary, recalculate modulo
-    // TABLE_SIZE.
-    while ( time_ < 0.0 )
-      time_ += TABLE_SIZE;
-    while ( time_ >= TABLE_SIZE )
-      time_ -= TABLE_SIZE;
-
-    iIndex_ = (unsigned int) time_;
-    alpha_ = time_ - iIndex_;
-    tmp = table_[ iIndex_ ];
-    tmp += ( alpha_ * ( table_[ iIndex_ + 1 ] - tmp ) );
-    *samples = tmp;
-
-    // Increment time, which can be negative.
-    time_ += rate_;
+  unsigned int nFrames = frames.frames();
+  if ( nFrames == 0 ) return frames;
+
+  const StkFloat *table = table_;
+  const unsigned int shift = shift_;
+  const UINT32 mask = mask_, increment = increment_;
+  const StkFloat scale = scale_;
+  UINT32 phase = phase_ + offset_;
+  unsigned int i;
+
+  switch ( interpolation_ ) {
+  case LINEAR:
+    for ( i=0; i<nFrames; i++, samples += hop, phase += increment ) {
+      const StkFloat *x = &table[phase >> shift];
+      StkFloat alpha = ( phase & mask ) * scale;
+      *samples = x[0] + alpha * ( x[1] - x[0] );
+    }
+    break;
+  case TRUNCATE:
+    for ( i=0; i<nFrames; i++, samples += hop, phase += increment )
+      *samples = table[phase >> shift];
+    break;
+  default:
+    for ( i=0; i<nFrames; i++, samples += hop, phase += increment )
+      *samples = lookup( phase );
+    break;
   }
 
-  lastFrame_[0] = tmp;
+  phase_ = phase - offset_;
+  lastFrame_[0] = *( samples - hop );
   return frames;
 }
 
 } // stk namespace
 
 #endif
-
@@ -123,11 +123,20 @@ inline StkFrames& SingWave :: tick( StkFrames& frames, unsigned int channel )
   }
 #endif
 
+  // Compute the modulations for the whole block in place, then
+  // replace them with the output samples.
+  modulator_.tick( frames, channel );
+
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop )
-    *samples = SingWave::tick();
+  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
+    StkFloat newRate = pitchEnvelope_.tick();
+    newRate += newRate * *samples;
+    wave_.setRate( newRate );
+    *samples = wave_.tick() * envelope_.tick();
+  }
 
+  if ( frames.frames() ) lastFrame_[0] = *(samples-hop);
   return frames;
 }
 
@@ -39,18 +39,25 @@ class Skini : public Stk
 {
  public:
 
+  //! The maximum length of the ascii text in a Message remainder, including the terminating null character.
+  static const unsigned int REMAINDER_SIZE = 128;
+
   //! A message structure to store and pass parsed SKINI messages.
+  /*!
+    The structure has a fixed size and holds no pointers, so
+    messages can be copied and queued without memory allocation.
+  */
   struct Message { 
     long type;                         /*!< The message type, as defined in SKINImsg.h. */
     long channel;                      /*!< The message channel (not limited to 16!). */
     StkFloat time;                     /*!< The message time stamp in seconds (delta or absolute). */
-    std::vector<StkFloat> floatValues; /*!< The message values read as floats (values are type-specific). */
-    std::vector<long> intValues;       /*!< The message values read as ints (number and values are type-specific). */
-    std::string remainder;             /*!< Any remaining message data, read as ascii text. */
+    StkFloat floatValues[2];           /*!< The message values read as floats (values are type-specific). */
+    long intValues[2];                 /*!< The message values read as ints (number and values are type-specific). */
+    char remainder[REMAINDER_SIZE];    /*!< Any remaining message data, read as null-terminated ascii text (truncated if necessary). */
 
     // Default constructor.
     Message()
-      :type(0), channel(0), time(0.0), floatValues(2), intValues(2) {}
+      :type(0), channel(0), time(0.0), floatValues(), intValues(), remainder() {}
   };
 
   //! Default constructor.
@@ -82,6 +89,14 @@ class Skini : public Stk
   */
   long parseString( std::string& line, Skini::Message& message );
 
+  //! Attempt to parse the given null-terminated string and returning the message type.
+  /*!
+    The line is parsed in place, without memory allocation.  A type
+    value equal to zero in the referenced message structure indicates
+    an invalid message.
+  */
+  long parseString( const char *line, Skini::Message& message );
+
   //! Return the SKINI type string for the given type value.
   static std::string whatsThisType(long type);
 
@@ -90,9 +105,21 @@ class Skini : public Stk
 
  protected:
 
-  void tokenize( const std::string& str, std::vector<std::string>& tokens, const std::string& delimiters );
+  // A token of a parsed line, which is not null-terminated.
+  struct Token {
+    const char *begin;
+    size_t length;
+  };
+
+  // Split a line at the given delimiters into at most maxTokens
+  // tokens, returning the number of tokens found.
+  static unsigned int tokenize( const char *line, Token *tokens, unsigned int maxTokens, const char *delimiters );
+
+  // Return the index into the message table of the given message name, or -1.
+  static int findMessage( const Token& name );
 
   std::ifstream file_;
+  std::string line_;
 };
 
 //! A static table of equal-tempered MIDI to frequency (Hz) values.
@@ -7,7 +7,9 @@
 #include <sstream>
 #include <vector>
 #include <stdexcept>
+#include <atomic>
 //#include <cstdlib>
+#include "BoundedQueue.h"
 
 /*! \namespace stk
     \brief The STK namespace.
@@ -23,7 +25,9 @@ namespace stk {
 
     Nearly all STK classes inherit from this class.
     The global sample rate and rawwave path variables
-    can be queried and modified via Stk.  In addition,
+    can be queried and modified via Stk.  The sample
+    rate can also be set per thread with a
+    RenderContext.  In addition,
     this class provides error handling and
     byte-swapping functions.
 
@@ -72,10 +76,16 @@ namespace stk {
 //#define _STK_DEBUG_
 
 // Most data in STK is passed and calculated with the
-// following user-definable floating-point type.  You
-// can change this to "float" if you prefer or perhaps
-// a "long double" in the future.
+// following user-definable floating-point type.  Define
+// __STK_FLOAT32__ (the STK_FLOAT32 CMake option or the
+// --enable-float32 configure option) to use "float"
+// throughout.  The library and all code using it must
+// be compiled with the same setting.
+#if defined(__STK_FLOAT32__)
+typedef float StkFloat;
+#else
 typedef double StkFloat;
+#endif
 
 //! STK error handling class.
 /*!
@@ -132,6 +142,44 @@ public:
 };
 
 
+class ErrorLog;
+
+// A fixed-size message stream used by the error reporting functions,
+// so that formatting a message does not allocate memory.  Messages
+// longer than MESSAGE_SIZE - 1 characters are truncated.
+class StkMessageStream : public std::ostream
+{
+public:
+  static const unsigned int MESSAGE_SIZE = 512;
+
+  StkMessageStream( void ) : std::ostream( &buffer_ ) {}
+
+  // Return the null-terminated message.
+  const char *message( void ) { return buffer_.message(); }
+
+  // Return a copy of the message.
+  std::string str( void ) { return std::string( buffer_.message() ); }
+
+  // Discard the message.  Its characters remain valid until the next
+  // write to the stream.
+  void reset( void ) { buffer_.reset(); this->clear(); }
+
+private:
+  class Buffer : public std::streambuf
+  {
+  public:
+    Buffer( void ) { this->reset(); }
+    const char *message( void ) { *pptr() = '\0'; return data_; }
+    void reset( void ) { setp( data_, data_ + MESSAGE_SIZE - 1 ); }
+  protected:
+    int_type overflow( int_type c ) { return traits_type::not_eof( c ); }
+  private:
+    char data_[MESSAGE_SIZE];
+  };
+
+  Buffer buffer_;
+};
+
 class Stk
 {
 public:
@@ -145,7 +193,11 @@ public:
   static const StkFormat STK_FLOAT64; /*!< Normalized between plus/minus 1.0. */
 
   //! Static method that returns the current STK sample rate.
-  static StkFloat sampleRate( void ) { return srate_; }
+  /*!
+    This is the sample rate of the RenderContext which is current on
+    the calling thread, if any, or else the global sample rate.
+  */
+  static StkFloat sampleRate( void );
 
   //! Static method that sets the STK sample rate.
   /*!
@@ -163,7 +215,10 @@ public:
     is called do not currently receive the automatic notification of
     rate change.  If the user wants a specific class instance to
     ignore such notifications, perhaps in a multi-rate context, the
-    function Stk::ignoreSampleRateChange() should be called.
+    function Stk::ignoreSampleRateChange() should be called.  Objects
+    created while a RenderContext is current have a fixed rate and
+    are not notified.  The global rate is not used on threads with a
+    current RenderContext.
   */
   static void setSampleRate( StkFloat rate );
 
@@ -204,11 +259,31 @@ public:
   }
 
   //! Static function for error reporting and handling using c-strings.
+  /*!
+    Errors of other types than WARNING, STATUS and DEBUG_PRINT throw
+    an StkError exception.  If an ErrorLog is set, all messages are
+    pushed to it instead of being written to std::cerr.
+  */
   static void handleError( const char *message, StkError::Type type );
 
   //! Static function for error reporting and handling using c++ strings.
   static void handleError( std::string message, StkError::Type type );
 
+  //! Send error messages to an ErrorLog instead of std::cerr, or to std::cerr if \e log is NULL.
+  /*!
+    With a log, reporting a warning neither allocates memory nor
+    takes a lock, so that it can be done on realtime threads, and the
+    messages are written or otherwise handled later by another thread
+    (see ErrorLog::print()).  Messages of errors which throw an
+    exception are also pushed to the log.  The log must be set before
+    other threads report errors and must exist for as long as it is
+    set.
+  */
+  static void setErrorLog( ErrorLog *log ) { errorLog_ = log; }
+
+  //! Return the ErrorLog which receives error messages, or NULL if there is none.
+  static ErrorLog *errorLog( void ) { return errorLog_; }
+
   //! Toggle display of WARNING and STATUS messages.
   static void showWarnings( bool status ) { showWarnings_ = status; }
 
@@ -221,10 +296,14 @@ private:
   static bool showWarnings_;
   static bool printErrors_;
   static std::vector<Stk *> alertList_;
+  static ErrorLog *errorLog_;
 
 protected:
 
-  static std::ostringstream oStream_;
+  // Each thread has its own fixed-size message stream, so that
+  // objects used on different threads can report errors concurrently
+  // and without allocating memory.
+  static thread_local StkMessageStream oStream_;
   bool ignoreSampleRateChange_;
 
   //! Default constructor.
@@ -237,13 +316,17 @@ protected:
   virtual void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
 
   //! Add class pointer to list for sample rate change notification.
+  /*!
+    This function and removeSampleRateAlert() are thread-safe, so
+    that objects can be created and destroyed on several threads.
+  */
   void addSampleRateAlert( Stk *ptr );
 
   //! Remove class pointer from list for sample rate change notification.
   void removeSampleRateAlert( Stk *ptr );
 
   //! Internal function for error reporting that assumes message in \c oStream_ variable.
-  void handleError( StkError::Type type ) const;
+  static void handleError( StkError::Type type );
 };
 
 
@@ -615,6 +698,149 @@ const unsigned int RT_BUFFER_SIZE = 512;
   #define RAWWAVE_PATH "../../rawwaves/"
 #endif
 
+/***************************************************/
+/*! \class ErrorLog
+    \brief STK lock-free error and warning message log.
+
+    This class implements a bounded, lock-free queue of error
+    messages (a BoundedQueue), which can be pushed by any number of
+    threads and are read by one thread.  When an ErrorLog is set with
+    Stk::setErrorLog(), the messages reported by all STK objects are
+    pushed to it instead of being written to std::cerr, so that
+    objects running on realtime audio threads can report warnings
+    without taking locks or allocating memory.  Another thread, such
+    as the main or user interface thread, periodically calls print()
+    or pop() to handle the messages.
+
+    Each entry holds the StkError::Type of the message, which serves
+    as its error code, the time at which it was pushed and the message
+    text, truncated to MESSAGE_SIZE - 1 characters.  When the log is
+    full, new messages are dropped and counted.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class ErrorLog
+{
+ public:
+  //! The maximum message size, including the terminating null character.
+  static const unsigned int MESSAGE_SIZE = StkMessageStream::MESSAGE_SIZE;
+
+  //! A logged message.
+  struct Entry {
+    StkError::Type type;               /*!< The message type (error code). */
+    double timeStamp;                  /*!< The time at which the message was pushed (in seconds, on a monotonic clock). */
+    char message[MESSAGE_SIZE];        /*!< The null-terminated message text. */
+  };
+
+  //! Default constructor.
+  /*!
+    The capacity is rounded up to the next power of two messages.
+  */
+  ErrorLog( unsigned long nMessages = 64 );
+
+  //! Class destructor.
+  ~ErrorLog( void );
+
+  //! Return the log capacity in messages.
+  unsigned long capacity( void ) const { return queue_.capacity(); };
+
+  //! Push a message, returning \c false if the log is full.
+  /*!
+    This function can be called concurrently by any number of
+    threads.  It neither blocks, locks nor allocates memory.
+  */
+  bool push( const char *message, StkError::Type type );
+
+  //! Pop the oldest message, returning \c false if the log is empty.
+  /*!
+    Must only be called by one thread at a time.
+  */
+  bool pop( Entry& entry );
+
+  //! Pop all messages and write them to the given stream, returning the number of messages written.
+  /*!
+    The number of dropped messages since the last call is also
+    written, if any.  Must only be called by one thread at a time.
+  */
+  unsigned long print( std::ostream& stream = std::cerr );
+
+  //! Return the number of messages dropped because the log was full, since instantiation.
+  unsigned long getOverrunCount( void ) const { return queue_.getOverrunCount(); };
+
+ protected:
+
+  BoundedQueue<Entry> queue_;
+  unsigned long printedOverruns_;
+};
+
+/***************************************************/
+/*! \class RenderContext
+    \brief STK render context class.
+
+    A render context holds the fixed sample rate and the block size of
+    a synthesis engine.  While a RenderContext::Scope object exists
+    for a context on a thread, Stk::sampleRate() returns the context
+    rate on that thread, so that the STK objects created and used
+    there run at that rate.  Engines at different rates can thus be
+    rendered concurrently on different threads without changing the
+    global sample rate.  Objects created within a scope are not
+    registered for global sample rate change notifications.  Scopes
+    can be nested.
+
+    An object should only be used on threads where its own context is
+    current, since some classes query the sample rate when their
+    parameters are set.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class RenderContext
+{
+public:
+
+  //! Make a render context current on the calling thread for the lifetime of the Scope object.
+  class Scope
+  {
+  public:
+    //! The constructor makes the context current.
+    Scope( const RenderContext& context );
+
+    //! The destructor restores the previously current context.
+    ~Scope( void );
+
+  private:
+    Scope( const Scope& ) = delete;
+    Scope& operator=( const Scope& ) = delete;
+    const RenderContext *previous_;
+  };
+
+  //! The constructor takes a positive sample rate and block size.
+  RenderContext( StkFloat sampleRate = SRATE, unsigned int blockSize = RT_BUFFER_SIZE );
+
+  //! Return the sample rate of the context.
+  StkFloat sampleRate( void ) const { return sampleRate_; }
+
+  //! Return the number of frames computed at a time in the context.
+  unsigned int blockSize( void ) const { return blockSize_; }
+
+  //! Return the render context which is current on the calling thread, or NULL if there is none.
+  static const RenderContext *current( void ) { return current_; }
+
+private:
+  StkFloat sampleRate_;
+  unsigned int blockSize_;
+  static thread_local const RenderContext *current_;
+};
+
+inline StkFloat Stk :: sampleRate( void )
+{
+  const RenderContext *context = RenderContext::current();
+  return context ? context->sampleRate() : srate_;
+}
+
 const StkFloat PI           = 3.14159265358979;
 const StkFloat TWO_PI       = 2 * PI;
 const StkFloat ONE_OVER_128 = 0.0078125;
@@ -3,6 +3,12 @@
 
 #include "Instrmnt.h"
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace stk {
 
@@ -25,7 +31,14 @@ namespace stk {
     noteOn returns a unique tag (credits to the NeXT MusicKit), so you
     can send control changes to specific voices within an ensemble.
     Alternately, control changes can be sent to all voices in a given
-    group.
+    group.  Note tags and (group, note number) pairs are indexed and
+    each group keeps a free-voice heap and an age-ordered voice list,
+    so that noteOn() and the per-voice control functions do not need
+    to scan the whole voice pool.
+
+    The StkFrames tick() function can optionally render the sounding
+    voices in parallel on a fixed pool of worker threads (see
+    setRenderThreads()).
 
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
@@ -37,6 +50,9 @@ class Voicer : public Stk
   //! Class constructor taking an optional note decay time (in seconds).
   Voicer( StkFloat decayTime = 0.2 );
 
+  //! Class destructor.
+  ~Voicer( void );
+
   //! Add an instrument with an optional group number to the voice manager.
   /*!
     A set of instruments can be grouped by group number and
@@ -102,6 +118,25 @@ class Voicer : public Stk
   //! Send a noteOff message to all existing voices.
   void silence( void );
 
+  //! Set the number of threads used by the StkFrames tick() function (default = 1).
+  /*!
+    With a value greater than one, \e nThreads - 1 worker threads are
+    started and the sounding voices of each block are distributed
+    over the workers and the calling thread, with idle threads
+    stealing voices from busy ones to balance expensive and cheap
+    instruments.  Each voice renders into its own buffer and the
+    buffers are mixed in voice order on the calling thread, so the
+    output is bit-identical to the serial mode as long as the
+    instruments do not share state with each other.  No memory is
+    allocated and no locks are contended in the tick() function.  This
+    function must not be called while another thread is ticking the
+    voice manager.
+  */
+  void setRenderThreads( unsigned int nThreads );
+
+  //! Return the number of threads used by the StkFrames tick() function.
+  unsigned int getRenderThreads( void ) const { return (unsigned int) workers_.size() + 1; };
+
   //! Return the current number of output channels.
   unsigned int channelsOut( void ) const { return lastFrame_.channels(); };
 
@@ -132,12 +167,16 @@ class Voicer : public Stk
 
   //! Fill the StkFrames argument with computed frames and return the same reference.
   /*!
-    The number of channels in the StkFrames argument must equal
-    the number of channels in the file data.  However, this is only
-    checked if _STK_DEBUG_ is defined during compilation, in which
-    case an incompatibility will trigger an StkError exception.  If no
-    file data is loaded, the function does nothing (a warning will be
-    issued if _STK_DEBUG_ is defined during compilation).
+    Each sounding voice is rendered once for the whole block with
+    its instrument's StkFrames tick() function and then mixed into
+    the output, so the cost scales with the number of sounding voices
+    rather than the size of the voice pool.  The result is identical
+    to calling the single-frame tick() function for each frame.  The
+    \c channel argument plus the number of output channels must be
+    less than the number of channels in the StkFrames argument (the
+    first channel is specified by 0).  However, range checking is only
+    performed if _STK_DEBUG_ is defined during compilation, in which
+    case an out-of-range value will trigger an StkError exception.
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
@@ -150,16 +189,76 @@ class Voicer : public Stk
     StkFloat frequency;
     int sounding;
     int group;
+    unsigned int groupIndex; // index into groups_
+    int older;               // neighbours in the group's age-ordered list
+    int newer;
+    StkFloat indexedNote;    // note number under which the voice is in noteIndex_
 
     // Default constructor.
     Voice()
-      :instrument(0), tag(0), noteNumber(-1.0), frequency(0.0), sounding(0), group(0) {}
+      :instrument(0), tag(0), noteNumber(-1.0), frequency(0.0), sounding(0), group(0),
+       groupIndex(0), older(-1), newer(-1), indexedNote(-1.0) {}
+  };
+
+  struct VoiceGroup {
+    std::vector<unsigned int> freeVoices; // min-heap of free voice indices
+    int oldest;                           // head of the age-ordered list
+    int newest;                           // tail of the age-ordered list
+
+    // Default constructor.
+    VoiceGroup()
+      :oldest(-1), newest(-1) {}
+  };
+
+  // A contiguous range of render tasks owned by one thread.  The
+  // next and end task indices are packed with the block generation
+  // in a single word, which is replaced as a whole for each block, so
+  // that a late thread can never claim a task of a newer block.
+  struct TaskRange {
+    std::atomic<unsigned long long> tasks;  // generation | end | next
+    char pad[64 - sizeof(std::atomic<unsigned long long>)];
   };
 
+  // Bits of the task indices in a TaskRange word.
+  static const unsigned int TASK_BITS = 20;
+  static const unsigned long long TASK_MASK = ( 1ULL << TASK_BITS ) - 1;
+
+  void activateVoice( unsigned int index );
+  void releaseVoice( unsigned int index );
+  int findVoice( long tag ) const;
+  void indexNote( unsigned int index, StkFloat noteNumber );
+  void makeNewest( unsigned int index );
+  void rebuildIndex( void );
+  void renderVoice( unsigned int task );
+  void mixFrames( StkFrames& voiceFrames, StkFrames& frames, unsigned int channel, unsigned int nFrames );
+  void renderParallel( unsigned int nTasks );
+  void runTasks( unsigned int thread, unsigned long long generation );
+  void workerLoop( unsigned int thread );
+  void stopWorkers( void );
+
   std::vector<Voice> voices_;
+  std::vector<unsigned int> soundingVoices_; // sorted indices of voices with sounding != 0
+  std::vector<VoiceGroup> groups_;
+  std::map<int, unsigned int> groupIndex_;
+  std::unordered_map<long, unsigned int> tagIndex_;
+  std::multimap<std::pair<int, StkFloat>, unsigned int> noteIndex_;
   long tags_;
   int muteTime_;
   StkFrames lastFrame_;
+
+  // Per-task render buffers and lengths (one per voice).
+  std::vector<StkFrames> voiceFrames_;
+  std::vector<unsigned int> voiceLengths_;
+
+  // Parallel rendering state.
+  std::vector<std::thread> workers_;
+  TaskRange *ranges_;
+  std::atomic<unsigned long long> generation_;
+  std::atomic<unsigned int> pending_;
+  std::atomic<int> sleepers_;
+  std::atomic<bool> quit_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
 };
 
 inline StkFloat Voicer :: lastOut( unsigned int channel )
@@ -177,43 +276,26 @@ inline StkFloat Voicer :: lastOut( unsigned int channel )
 
 inline StkFloat Voicer :: tick( unsigned int channel )
 {
-  unsigned int j;
+  unsigned int j, k = 0;
   for ( j=0; j<lastFrame_.channels(); j++ ) lastFrame_[j] = 0.0;
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].sounding != 0 ) {
-      voices_[i].instrument->tick();
-      for ( j=0; j<voices_[i].instrument->channelsOut(); j++ ) lastFrame_[j] += voices_[i].instrument->lastOut( j );
+  for ( unsigned int i=0; i<soundingVoices_.size(); i++ ) {
+    Voicer::Voice& voice = voices_[ soundingVoices_[i] ];
+    if ( voice.sounding != 0 ) {
+      voice.instrument->tick();
+      for ( j=0; j<voice.instrument->channelsOut(); j++ ) lastFrame_[j] += voice.instrument->lastOut( j );
     }
-    if ( voices_[i].sounding < 0 )
-      voices_[i].sounding++;
-    if ( voices_[i].sounding == 0 )
-      voices_[i].noteNumber = -1;
+    if ( voice.sounding < 0 )
+      voice.sounding++;
+    if ( voice.sounding == 0 )
+      this->releaseVoice( soundingVoices_[i] );
+    else
+      soundingVoices_[k++] = soundingVoices_[i];
   }
+  soundingVoices_.resize( k );
 
   return lastFrame_[channel];
 }
 
-inline StkFrames& Voicer :: tick( StkFrames& frames, unsigned int channel )
-{
-  unsigned int nChannels = lastFrame_.channels();
-#if defined(_STK_DEBUG_)
-  if ( channel > frames.channels() - nChannels ) {
-    oStream_ << "Voicer::tick(): channel and StkFrames arguments are incompatible!";
-    handleError( StkError::FUNCTION_ARGUMENT );
-  }
-#endif
-
-  StkFloat *samples = &frames[channel];
-  unsigned int j, hop = frames.channels() - nChannels;
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    tick();
-    for ( j=0; j<nChannels; j++ )
-      *samples++ = lastFrame_[j];
-  }
-
-  return frames;
-}
-
 } // stk namespace
 
 #endif
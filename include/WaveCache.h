@@ -0,0 +1,91 @@
+#ifndef STK_WAVECACHE_H
+#define STK_WAVECACHE_H
+
+#include "Stk.h"
+#include <memory>
+
+namespace stk {
+
+/***************************************************/
+/*! \class WaveCache
+    \brief STK process-wide cache of audio file data.
+
+    This class keeps a single, read-only copy of the sample data of
+    each audio file that has been completely loaded into memory, so
+    that instruments which use the same rawwaves (for example, many
+    Rhodey or Moog voices in a Voicer) share their wavetables rather
+    than each opening, reading and normalizing the file again.  Memory
+    use is thus proportional to the number of unique files, and
+    instrument construction after the first one does not touch the
+    file data.
+
+    Entries are keyed on the file name and on a caller-defined
+    \e variant value that identifies how the data was loaded (raw
+    format, normalization, scaling, etc.).  Before an entry is
+    returned, the modification time and size of the file are checked
+    so that a file which has changed on disk is loaded again.  The
+    data is handed out as a shared pointer to a constant StkFrames
+    object, which remains valid for as long as some instance holds a
+    reference to it, even after the entry is removed from the cache.
+
+    All functions are static and thread-safe.  The cache is used by
+    the FileWvIn and FileLoop classes and is enabled by default.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class WaveCache : public Stk
+{
+ public:
+  //! Enable or disable use of the cache for subsequently opened files (default = enabled).
+  static void setEnabled( bool enabled );
+
+  //! Return whether the cache is enabled.
+  static bool isEnabled( void );
+
+  //! Return the cached data for the given file and variant, or an empty pointer if not cached.
+  /*!
+    Each call counts as a cache hit or miss.  An entry for a file
+    whose modification time or size has changed since it was cached
+    is discarded and reported as a miss.
+  */
+  static std::shared_ptr<const StkFrames> find( const std::string& fileName, unsigned int variant );
+
+  //! Add data for the given file and variant to the cache and return the cached data.
+  /*!
+    If another thread has already cached data for the same file and
+    variant, that data is returned and \c frames is discarded.
+  */
+  static std::shared_ptr<const StkFrames> insert( const std::string& fileName, unsigned int variant,
+                                                  const std::shared_ptr<const StkFrames>& frames );
+
+  //! Remove all entries from the cache.
+  /*!
+    Data currently in use by an instance remains valid until that
+    instance releases it.
+  */
+  static void clear( void );
+
+  //! Remove the entries which are not currently in use by any instance.
+  static void purge( void );
+
+  //! Return the number of cache hits since program start or the last resetStatistics().
+  static unsigned long getHitCount( void );
+
+  //! Return the number of cache misses since program start or the last resetStatistics().
+  static unsigned long getMissCount( void );
+
+  //! Return the number of cached files.
+  static unsigned long getEntryCount( void );
+
+  //! Return the total size of the cached data in bytes.
+  static unsigned long getMemoryUsage( void );
+
+  //! Reset the hit and miss counters to zero.
+  static void resetStatistics( void );
+};
+
+} // stk namespace
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef STK_WAVETABLE_H
+#define STK_WAVETABLE_H
+
+#include "Generator.h"
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class WaveTable
+    \brief STK band-limited wavetable oscillator class.
+
+    This class generates band-limited sawtooth, square, triangle and
+    impulse train waveforms by reading precomputed tables, which
+    costs one linearly interpolated table lookup per sample.  Each
+    waveform is stored as a set of tables, one for each octave of the
+    fundamental frequency (mipmaps), containing 1, 2, 4 ... 1024
+    harmonics.  The table with the most harmonics which are all below
+    half the sample rate is used for the current frequency, so that
+    the signal contains no aliasing.  Since the number of harmonics
+    changes by octaves, the highest harmonics are up to one octave
+    below half the sample rate.
+
+    The tables are computed with an inverse FFT when a waveform is
+    first used, and are shared by all instances.  Each table is
+    oversampled by a factor of at least eight relative to its highest
+    harmonic, which keeps the interpolation error small.  The phase
+    is a 32-bit fixed-point value, which wraps around without a test.
+
+    The sawtooth, square and triangle waveforms have a nominal peak
+    value of +/-1.0 (with the overshoot of the band-limited
+    discontinuities), the sawtooth falls linearly within each period
+    like that of the BlitSaw class, and the impulse train is
+    normalized to a peak value of 1.0 like that of the Blit class.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+class WaveTable : public Generator
+{
+ public:
+  //! Waveform shapes.
+  enum Shape {
+    SAWTOOTH,   /*!< Falling sawtooth wave. */
+    SQUARE,     /*!< Square wave (odd harmonics). */
+    TRIANGLE,   /*!< Triangle wave (odd harmonics). */
+    IMPULSE     /*!< Impulse train. */
+  };
+
+  //! Class constructor, taking the waveform shape and the frequency in Hz.
+  WaveTable( Shape shape = SAWTOOTH, StkFloat frequency = 220.0 );
+
+  //! Class destructor.
+  ~WaveTable( void );
+
+  //! Resets the phase to 0.
+  void reset( void );
+
+  //! Set the waveform shape.
+  void setShape( Shape shape );
+
+  //! Return the waveform shape.
+  Shape getShape( void ) const { return shape_; };
+
+  //! Set the oscillator frequency in Hz.
+  void setFrequency( StkFloat frequency );
+
+  //! Set the maximal number of harmonics generated in the signal.
+  /*!
+    The number of harmonics is rounded down to a power of two and
+    limited by half the sample rate.  The default value of 0 gives
+    the maximal number of harmonics below half the sample rate.
+  */
+  void setHarmonics( unsigned int nHarmonics = 0 );
+
+  //! Set the phase of the signal, in the range 0 to 1.
+  void setPhase( StkFloat phase );
+
+  //! Return the phase of the signal, in the range [0 to 1.0).
+  StkFloat getPhase( void ) const { return phase_ * ONE_OVER_PHASE; };
+
+  //! Return the last computed output value.
+  StkFloat lastOut( void ) const { return lastFrame_[0]; };
+
+  //! Compute and return one output sample.
+  StkFloat tick( void );
+
+  //! Fill a channel of the StkFrames object with computed outputs.
+  /*!
+    The \c channel argument must be less than the number of
+    channels in the StkFrames argument (the first channel is specified
+    by 0).  However, range checking is only performed if _STK_DEBUG_
+    is defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+ protected:
+
+  void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
+
+  // The tables of level k contain 2^k harmonics.
+  static const unsigned int LEVELS = 11;
+
+  // One over the phase range of 2^32.
+  static const StkFloat ONE_OVER_PHASE;
+
+  struct Table {
+    Table( Shape shape );
+    std::vector<StkFloat> levels[LEVELS];  // with a guard point
+  };
+
+  static const Table& getTable( Shape shape );
+
+  // Select the table for the current frequency and harmonics.
+  void updateLevel( void );
+
+  Shape shape_;
+  const Table *table_;
+  const StkFloat *data_;
+  StkFloat frequency_;
+  unsigned int nHarmonics_;
+
+  UINT32 phase_;
+  UINT32 increment_;
+  unsigned int shift_;   // from the phase to the table index
+  UINT32 mask_;          // fractional part of the phase
+  StkFloat scale_;       // from the fractional part to 0.0 - 1.0
+
+};
+
+inline StkFloat WaveTable :: tick( void )
+{
+  // Interpolate linearly between the table values on each side of
+  // the phase.
+  UINT32 index = phase_ >> shift_;
+  StkFloat alpha = ( phase_ & mask_ ) * scale_;
+  lastFrame_[0] = data_[index] + alpha * ( data_[index+1] - data_[index] );
+
+  phase_ += increment_;
+  return lastFrame_[0];
+}
+
+inline StkFrames& WaveTable :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel >= frames.channels() ) {
+    oStream_ << "WaveTable::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *samples = &frames[channel];
+  unsigned int hop = frames.channels();
+  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop )
+    *samples = WaveTable::tick();
+
+  return frames;
+}
+
+} // stk namespace
+
+#endif
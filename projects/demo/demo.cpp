@@ -9,6 +9,7 @@
 #include "JCRev.h"
 #include "Voicer.h"
 #include "Skini.h"
+#include "EventScheduler.h"
 #include "RtAudio.h"
 
 #if defined(__STK_REALTIME__)
@@ -38,41 +39,38 @@ struct TickData {
   Voicer *voicer;
   JCRev reverb;
   Messager messager;
-  Skini::Message message;
+  EventScheduler scheduler;
   StkFloat volume;
   StkFloat t60;
   unsigned int nWvOuts;
   int nVoices;
   int currentVoice;
   int channels;
-  int counter;
   bool realtime;
   bool settling;
-  bool haveMessage;
   int frequency;
 
   // Default constructor.
   TickData()
     : wvout(0), instrument(0), voicer(0), volume(1.0), t60(0.75),
-      nWvOuts(0), nVoices(1), currentVoice(0), channels(2), counter(0),
-      realtime( false ), settling( false ), haveMessage( false ) {}
+      nWvOuts(0), nVoices(1), currentVoice(0), channels(2),
+      realtime( false ), settling( false ) {}
 };
 
-#define DELTA_CONTROL_TICKS 64 // default sample frames between control input checks
-
 // The processMessage() function encapsulates the handling of control
-// messages.  It can be easily relocated within a program structure
-// depending on the desired scheduling scheme.
-void processMessage( TickData* data )
+// messages.  It is called by the EventScheduler at the exact sample
+// frame of each message.
+void processMessage( const Skini::Message& message, void *userData )
 {
-  StkFloat value1 = data->message.floatValues[0];
-  StkFloat value2 = data->message.floatValues[1];
+  TickData *data = (TickData *) userData;
+  StkFloat value1 = message.floatValues[0];
+  StkFloat value2 = message.floatValues[1];
 
   // If only one instrument, allow messages from all channels to control it.
   //int group = 1;
-  //  if ( data->nVoices > 1 ) group = data->message.channel;
+  //  if ( data->nVoices > 1 ) group = message.channel;
 
-  switch( data->message.type ) {
+  switch( message.type ) {
 
   case __SK_Exit_:
     if ( data->settling == false ) goto settle;
@@ -100,9 +98,9 @@ void processMessage( TickData* data )
     else if (value1 == 50.0)
       data->voicer->controlChange( 128, value2 );
     else if (value1 == 51.0)
-      data->frequency = data->message.intValues[1];
+      data->frequency = message.intValues[1];
     else if (value1 == 52.0) {
-      data->frequency += ( data->message.intValues[1] << 7 );
+      data->frequency += ( message.intValues[1] << 7 );
       // Convert to a fractional MIDI note value
       StkFloat note = 12.0 * log( data->frequency / 220.0 ) / log( 2.0 ) + 57.0;
       data->voicer->setFrequency( note );
@@ -146,13 +144,14 @@ void processMessage( TickData* data )
 
   } // end of switch
 
-  data->haveMessage = false;
   return;
 
  settle:
-  // Exit and program change messages are preceeded with a short settling period.
+  // Exit and program change messages are preceeded with a short
+  // settling period, after which the scheduler dispatches the same
+  // message again.
   data->voicer->silence();
-  data->counter = (int) (0.3 * data->t60 * Stk::sampleRate());
+  data->scheduler.postpone( (unsigned long) (0.3 * data->t60 * Stk::sampleRate()) );
   data->settling = true;
 }
 
@@ -165,33 +164,25 @@ int tick( void *outputBuffer, void *inputBuffer, unsigned int nBufferFrames,
 {
   TickData *data = (TickData *) dataPointer;
   StkFloat sample, *samples = (StkFloat *) outputBuffer;
-  int counter, nTicks = (int) nBufferFrames;
-
-  while ( nTicks > 0 && !done ) {
-
-    if ( !data->haveMessage ) {
-      data->messager.popMessage( data->message );
-      if ( data->message.type > 0 ) {
-        data->counter = (long) (data->message.time * Stk::sampleRate());
-        data->haveMessage = true;
-      }
-      else
-        data->counter = DELTA_CONTROL_TICKS;
-    }
+  unsigned long counter, nTicks = nBufferFrames;
+
+  // Collect the control messages for this buffer.  Each one is
+  // processed at its own sample frame by the scheduler.
+  data->scheduler.pollMessages( data->messager, nTicks );
 
-    counter = min( nTicks, data->counter );
-    data->counter -= counter;
-    for ( int i=0; i<counter; i++ ) {
+  while ( nTicks > 0 ) {
+
+    // Process due control messages and compute the frames up to the next one.
+    counter = data->scheduler.dispatch( nTicks );
+    if ( done ) break;
+
+    for ( unsigned long i=0; i<counter; i++ ) {
       sample = data->volume * data->reverb.tick( data->voicer->tick() );
       for ( unsigned int j=0; j<data->nWvOuts; j++ ) data->wvout[j]->tick(sample);
       if ( data->realtime )
         for ( int k=0; k<data->channels; k++ ) *samples++ = sample;
-      nTicks--;
     }
-    if ( nTicks == 0 ) break;
-
-    // Process control messages.
-    if ( data->haveMessage ) processMessage( data );
+    nTicks -= counter;
   }
 
   return 0;
@@ -241,6 +232,7 @@ int main( int argc, char *argv[] )
   data.voicer = (Voicer *) new Voicer( 0.0 );
   for ( i=0; i<data.nVoices; i++ )
     data.voicer->addInstrument( data.instrument[i] );
+  data.scheduler.setHandler( &processMessage, (void *) &data );
 
   // Parse the command-line flags, instantiate WvOut objects, and
   // instantiate the input message controller (in utilities.cpp).
@@ -7,6 +7,7 @@
 #include "Sitar.h"
 #include "Tabla.h"
 #include "VoicDrum.h"
+#include "Noise.h"
 #include "Messager.h"
 #include "RtAudio.h"
 
@@ -19,10 +20,11 @@
 using std::min;
 using namespace stk;
 
+Noise noise;
+
 StkFloat float_random(StkFloat max) // Return random float between 0.0 and max
-{	
-  StkFloat temp = (StkFloat) (max * rand() / (RAND_MAX + 1.0) );
-  return temp;	
+{
+  return max * 0.5 * ( noise.tick() + 1.0 );
 }
 
 void usage(void) {
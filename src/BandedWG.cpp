@@ -63,10 +63,9 @@ BandedWG :: ~BandedWG( void )
 
 void BandedWG :: clear( void )
 {
-  for ( int i=0; i<nModes_; i++ ) {
+  for ( int i=0; i<nModes_; i++ )
     delay_[i].clear();
-    bandpass_[i].clear();
-  }
+  bandpass_.clear();
 }
 
 void BandedWG :: setPreset( int preset )
@@ -198,15 +197,17 @@ void BandedWG :: setFrequency( StkFloat frequency )
     }
     //	std::cerr << std::endl;
 
-    // Set the bandpass filter resonances
-    radius = 1.0 - PI * 32 / Stk::sampleRate(); //frequency_ * modes_[i] / Stk::sampleRate()/32;
-    if ( radius < 0.0 ) radius = 0.0;
-    bandpass_[i].setResonance(frequency * modes_[i], radius, true);
-
     delay_[i].clear();
-    bandpass_[i].clear();
   }
 
+  // Set the bandpass filter resonances.
+  bandpass_.resize( nModes_ );
+  bandpass_.clear();
+  radius = 1.0 - PI * 32 / Stk::sampleRate(); //frequency_ * modes_[i] / Stk::sampleRate()/32;
+  if ( radius < 0.0 ) radius = 0.0;
+  for (int i=0; i<nModes_; i++)
+    bandpass_.setResonance( i, frequency * modes_[i], radius, true );
+
   //int olen = (int)(delay_[0].getDelay());
   //strikePosition_ = (int)(strikePosition_*(length/modes_[0])/olen);
 }
@@ -288,12 +289,13 @@ StkFloat BandedWG :: tick( unsigned int )
     input = input/(StkFloat)nModes_;
   }
 
-  StkFloat data = 0.0;  
-  for ( k=0; k<nModes_; k++ ) {
-    bandpass_[k].tick(input + gains_[k] * delay_[k].lastOut());
-    delay_[k].tick(bandpass_[k].lastOut());
-    data += bandpass_[k].lastOut();
-  }
+  StkFloat inputs[MAX_BANDED_MODES];
+  for ( k=0; k<nModes_; k++ )
+    inputs[k] = input + gains_[k] * delay_[k].lastOut();
+
+  StkFloat data = bandpass_.tick( inputs );
+  for ( k=0; k<nModes_; k++ )
+    delay_[k].tick( bandpass_.lastOut(k) );
   
   //lastFrame_[0] = data * nModes_;
   lastFrame_[0] = data * 4;
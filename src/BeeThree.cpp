@@ -39,10 +39,9 @@ namespace stk {
 BeeThree :: BeeThree( void )
   : FM()
 {
-  // Concatenate the STK rawwave path to the rawwave files
-  for ( unsigned int i=0; i<3; i++ )
-    waves_[i] = new FileLoop( (Stk::rawwavePath() + "sinewave.raw").c_str(), true );
-  waves_[3] = new FileLoop( (Stk::rawwavePath() + "fwavblnk.raw").c_str(), true );
+  // The first three waves are sinusoids.  Concatenate the STK
+  // rawwave path to the rawwave file of the last one.
+  waves_[3]->openFile( Stk::rawwavePath() + "fwavblnk.raw" );
 
   this->setRatio( 0, 0.999 );
   this->setRatio( 1, 1.997 );
@@ -22,11 +22,12 @@ BiQuad :: BiQuad() : Filter()
   b_[0] = 1.0;
   a_[0] = 1.0;
   inputs_.resize( 3, 1, 0.0 );
-  outputs_.resize( 3, 1, 0.0 );
 
   K_ = 0.0;
   kSqr_ = 0.0;
   denom_ = 1.0;
+  y1_ = 0.0;
+  y2_ = 0.0;
 
   Stk::addSampleRateAlert( this );
 }
@@ -36,6 +37,15 @@ BiQuad :: ~BiQuad()
   Stk::removeSampleRateAlert( this );
 }
 
+void BiQuad :: clear( void )
+{
+  Filter::clear();
+  y1_ = 0.0;
+  y2_ = 0.0;
+  for ( unsigned int i=0; i<states_.size(); i++ )
+    states_[i] = 0.0;
+}
+
 void BiQuad :: setCoefficients( StkFloat b0, StkFloat b1, StkFloat b2, StkFloat a1, StkFloat a2, bool clearState )
 {
   b_[0] = b0;
@@ -179,4 +189,64 @@ void BiQuad :: setCommonFilterValues( StkFloat fc, StkFloat Q)
   a_[2] = (kSqr_ * Q - K_ + Q) * denom_;
 }
 
+void BiQuad :: setChannels( unsigned int nChannels )
+{
+  this->setStateChannels( nChannels );
+  states_.assign( 2 * channelsIn_, 0.0 );
+}
+
+void BiQuad :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return;
+
+  const StkFloat gain = gain_;
+  const double b0 = b_[0], b1 = b_[1], b2 = b_[2];
+  const StkFloat a1 = a_[1], a2 = a_[2];
+  unsigned long i;
+  if ( channelsIn_ == 1 ) {
+    StkFloat x, x1 = inputs_[1], x2 = inputs_[2];
+    double y, y1 = y1_, y2 = y2_;
+    for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+      x = gain * *input;
+      y = b0 * x + b1 * x1 + b2 * x2;
+      y -= a2 * y2 + a1 * y1;
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      *output = (StkFloat) y;
+    }
+
+    inputs_[0] = x1;
+    inputs_[1] = x1;
+    inputs_[2] = x2;
+    y1_ = y1;
+    y2_ = y2;
+    lastFrame_[0] = (StkFloat) y1;
+    return;
+  }
+
+  const unsigned int nChannels = channelsIn_;
+  StkFloat *x1 = &inputs_[nChannels];
+  StkFloat *x2 = &inputs_[2 * nChannels];
+  double *y1 = &states_[0];
+  double *y2 = &states_[nChannels];
+  unsigned int j;
+  for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+    for ( j=0; j<nChannels; j++ ) {
+      StkFloat x = gain * input[j];
+      double y = b0 * x + b1 * x1[j] + b2 * x2[j];
+      y -= a2 * y2[j] + a1 * y1[j];
+      x2[j] = x1[j];
+      x1[j] = x;
+      y2[j] = y1[j];
+      y1[j] = y;
+      output[j] = (StkFloat) y;
+    }
+  }
+
+  for ( j=0; j<nChannels; j++ )
+    lastFrame_[j] = (StkFloat) y1[j];
+}
+
 } // stk namespace
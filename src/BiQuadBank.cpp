@@ -0,0 +1,129 @@
+/***************************************************/
+/*! \class BiQuadBank
+    \brief STK bank of parallel biquad filter sections.
+
+    This class implements a set of independent two-pole, two-zero
+    filter sections that are ticked together, as used for the modal
+    resonators of the Modal, BandedWG and Shakers classes.  The
+    coefficients and states of all sections are stored in
+    structure-of-arrays form so that the per-section update can be
+    vectorized by the compiler.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "BiQuadBank.h"
+#include <cmath>
+
+namespace stk {
+
+BiQuadBank :: BiQuadBank( unsigned int nSections )
+  : nSections_( 0 ), nPadded_( 0 ), lastOut_( 0.0 )
+{
+  this->resize( nSections );
+}
+
+BiQuadBank :: ~BiQuadBank()
+{
+}
+
+void BiQuadBank :: resize( unsigned int nSections )
+{
+  if ( nSections == nSections_ && !data_.empty() ) return;
+
+  unsigned int nPadded = ( nSections + 3 ) & ~3u;
+  std::vector<double> data( N_ARRAYS * nPadded, 0.0 );
+
+  // Existing sections keep their coefficients and states.  New
+  // sections default to pass-through, while the padding sections keep
+  // zero gain and coefficients, so they stay silent.
+  unsigned int nKeep = ( nSections < nSections_ ) ? nSections : nSections_;
+  for ( unsigned int j=0; j<N_ARRAYS; j++ ) {
+    for ( unsigned int i=0; i<nKeep; i++ )
+      data[j * nPadded + i] = data_[j * nPadded_ + i];
+  }
+  for ( unsigned int i=nKeep; i<nSections; i++ ) {
+    data[GAIN * nPadded + i] = 1.0;
+    data[B0 * nPadded + i] = 1.0;
+  }
+
+  data_.swap( data );
+  nSections_ = nSections;
+  nPadded_ = nPadded;
+}
+
+void BiQuadBank :: clear( void )
+{
+  for ( unsigned int i=X1*nPadded_; i<data_.size(); i++ )
+    data_[i] = 0.0;
+  lastOut_ = 0.0;
+}
+
+void BiQuadBank :: setCoefficients( unsigned int index, StkFloat b0, StkFloat b1, StkFloat b2, StkFloat a1, StkFloat a2, bool clearState )
+{
+#if defined(_STK_DEBUG_)
+  if ( index >= nSections_ ) {
+    oStream_ << "BiQuadBank::setCoefficients: index argument (" << index << ") is out of range!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  data_[B0 * nPadded_ + index] = b0;
+  data_[B1 * nPadded_ + index] = b1;
+  data_[B2 * nPadded_ + index] = b2;
+  data_[A1 * nPadded_ + index] = a1;
+  data_[A2 * nPadded_ + index] = a2;
+
+  if ( clearState ) {
+    data_[X1 * nPadded_ + index] = 0.0;
+    data_[X2 * nPadded_ + index] = 0.0;
+    data_[Y1 * nPadded_ + index] = 0.0;
+    data_[Y2 * nPadded_ + index] = 0.0;
+  }
+}
+
+void BiQuadBank :: setResonance( unsigned int index, StkFloat frequency, StkFloat radius, bool normalize )
+{
+#if defined(_STK_DEBUG_)
+  if ( index >= nSections_ ) {
+    oStream_ << "BiQuadBank::setResonance: index argument (" << index << ") is out of range!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+  if ( frequency < 0.0 || frequency > 0.5 * Stk::sampleRate() ) {
+    oStream_ << "BiQuadBank::setResonance: frequency argument (" << frequency << ") is out of range!";
+    handleError( StkError::WARNING ); return;
+  }
+  if ( radius < 0.0 || radius >= 1.0 ) {
+    oStream_ << "BiQuadBank::setResonance: radius argument (" << radius << ") is out of range!";
+    handleError( StkError::WARNING ); return;
+  }
+#endif
+
+  double a2 = (double) radius * radius;
+  data_[A2 * nPadded_ + index] = a2;
+  data_[A1 * nPadded_ + index] = -2.0 * radius * cos( TWO_PI * (double) frequency / Stk::sampleRate() );
+
+  if ( normalize ) {
+    // Use zeros at +- 1 and normalize the filter peak gain.
+    data_[B0 * nPadded_ + index] = 0.5 - 0.5 * a2;
+    data_[B1 * nPadded_ + index] = 0.0;
+    data_[B2 * nPadded_ + index] = -data_[B0 * nPadded_ + index];
+  }
+  else {
+    data_[B0 * nPadded_ + index] = 1.0;
+    data_[B1 * nPadded_ + index] = 0.0;
+    data_[B2 * nPadded_ + index] = 0.0;
+  }
+}
+
+void BiQuadBank :: setEqualGainZeroes( void )
+{
+  for ( unsigned int i=0; i<nSections_; i++ ) {
+    data_[B0 * nPadded_ + i] = 1.0;
+    data_[B1 * nPadded_ + i] = 0.0;
+    data_[B2 * nPadded_ + i] = -1.0;
+  }
+}
+
+} // stk namespace
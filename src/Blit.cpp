@@ -16,6 +16,12 @@
     automatic modification of the number of harmonics is performed by
     the setFrequency() function).
 
+    The two sines of the algorithm are computed by recursive
+    oscillators (rotations of a cosine and sine pair), which are
+    resynchronized with the exact values at each period and near the
+    peaks of the impulses.  See the WaveTable class for a
+    table-based band-limited impulse train.
+
     Original code by Robin Davies, 2005.
     Revisions by Gary Scavone for STK, 2005.
 */
@@ -33,6 +39,7 @@ Blit:: Blit( StkFloat frequency )
   }
 
   nHarmonics_ = 0;
+  phase_ = 0.0;
   this->setFrequency( frequency );
   this->reset();
 }
@@ -44,6 +51,7 @@ Blit :: ~Blit()
 void Blit :: reset()
 {
   phase_ = 0.0;
+  this->syncOscillators();
   lastFrame_[0] = 0.0;
 }
 
@@ -73,6 +81,25 @@ void Blit :: updateHarmonics( void )
   }
   else
     m_ = 2 * nHarmonics_ + 1;
+
+  this->setRotations();
+  this->syncOscillators();
+}
+
+void Blit :: setRotations( void )
+{
+  sinRate_ = sin( rate_ );
+  cosRate_ = cos( rate_ );
+  sinMRate_ = sin( m_ * rate_ );
+  cosMRate_ = cos( m_ * rate_ );
+}
+
+void Blit :: syncOscillators( void )
+{
+  sin_ = sin( phase_ );
+  cos_ = cos( phase_ );
+  sinM_ = sin( m_ * phase_ );
+  cosM_ = cos( m_ * phase_ );
 }
 
 } // stk namespace
@@ -14,6 +14,12 @@
     automatic modification of the number of harmonics is performed by
     the setFrequency() function).
 
+    The two sines of the algorithm are computed by recursive
+    oscillators (rotations of a cosine and sine pair), which are
+    resynchronized with the exact values at each period and near the
+    peaks of the impulses.  See the WaveTable class for a
+    table-based band-limited sawtooth.
+
     Based on initial code of Robin Davies, 2005.
     Modified algorithm code by Gary Scavone, 2005.
 */
@@ -31,6 +37,7 @@ BlitSaw:: BlitSaw( StkFloat frequency )
   }
 
   nHarmonics_ = 0;
+  m_ = 1;
   this->reset();
   this->setFrequency( frequency );
 }
@@ -42,6 +49,7 @@ BlitSaw :: ~BlitSaw()
 void BlitSaw :: reset()
 {
   phase_ = 0.0f;
+  this->syncOscillators();
   state_ = 0.0;
   lastFrame_[0] = 0.0;
 }
@@ -86,6 +94,24 @@ void BlitSaw :: updateHarmonics( void )
     m_ = 2 * nHarmonics_ + 1;
 
   a_ = m_ / p_;
+  this->setRotations();
+  this->syncOscillators();
+}
+
+void BlitSaw :: setRotations( void )
+{
+  sinRate_ = sin( rate_ );
+  cosRate_ = cos( rate_ );
+  sinMRate_ = sin( m_ * rate_ );
+  cosMRate_ = cos( m_ * rate_ );
+}
+
+void BlitSaw :: syncOscillators( void )
+{
+  sin_ = sin( phase_ );
+  cos_ = cos( phase_ );
+  sinM_ = sin( m_ * phase_ );
+  cosM_ = cos( m_ * phase_ );
 }
 
 } // stk namespace
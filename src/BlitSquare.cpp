@@ -25,6 +25,12 @@
     Blit waveforms.  This class is not guaranteed to be well behaved
     in the presence of significant aliasing.
 
+    The two sines of the algorithm are computed by recursive
+    oscillators (rotations of a cosine and sine pair), which are
+    resynchronized with the exact values at each period and near the
+    peaks of the impulses.  See the WaveTable class for a
+    table-based band-limited square wave.
+
     Based on initial code of Robin Davies, 2005
     Modified algorithm code by Gary Scavone, 2005--2010.
 */
@@ -42,6 +48,7 @@ BlitSquare:: BlitSquare( StkFloat frequency )
   }
 
   nHarmonics_ = 0;
+  phase_ = 0.0;
   this->setFrequency( frequency );
   this->reset();
 }
@@ -53,6 +60,7 @@ BlitSquare :: ~BlitSquare()
 void BlitSquare :: reset()
 {
   phase_ = 0.0;
+  this->syncOscillators();
   lastFrame_[0] = 0.0;
   dcbState_ = 0.0;
   lastBlitOutput_ = 0;
@@ -90,6 +98,24 @@ void BlitSquare :: updateHarmonics( void )
     m_ = 2 * (nHarmonics_ + 1);
 
   a_ = m_ / p_;
+  this->setRotations();
+  this->syncOscillators();
+}
+
+void BlitSquare :: setRotations( void )
+{
+  sinRate_ = sin( rate_ );
+  cosRate_ = cos( rate_ );
+  sinMRate_ = sin( m_ * rate_ );
+  cosMRate_ = cos( m_ * rate_ );
+}
+
+void BlitSquare :: syncOscillators( void )
+{
+  sin_ = sin( phase_ );
+  cos_ = cos( phase_ );
+  sinM_ = sin( m_ * phase_ );
+  cosM_ = cos( m_ * phase_ );
 }
 
 } // stk namespace
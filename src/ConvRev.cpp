@@ -0,0 +1,165 @@
+/***************************************************/
+/*! \class ConvRev
+    \brief STK convolution reverberator class.
+
+    This class takes a monophonic input signal and produces a stereo
+    output signal by convolving it with a measured or synthesized
+    room impulse response, using the partitioned FFT convolution of
+    the Convolver class, without added latency.  The impulse response
+    is read from a sound file supported by FileRead and resampled to
+    the current STK sample rate if necessary.  A stereo impulse
+    response gives a stereo reverberation, while a mono one gives the
+    same output in both channels.  Only the first two channels of a
+    file are used.
+
+    By default, the impulse response is scaled so that the channel
+    with the largest energy has unit energy, which gives similar
+    levels for impulse responses of different lengths.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "ConvRev.h"
+#include "FileRead.h"
+#include "Resampler.h"
+#include <cmath>
+
+namespace stk {
+
+ConvRev :: ConvRev( std::string fileName, bool normalize )
+  : nChannels_( 1 ), scale_( 1.0 )
+{
+  lastFrame_.resize( 1, 2, 0.0 ); // resize lastFrame_ for stereo output
+  buffer_.resize( BLOCK_SIZE, 2, 0.0 );
+  effectMix_ = 0.3;
+
+  if ( fileName != "" ) this->openFile( fileName, normalize );
+}
+
+void ConvRev :: openFile( std::string fileName, bool normalize )
+{
+  FileRead file( fileName );
+  StkFrames data( file.fileSize(), file.channels() );
+  file.read( data );
+
+  // Resample the impulse response to the current sample rate with
+  // band-limited interpolation.
+  if ( file.fileRate() != Stk::sampleRate() ) {
+    StkFloat rate = file.fileRate() / Stk::sampleRate();
+    unsigned long nFrames = (unsigned long) ( 0.5 + data.frames() / rate );
+    StkFrames impulse( nFrames, data.channels() ), frame( 1, data.channels() );
+    Resampler resampler( Resampler::HIGH );
+    resampler.setRate( rate );
+    for ( unsigned long i=0; i<nFrames; i++ ) {
+      resampler.interpolate( data, i * rate, frame );
+      for ( unsigned int j=0; j<data.channels(); j++ )
+        impulse( i, j ) = frame[j];
+    }
+    this->setImpulse( impulse, normalize );
+  }
+  else
+    this->setImpulse( data, normalize );
+}
+
+void ConvRev :: setImpulse( StkFrames& impulse, bool normalize )
+{
+  if ( impulse.frames() == 0 || impulse.channels() == 0 ) {
+    oStream_ << "ConvRev::setImpulse: impulse response is empty!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  nChannels_ = ( impulse.channels() > 1 ) ? 2 : 1;
+  scale_ = 1.0;
+  StkFloat maxEnergy = 0.0;
+  for ( unsigned int j=0; j<nChannels_; j++ ) {
+    convolvers_[j].setImpulse( &impulse[j], impulse.frames(), impulse.channels() );
+
+    StkFloat energy = 0.0;
+    for ( unsigned long i=0; i<impulse.frames(); i++ )
+      energy += impulse( i, j ) * impulse( i, j );
+    if ( energy > maxEnergy ) maxEnergy = energy;
+  }
+
+  if ( normalize && maxEnergy > 0.0 ) scale_ = 1.0 / sqrt( maxEnergy );
+  lastFrame_[0] = 0.0;
+  lastFrame_[1] = 0.0;
+}
+
+void ConvRev :: setPartitioning( unsigned int blockSize, bool uniform )
+{
+  convolvers_[0].setPartitioning( blockSize, uniform );
+  convolvers_[1].setPartitioning( blockSize, uniform );
+  lastFrame_[0] = 0.0;
+  lastFrame_[1] = 0.0;
+}
+
+void ConvRev :: clear( void )
+{
+  convolvers_[0].clear();
+  convolvers_[1].clear();
+  lastFrame_[0] = 0.0;
+  lastFrame_[1] = 0.0;
+}
+
+void ConvRev :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  // The wet signals of a block of frames are computed into the
+  // buffer, before the inputs are overwritten.
+  StkFloat *wet = &buffer_[0];
+  StkFloat mix = effectMix_, scale = scale_;
+  unsigned int i, n, right = ( nChannels_ > 1 ) ? 1 : 0;
+
+  while ( nFrames > 0 ) {
+    n = ( nFrames < BLOCK_SIZE ) ? (unsigned int) nFrames : BLOCK_SIZE;
+    convolvers_[0].tick( input, iHop, wet, 2, n );
+    if ( right ) convolvers_[1].tick( input, iHop, wet + 1, 2, n );
+
+    for ( i=0; i<n; i++ ) {
+      StkFloat temp = ( 1.0 - mix ) * input[i * iHop];
+      StkFloat left = scale * wet[2*i];
+      output[i * oHop] = mix * left + temp;
+      output[i * oHop + 1] = mix * ( scale * wet[2*i+right] ) + temp;
+    }
+
+    input += n * iHop;
+    output += n * oHop;
+    nFrames -= n;
+  }
+
+  output -= oHop;
+  lastFrame_[0] = output[0];
+  lastFrame_[1] = output[1];
+}
+
+StkFrames& ConvRev :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel >= frames.channels() - 1 ) {
+    oStream_ << "ConvRev::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  if ( frames.frames() == 0 ) return frames;
+  StkFloat *samples = &frames[channel];
+  unsigned int hop = frames.channels();
+  this->tickFrames( samples, hop, samples, hop, frames.frames() );
+  return frames;
+}
+
+StkFrames& ConvRev :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() - 1 ) {
+    oStream_ << "ConvRev::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  if ( iFrames.frames() == 0 ) return iFrames;
+  this->tickFrames( &iFrames[iChannel], iFrames.channels(), &oFrames[oChannel], oFrames.channels(), iFrames.frames() );
+  return iFrames;
+}
+
+} // stk namespace
@@ -0,0 +1,265 @@
+/***************************************************/
+/*! \class Convolver
+    \brief STK partitioned convolution class.
+
+    This class convolves its input with an impulse response of any
+    length without latency, using partitioned FFT convolution.  The
+    first \e blockSize taps (the head) are computed directly, so that
+    each output depends on the current input.  The remaining taps are
+    divided into partitions, which are convolved in the frequency
+    domain (uniformly partitioned overlap-save convolution) each time
+    a block of inputs is complete, at a cost per sample which grows
+    only logarithmically with the partition size.
+
+    With uniform partitioning, all tail partitions have the head
+    size.  With non-uniform partitioning (the default), the
+    partition size grows by a factor of four every three partitions,
+    up to 16384 frames, so that long impulse responses (hundreds of
+    thousands of taps) need few partitions.  All computations are
+    done synchronously within the tick() functions, so that the
+    processing time of a tick varies: the block at which a large
+    partition is completed takes much longer than the average.
+
+    The tick() functions can be called with single samples or with
+    blocks of any size and give identical outputs.  Memory is only
+    allocated when the impulse response or the partitioning is set.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "Convolver.h"
+
+namespace stk {
+
+Convolver :: Convolver( unsigned int blockSize, bool uniform )
+  : length_( 1 ), blockSize_( 64 ), uniform_( uniform ), historySize_( 0 ), position_( 0 ), lastOut_( 0.0 )
+{
+  // The default impulse response is a pass-through.
+  taps_.assign( 1, 1.0 );
+  this->setPartitioning( blockSize, uniform );
+}
+
+Convolver :: ~Convolver( void )
+{
+}
+
+void Convolver :: setImpulse( const StkFloat *impulse, unsigned long length, unsigned int stride )
+{
+  if ( length == 0 ) {
+    oStream_ << "Convolver::setImpulse: impulse response length must be greater than zero!";
+    handleError( StkError::FUNCTION_ARGUMENT ); return;
+  }
+
+  taps_.resize( length );
+  for ( unsigned long i=0; i<length; i++ )
+    taps_[i] = impulse[i * stride];
+
+  length_ = length;
+  this->configure();
+}
+
+void Convolver :: setImpulse( const std::vector<StkFloat> &impulse )
+{
+  if ( impulse.empty() ) {
+    oStream_ << "Convolver::setImpulse: impulse response length must be greater than zero!";
+    handleError( StkError::FUNCTION_ARGUMENT ); return;
+  }
+
+  this->setImpulse( &impulse[0], (unsigned long) impulse.size() );
+}
+
+void Convolver :: setPartitioning( unsigned int blockSize, bool uniform )
+{
+  if ( blockSize < 16 || ( blockSize & ( blockSize - 1 ) ) ) {
+    oStream_ << "Convolver::setPartitioning: block size (" << blockSize << ") must be a power of two greater than or equal to 16!";
+    handleError( StkError::FUNCTION_ARGUMENT ); return;
+  }
+
+  blockSize_ = blockSize;
+  uniform_ = uniform;
+  this->configure();
+}
+
+void Convolver :: configure( void )
+{
+  unsigned long i, length = length_;
+  unsigned int headLength = ( length < blockSize_ ) ? (unsigned int) length : blockSize_;
+  head_.assign( taps_.begin(), taps_.begin() + headLength );
+
+  // Lay out the tail partitions.  Each level starts at the tap equal
+  // to its partition size, so that the outputs of a level are
+  // computed from complete input blocks before they are needed.
+  levels_.clear();
+  unsigned int size = blockSize_, maxSize = blockSize_;
+  unsigned long start = blockSize_;
+  while ( start < length ) {
+    unsigned long end = length;
+    bool grow = !uniform_ && size < MAX_PARTITION_SIZE;
+    if ( grow && 4 * (unsigned long) size < length ) end = 4 * (unsigned long) size;
+
+    levels_.push_back( Level() );
+    Level& level = levels_.back();
+    level.size = size;
+    level.nPartitions = (unsigned int) ( ( end - start + size - 1 ) / size );
+    level.newest = 0;
+    level.fft.setSize( 2 * size );
+    level.impulse.resize( level.nPartitions * 2 * ( size + 1 ) );
+    level.inputs.assign( level.impulse.size(), 0.0 );
+    level.outputs.assign( size, 0.0 );
+
+    // Compute the spectrum of each zero-padded partition.
+    work_.assign( 2 * size, 0.0 );
+    for ( unsigned int p=0; p<level.nPartitions; p++ ) {
+      unsigned long offset = start + (unsigned long) p * size;
+      for ( i=0; i<size; i++ )
+        work_[i] = ( offset + i < length ) ? taps_[offset + i] : 0.0;
+      StkFloat *real = &level.impulse[p * 2 * ( size + 1 )];
+      level.fft.forward( &work_[0], real, real + size + 1 );
+    }
+
+    maxSize = size;
+    start = end;
+    if ( grow ) size *= 4;
+  }
+
+  // The input history must hold the inputs of the largest partition
+  // and its predecessor.
+  historySize_ = 2 * maxSize;
+  history_.assign( 2 * historySize_, 0.0 );
+  position_ = 0;
+  block_.assign( blockSize_, 0.0 );
+  work_.assign( 4 * ( maxSize + 1 ), 0.0 );
+  lastOut_ = 0.0;
+}
+
+void Convolver :: clear( void )
+{
+  unsigned int i;
+  for ( i=0; i<history_.size(); i++ )
+    history_[i] = 0.0;
+  for ( std::vector<Level>::iterator level = levels_.begin(); level != levels_.end(); ++level ) {
+    for ( i=0; i<level->inputs.size(); i++ )
+      level->inputs[i] = 0.0;
+    for ( i=0; i<level->outputs.size(); i++ )
+      level->outputs[i] = 0.0;
+  }
+  position_ = 0;
+  lastOut_ = 0.0;
+}
+
+void Convolver :: processLevel( Level& level )
+{
+  unsigned int k, size = level.size, bins = size + 1, stride = 2 * bins;
+
+  // Transform the last two blocks of inputs (overlap-save).
+  level.newest = ( level.newest + 1 ) % level.nPartitions;
+  StkFloat *inputs = &level.inputs[level.newest * stride];
+  level.fft.forward( &history_[position_ + historySize_ - 2 * size], inputs, inputs + bins );
+
+  // Multiply each partition spectrum with the spectrum of the input
+  // block delayed by the partition index and accumulate.
+  StkFloat *real = &work_[0], *imag = real + bins, *outputs = imag + bins;
+  for ( k=0; k<bins; k++ ) {
+    real[k] = 0.0;
+    imag[k] = 0.0;
+  }
+
+  for ( unsigned int p=0; p<level.nPartitions; p++ ) {
+    unsigned int slot = ( level.newest + level.nPartitions - p ) % level.nPartitions;
+    const StkFloat *xr = &level.inputs[slot * stride], *xi = xr + bins;
+    const StkFloat *hr = &level.impulse[p * stride], *hi = hr + bins;
+    for ( k=0; k<bins; k++ ) {
+      real[k] += xr[k] * hr[k] - xi[k] * hi[k];
+      imag[k] += xr[k] * hi[k] + xi[k] * hr[k];
+    }
+  }
+
+  // The second half of the inverse transform holds the outputs of
+  // the next block.
+  level.fft.inverse( real, imag, outputs );
+  for ( k=0; k<size; k++ )
+    level.outputs[k] = outputs[size + k];
+}
+
+void Convolver :: tickBlock( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned int nFrames )
+{
+  // The frames are all within one head block.  The inputs are stored
+  // twice, so that the history of each one is contiguous.
+  unsigned int i, base = position_;
+  for ( i=0; i<nFrames; i++ ) {
+    StkFloat x = input[i * iHop];
+    history_[base + i] = x;
+    history_[base + historySize_ + i] = x;
+  }
+
+  StkFloat *y = &block_[0];
+  for ( i=0; i<nFrames; i++ )
+    y[i] = 0.0;
+
+  const StkFloat *x = &history_[base + historySize_];
+  for ( unsigned int k=0; k<head_.size(); k++ ) {
+    const StkFloat h = head_[k];
+    const StkFloat *xk = x - k;
+    for ( i=0; i<nFrames; i++ )
+      y[i] += h * xk[i];
+  }
+
+  for ( std::vector<Level>::iterator level = levels_.begin(); level != levels_.end(); ++level ) {
+    const StkFloat *tail = &level->outputs[base & ( level->size - 1 )];
+    for ( i=0; i<nFrames; i++ )
+      y[i] += tail[i];
+  }
+
+  for ( i=0; i<nFrames; i++ )
+    output[i * oHop] = y[i];
+  lastOut_ = y[nFrames-1];
+
+  position_ = ( base + nFrames ) & ( historySize_ - 1 );
+  if ( position_ & ( blockSize_ - 1 ) ) return;
+
+  for ( std::vector<Level>::iterator level = levels_.begin(); level != levels_.end(); ++level )
+    if ( ( position_ & ( level->size - 1 ) ) == 0 ) this->processLevel( *level );
+}
+
+void Convolver :: tick( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  while ( nFrames > 0 ) {
+    unsigned int n = blockSize_ - ( position_ & ( blockSize_ - 1 ) );
+    if ( n > nFrames ) n = (unsigned int) nFrames;
+    this->tickBlock( input, iHop, output, oHop, n );
+    input += n * iHop;
+    output += n * oHop;
+    nFrames -= n;
+  }
+}
+
+StkFrames& Convolver :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel >= frames.channels() ) {
+    oStream_ << "Convolver::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *samples = &frames[channel];
+  unsigned int hop = frames.channels();
+  this->tick( samples, hop, samples, hop, frames.frames() );
+  return frames;
+}
+
+StkFrames& Convolver :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() ) {
+    oStream_ << "Convolver::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  this->tick( &iFrames[iChannel], iFrames.channels(), &oFrames[oChannel], oFrames.channels(), iFrames.frames() );
+  return iFrames;
+}
+
+} // stk namespace
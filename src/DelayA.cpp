@@ -75,15 +75,23 @@ void DelayA :: setDelay( StkFloat delay )
     handleError( StkError::WARNING );
   }
 
-  StkFloat outPointer = inPoint_ - delay + 1.0;     // outPoint chases inpoint
+  // Split the delay into its integer and fractional parts before
+  // offsetting the write pointer, so that the fractional part keeps
+  // full precision for long delay lines in single precision.
+  unsigned long integer = (unsigned long) delay;
+  alpha_ = delay - integer;
   delay_ = delay;
 
+  long outPointer = (long) inPoint_ - (long) integer;  // outPoint chases inpoint
+  if ( alpha_ == 0.0 ) {
+    outPointer += 1;
+    alpha_ = 1.0;
+  }
+
   while ( outPointer < 0 )
     outPointer += length;  // modulo maximum length
-
-  outPoint_ = (long) outPointer;         // integer part
-  if ( outPoint_ == length ) outPoint_ = 0;
-  alpha_ = 1.0 + outPoint_ - outPointer; // fractional part
+  if ( outPointer >= (long) length ) outPointer -= length;
+  outPoint_ = outPointer;
 
   if ( alpha_ < 0.5 ) {
     // The optimal range for alpha is about 0.5 - 1.5 in order to
@@ -0,0 +1,308 @@
+/***************************************************/
+/*! \class DiskStream
+    \brief STK background prefetcher for streamed audio files.
+
+    This class moves the disk reads of a FileWvIn or FileLoop
+    instance that incrementally loads its file in chunks off the
+    audio thread.  The chunks that follow the one being played are
+    read ahead into a small set of buffers by a process-wide pool of
+    I/O threads and handed to the audio thread through an atomic
+    state per buffer.  A chunk that was not read in time is read
+    synchronously, or played as silence while an I/O thread is busy
+    with the file, and counted as an underrun.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "DiskStream.h"
+#include "FileWvIn.h"
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <thread>
+
+namespace stk {
+
+// The amount of playback, in frames at a rate of 1.0, read ahead of
+// the current chunk, and the highest rate for which this amount is
+// guaranteed.
+const unsigned long READ_AHEAD_FRAMES = 2048;
+const unsigned int READ_AHEAD_MAX_RATE = 4;
+const unsigned int MAX_READ_AHEAD_CHUNKS = 16;
+
+struct DiskStreamPool {
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<DiskStream *> streams;
+  size_t next;
+  unsigned int nThreads;
+  unsigned int nRunning;
+  std::atomic<bool> enabled;
+  std::atomic<unsigned long> requests;
+
+  DiskStreamPool() : next( 0 ), nThreads( 2 ), nRunning( 0 ), enabled( true ), requests( 0 ) {}
+};
+
+// The pool is intentionally never destroyed, so that its detached
+// threads and any streams with static storage can outlive the
+// destruction of other static objects at program exit.
+static DiskStreamPool& streamPool( void )
+{
+  static DiskStreamPool *pool = new DiskStreamPool;
+  return *pool;
+}
+
+// Start I/O threads until the requested number is running.  The
+// pool mutex must be held by the caller.
+static void startThreads( DiskStreamPool& pool, void (*function)( unsigned int ) )
+{
+  while ( pool.nRunning < pool.nThreads ) {
+    std::thread thread( function, pool.nRunning++ );
+    thread.detach();
+  }
+}
+
+DiskStream :: DiskStream( FileWvIn *owner, unsigned long nFrames, unsigned int nChannels )
+  : owner_( owner ), current_( 0 ), pending_( -1 ), busy_( 0 ), underruns_( 0 )
+{
+  // Allow for the current chunk, the read-ahead chunks at the
+  // highest rate and one spare.
+  unsigned long step = ( nFrames > 2 ) ? nFrames - 1 : 1;
+  unsigned long nAhead = ( READ_AHEAD_MAX_RATE * READ_AHEAD_FRAMES + step - 1 ) / step;
+  if ( nAhead > MAX_READ_AHEAD_CHUNKS ) nAhead = MAX_READ_AHEAD_CHUNKS;
+  std::vector<Slot> slots( nAhead + 2 );
+  slots_.swap( slots );
+  for ( unsigned int i=0; i<slots_.size(); i++ )
+    slots_[i].frames.resize( nFrames, nChannels );
+
+  DiskStreamPool& pool = streamPool();
+  std::lock_guard<std::mutex> lock( pool.mutex );
+  pool.streams.push_back( this );
+  startThreads( pool, &DiskStream::ioThread );
+}
+
+DiskStream :: ~DiskStream( void )
+{
+  DiskStreamPool& pool = streamPool();
+  {
+    std::lock_guard<std::mutex> lock( pool.mutex );
+    for ( size_t i=0; i<pool.streams.size(); i++ ) {
+      if ( pool.streams[i] == this ) {
+        pool.streams.erase( pool.streams.begin() + i );
+        break;
+      }
+    }
+  }
+
+  // No new reads can be claimed now, but one might still be running.
+  while ( busy_.load() > 0 )
+    std::this_thread::yield();
+}
+
+int DiskStream :: findSlot( long pointer ) const
+{
+  for ( unsigned int i=0; i<slots_.size(); i++ ) {
+    if ( slots_[i].pointer == pointer && slots_[i].state.load( std::memory_order_acquire ) != FREE )
+      return (int) i;
+  }
+  return -1;
+}
+
+const StkFrames& DiskStream :: fetch( long pointer )
+{
+  pending_ = -1;
+  int i = findSlot( pointer );
+  if ( i >= 0 && slots_[i].state.load( std::memory_order_acquire ) == READY ) {
+    current_ = (unsigned int) i;
+    return slots_[current_].frames;
+  }
+
+  // The chunk was not read ahead in time (or this is the first
+  // chunk), so read it now into the current buffer, which is never
+  // touched by the I/O threads.  If an I/O thread is reading from the
+  // file, play silence instead of waiting and leave the chunk to be
+  // read by the I/O threads.
+  Slot& slot = slots_[current_];
+  if ( slot.pointer >= 0 ) underruns_.fetch_add( 1, std::memory_order_relaxed );
+  std::unique_lock<std::mutex> lock( readMutex_, std::try_to_lock );
+  if ( lock.owns_lock() ) {
+    owner_->readChunk( slot.frames, pointer );
+    slot.pointer = pointer;
+  }
+  else {
+    for ( unsigned int n=0; n<slot.frames.size(); n++ ) slot.frames[n] = 0.0;
+    slot.pointer = -1;
+    pending_ = pointer;
+  }
+  slot.state.store( READY, std::memory_order_release );
+  return slot.frames;
+}
+
+void DiskStream :: takePending( void )
+{
+  int i = findSlot( pending_ );
+  if ( i < 0 ) {
+    // The read by an I/O thread failed, so try again synchronously.
+    this->fetch( pending_ );
+    return;
+  }
+
+  if ( slots_[i].state.load( std::memory_order_acquire ) == READY ) {
+    current_ = (unsigned int) i;
+    pending_ = -1;
+  }
+}
+
+void DiskStream :: prefetch( StkFloat rate )
+{
+  // Determine the chunks that follow in the direction of playback.
+  long step = (long) slots_[0].frames.frames() - 1;
+  if ( step < 1 ) step = 1;
+  unsigned long nAhead = (unsigned long) ceil( fabs( rate ) * READ_AHEAD_FRAMES / step );
+  if ( nAhead < 1 ) nAhead = 1;
+  if ( nAhead > slots_.size() - 2 ) nAhead = slots_.size() - 2;
+
+  // A pending chunk is wanted first, in addition to the chunks that
+  // follow it.
+  long wanted[MAX_READ_AHEAD_CHUNKS + 1];
+  unsigned int nWanted = 0;
+  long start = slots_[current_].pointer;
+  if ( pending_ >= 0 ) {
+    start = pending_;
+    wanted[nWanted++] = start;
+    nAhead++;
+  }
+  long pointer = start;
+  while ( nWanted < nAhead ) {
+    pointer = owner_->nextChunk( pointer, rate >= 0.0 );
+    if ( pointer < 0 || pointer == start ) break;
+    wanted[nWanted++] = pointer;
+  }
+
+  bool queued = false;
+  for ( unsigned int j=0; j<nWanted; j++ ) {
+    if ( findSlot( wanted[j] ) >= 0 ) continue;
+
+    // Reuse a free buffer or a finished one that is no longer wanted.
+    int s = -1;
+    for ( unsigned int i=0; i<slots_.size() && s < 0; i++ ) {
+      if ( i == current_ ) continue;
+      int state = slots_[i].state.load( std::memory_order_acquire );
+      if ( state == FREE ) s = (int) i;
+      else if ( state == READY ) {
+        unsigned int k = 0;
+        while ( k < nWanted && wanted[k] != slots_[i].pointer ) k++;
+        if ( k == nWanted ) s = (int) i;
+      }
+    }
+    if ( s < 0 ) break;
+
+    slots_[s].pointer = wanted[j];
+    slots_[s].state.store( QUEUED, std::memory_order_release );
+    queued = true;
+  }
+
+  if ( queued ) {
+    DiskStreamPool& pool = streamPool();
+    pool.requests.fetch_add( 1 );
+    pool.condition.notify_one();
+  }
+}
+
+bool DiskStream :: hasWork( void ) const
+{
+  for ( unsigned int i=0; i<slots_.size(); i++ )
+    if ( slots_[i].state.load( std::memory_order_relaxed ) == QUEUED ) return true;
+  return false;
+}
+
+bool DiskStream :: service( void )
+{
+  for ( unsigned int i=0; i<slots_.size(); i++ ) {
+    int expected = QUEUED;
+    if ( !slots_[i].state.compare_exchange_strong( expected, LOADING, std::memory_order_acq_rel ) )
+      continue;
+
+    bool ok = true;
+    try {
+      std::lock_guard<std::mutex> lock( readMutex_ );
+      owner_->readChunk( slots_[i].frames, slots_[i].pointer );
+    }
+    catch ( StkError & ) {
+      // Leave the error to be reported by a synchronous read.
+      ok = false;
+    }
+    slots_[i].state.store( ok ? READY : FREE, std::memory_order_release );
+    return true;
+  }
+  return false;
+}
+
+void DiskStream :: ioThread( unsigned int index )
+{
+  DiskStreamPool& pool = streamPool();
+  std::unique_lock<std::mutex> lock( pool.mutex );
+  while ( index < pool.nThreads ) {
+    unsigned long seen = pool.requests.load();
+
+    // Serve the streams round-robin.
+    DiskStream *stream = 0;
+    size_t nStreams = pool.streams.size();
+    for ( size_t k=0; k<nStreams && !stream; k++ ) {
+      size_t i = ( pool.next + k ) % nStreams;
+      if ( pool.streams[i]->hasWork() ) {
+        stream = pool.streams[i];
+        pool.next = i + 1;
+      }
+    }
+
+    if ( stream ) {
+      stream->busy_++;
+      lock.unlock();
+      stream->service();
+      stream->busy_--;
+      lock.lock();
+      continue;
+    }
+
+    // The audio thread signals requests without taking the mutex, so
+    // a wakeup can occasionally be missed and the wait is bounded.
+    pool.condition.wait_for( lock, std::chrono::milliseconds( 5 ), [&pool, seen, index] {
+        return pool.requests.load() != seen || index >= pool.nThreads; } );
+  }
+  pool.nRunning--;
+}
+
+void DiskStream :: setThreadCount( unsigned int nThreads )
+{
+  if ( nThreads == 0 ) {
+    Stk::handleError( "DiskStream::setThreadCount: number of threads must be at least one!", StkError::WARNING );
+    return;
+  }
+
+  DiskStreamPool& pool = streamPool();
+  std::lock_guard<std::mutex> lock( pool.mutex );
+  pool.nThreads = nThreads;
+  if ( pool.nRunning > 0 ) startThreads( pool, &DiskStream::ioThread );
+  pool.condition.notify_all();
+}
+
+unsigned int DiskStream :: getThreadCount( void )
+{
+  DiskStreamPool& pool = streamPool();
+  std::lock_guard<std::mutex> lock( pool.mutex );
+  return pool.nThreads;
+}
+
+void DiskStream :: setEnabled( bool enabled )
+{
+  streamPool().enabled = enabled;
+}
+
+bool DiskStream :: isEnabled( void )
+{
+  return streamPool().enabled;
+}
+
+} // stk namespace
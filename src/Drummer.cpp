@@ -6,7 +6,8 @@
     synthesizer using FileWvIn objects and one-pole
     filters.  The drum rawwave files are sampled
     at 22050 Hz, but will be appropriately
-    interpolated for other sample rates.  You can
+    interpolated for other sample rates, with
+    band-limited (Resampler::MEDIUM) interpolation.  You can
     specify the maximum polyphony (maximum number
     of simultaneous voices) via a #define in the
     Drummer.h.
@@ -61,6 +62,9 @@ Drummer :: Drummer( void ) : Instrmnt()
   nSounding_ = 0;
   soundOrder_ = std::vector<int> (DRUM_POLYPHONY, -1);
   soundNumber_ = std::vector<int> (DRUM_POLYPHONY, -1);
+
+  for ( int i=0; i<DRUM_POLYPHONY; i++ )
+    waves_[i].setInterpolationQuality( Resampler::MEDIUM );
 }
 
 Drummer :: ~Drummer( void )
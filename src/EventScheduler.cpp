@@ -0,0 +1,343 @@
+/***************************************************/
+/*! \class EventScheduler
+    \brief STK sample-accurate control event scheduler.
+
+    This class holds time-stamped control messages (Skini::Message
+    structures) and applies each one at its exact sample frame while
+    audio is computed in blocks.  The dispatch() function applies all
+    due events and returns the number of frames until the next one,
+    so that an audio callback can compute the frames between events
+    at once, without polling for control input.  The tick() function
+    does this for a Voicer or a single instrument.
+
+    Events can be scheduled at an absolute frame, with SKINI score
+    timing, from raw MIDI bytes, or collected from a Messager, in
+    which case realtime messages are placed according to their
+    arrival time stamps with a constant latency of one block.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "EventScheduler.h"
+#include "Messager.h"
+#include "MessageQueue.h"
+#include "SKINImsg.h"
+#include <algorithm>
+#include <cmath>
+
+namespace stk {
+
+EventScheduler :: EventScheduler( unsigned long nEvents )
+  : capacity_( nEvents ), sequence_( 0 ), frame_( 0 ), scoreFrame_( 0 ), postponed_( 0 ),
+    overruns_( 0 ), pollTime_( -1.0 ), scoreEnded_( false ), handler_( 0 ), userData_( 0 ),
+    voicer_( 0 ), instrument_( 0 )
+{
+  if ( capacity_ == 0 ) {
+    oStream_ << "EventScheduler::EventScheduler: the number of events must be greater than zero!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  events_.reserve( capacity_ );
+}
+
+EventScheduler :: ~EventScheduler( void )
+{
+}
+
+void EventScheduler :: setHandler( EventHandler handler, void *userData )
+{
+  handler_ = handler;
+  userData_ = userData;
+}
+
+void EventScheduler :: setVoicer( Voicer *voicer )
+{
+  voicer_ = voicer;
+  instrument_ = 0;
+}
+
+void EventScheduler :: setInstrument( Instrmnt *instrument )
+{
+  instrument_ = instrument;
+  voicer_ = 0;
+}
+
+void EventScheduler :: reset( void )
+{
+  events_.clear();
+  sequence_ = 0;
+  frame_ = 0;
+  scoreFrame_ = 0;
+  postponed_ = 0;
+  overruns_ = 0;
+  pollTime_ = -1.0;
+  scoreEnded_ = false;
+}
+
+bool EventScheduler :: later( const Event& a, const Event& b )
+{
+  if ( a.frame != b.frame ) return a.frame > b.frame;
+  return a.sequence > b.sequence;
+}
+
+bool EventScheduler :: insert( const Skini::Message& message, unsigned long frame, unsigned long sequence )
+{
+  if ( events_.size() >= capacity_ ) {
+    overruns_++;
+    return false;
+  }
+
+  // The event vector never grows beyond its reserved capacity.
+  events_.push_back( Event() );
+  Event& event = events_.back();
+  event.frame = frame;
+  event.sequence = sequence;
+  event.message = message;
+  std::push_heap( events_.begin(), events_.end(), later );
+  return true;
+}
+
+bool EventScheduler :: schedule( const Skini::Message& message, unsigned long frame )
+{
+  return this->insert( message, frame, sequence_++ );
+}
+
+bool EventScheduler :: scheduleMessage( const Skini::Message& message )
+{
+  if ( scoreFrame_ < frame_ ) scoreFrame_ = frame_;
+  if ( message.time >= 0.0 )
+    scoreFrame_ += (unsigned long) ( message.time * Stk::sampleRate() );
+  else if ( (unsigned long) ( -message.time * Stk::sampleRate() ) > scoreFrame_ )
+    scoreFrame_ = (unsigned long) ( -message.time * Stk::sampleRate() );
+
+  return this->schedule( message, scoreFrame_ );
+}
+
+bool EventScheduler :: scheduleMidi( const unsigned char *bytes, size_t nBytes, unsigned long frame )
+{
+  // Only keep MIDI channel messages.
+  if ( nBytes < 2 || bytes[0] < 0x80 || bytes[0] > 239 ) return false;
+
+  Skini::Message message;
+  message.type = bytes[0] & 0xF0;
+  message.channel = bytes[0] & 0x0F;
+  message.intValues[0] = bytes[1];
+  message.floatValues[0] = (StkFloat) message.intValues[0];
+  if ( ( message.type != 0xC0 ) && ( message.type != 0xD0 ) ) {
+    if ( nBytes < 3 ) return false;
+    message.intValues[1] = bytes[2];
+    if ( message.type == 0xE0 ) { // combine pitchbend into single "14-bit" value
+      message.intValues[0] += message.intValues[1] <<= 7;
+      message.floatValues[0] = (StkFloat) message.intValues[0];
+      message.intValues[1] = 0;
+    }
+    else
+      message.floatValues[1] = (StkFloat) message.intValues[1];
+  }
+
+  return this->schedule( message, frame );
+}
+
+unsigned long EventScheduler :: pollMessages( Messager& messager, unsigned long nFrames )
+{
+  // The message structure is kept between calls because the exit
+  // message at the end of a scorefile only sets the type, so that it
+  // follows the last message by the same delay, as in the demo
+  // program.
+  Skini::Message& message = message_;
+  unsigned long nMessages = 0;
+
+  if ( messager.isScoreInput() ) {
+    // Read ahead until the first message beyond this block.
+    while ( !scoreEnded_ && scoreFrame_ < frame_ + nFrames ) {
+      messager.popMessage( message );
+      if ( message.type == 0 ) break;
+      if ( this->scheduleMessage( message ) ) nMessages++;
+      if ( message.type == __SK_Exit_ ) scoreEnded_ = true;
+    }
+    return nMessages;
+  }
+
+  // Realtime messages which arrived since the previous call are placed
+  // at the same offsets within this block.
+  double now = MessageQueue::currentTime();
+  double timeStamp;
+  while ( true ) {
+    messager.popMessage( message, &timeStamp );
+    if ( message.type == 0 ) break;
+
+    unsigned long offset = 0;
+    if ( pollTime_ >= 0.0 && timeStamp > pollTime_ && nFrames > 0 ) {
+      double frames = ( timeStamp - pollTime_ ) * Stk::sampleRate();
+      offset = ( frames < nFrames - 1 ) ? (unsigned long) frames : nFrames - 1;
+    }
+
+    unsigned long frame = frame_ + offset;
+    if ( message.time > 0.0 )
+      frame += (unsigned long) ( message.time * Stk::sampleRate() );
+    else if ( message.time < 0.0 )
+      frame = (unsigned long) ( -message.time * Stk::sampleRate() );
+
+    if ( this->schedule( message, frame ) ) nMessages++;
+  }
+
+  pollTime_ = now;
+  return nMessages;
+}
+
+void EventScheduler :: postpone( unsigned long nFrames )
+{
+  // A uniform shift keeps the heap order.
+  for ( size_t i=0; i<events_.size(); i++ )
+    events_[i].frame += nFrames;
+  if ( scoreFrame_ < frame_ ) scoreFrame_ = frame_;
+  scoreFrame_ += nFrames;
+  postponed_ += nFrames;
+}
+
+unsigned long EventScheduler :: dispatch( unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return 0;
+
+  while ( !events_.empty() && events_.front().frame <= frame_ ) {
+    std::pop_heap( events_.begin(), events_.end(), later );
+    Event event = events_.back();
+    events_.pop_back();
+
+    postponed_ = 0;
+    this->apply( event.message );
+    if ( postponed_ > 0 ) {
+      // Dispatch the same event again after the delay, ahead of any
+      // other event at that frame.
+      this->insert( event.message, frame_ + postponed_, event.sequence );
+      postponed_ = 0;
+      break;
+    }
+  }
+
+  unsigned long n = nFrames;
+  if ( !events_.empty() && events_.front().frame - frame_ < n )
+    n = events_.front().frame - frame_;
+
+  frame_ += n;
+  return n;
+}
+
+void EventScheduler :: apply( const Skini::Message& message )
+{
+  if ( handler_ ) {
+    handler_( message, userData_ );
+    return;
+  }
+
+  StkFloat value1 = message.floatValues[0];
+  StkFloat value2 = message.floatValues[1];
+  if ( voicer_ ) {
+    switch( message.type ) {
+
+    case __SK_NoteOn_:
+      if ( value2 > 0.0 ) { // velocity > 0
+        voicer_->noteOn( value1, value2 );
+        break;
+      }
+      // else a note off, so continue to next case
+
+    case __SK_NoteOff_:
+      voicer_->noteOff( value1, value2 );
+      break;
+
+    case __SK_ControlChange_:
+      voicer_->controlChange( (int) value1, value2 );
+      break;
+
+    case __SK_AfterTouch_:
+      voicer_->controlChange( 128, value1 );
+      break;
+
+    case __SK_PitchChange_:
+      voicer_->setFrequency( value1 );
+      break;
+
+    case __SK_PitchBend_:
+      voicer_->pitchBend( value1 );
+      break;
+    }
+  }
+  else if ( instrument_ ) {
+    switch( message.type ) {
+
+    case __SK_NoteOn_:
+      if ( value2 > 0.0 ) { // velocity > 0
+        instrument_->noteOn( 220.0 * pow( 2.0, ( value1 - 57.0 ) / 12.0 ), value2 * ONE_OVER_128 );
+        break;
+      }
+      // else a note off, so continue to next case
+
+    case __SK_NoteOff_:
+      instrument_->noteOff( value2 * ONE_OVER_128 );
+      break;
+
+    case __SK_ControlChange_:
+      instrument_->controlChange( (int) value1, value2 );
+      break;
+
+    case __SK_AfterTouch_:
+      instrument_->controlChange( 128, value1 );
+      break;
+
+    case __SK_PitchChange_:
+      instrument_->setFrequency( 220.0 * pow( 2.0, ( value1 - 57.0 ) / 12.0 ) );
+      break;
+    }
+  }
+}
+
+StkFrames& EventScheduler :: tick( StkFrames& frames, unsigned int channel )
+{
+  unsigned int nChannels;
+  if ( voicer_ ) nChannels = voicer_->channelsOut();
+  else if ( instrument_ ) nChannels = instrument_->channelsOut();
+  else {
+    oStream_ << "EventScheduler::tick: no Voicer or instrument has been set!";
+    handleError( StkError::WARNING );
+    return frames;
+  }
+
+#if defined(_STK_DEBUG_)
+  if ( channel > frames.channels() - nChannels ) {
+    oStream_ << "EventScheduler::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  unsigned long nFrames = frames.frames();
+  unsigned long n = this->dispatch( nFrames );
+  if ( n == nFrames ) {
+    // No event within the block.
+    if ( voicer_ ) voicer_->tick( frames, channel );
+    else instrument_->tick( frames, channel );
+    return frames;
+  }
+
+  // Compute each part of the block between events into a scratch
+  // buffer, which only allocates memory when the block size grows.
+  segment_.resize( nFrames, frames.channels() );
+  unsigned long offset = 0;
+  while ( true ) {
+    segment_.resize( n, frames.channels() );
+    if ( voicer_ ) voicer_->tick( segment_, channel );
+    else instrument_->tick( segment_, channel );
+    for ( unsigned long i=0; i<n; i++ )
+      for ( unsigned int j=channel; j<channel+nChannels; j++ )
+        frames( offset + i, j ) = segment_( i, j );
+
+    offset += n;
+    if ( offset == nFrames ) break;
+    n = this->dispatch( nFrames - offset );
+  }
+
+  return frames;
+}
+
+} // stk namespace
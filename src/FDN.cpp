@@ -0,0 +1,343 @@
+/***************************************************/
+/*! \class FDN
+    \brief STK feedback delay network class.
+
+    This class implements the core of a reverberator: a set of delay
+    lines in parallel with feedback, each with a one-pole lowpass
+    (damping) filter in its loop.  The feedback of each line is either
+    independent of the others (a bank of parallel comb filters, as in
+    the JCRev, NRev and FreeVerb classes) or mixed between all the
+    lines by a Householder matrix (a feedback delay network).  The
+    monophonic input is added to all the lines, and the lines are
+    mixed to 1 - 16 output channels by an output matrix.
+
+    The delay lines are stored one after another in a single buffer,
+    and the tick( StkFrames& ) function processes blocks of up to 64
+    samples (limited by the shortest delay) one delay line at a time,
+    in contiguous segments of the lines without wrap tests.  The
+    loops over the samples of a block, other than the damping filter
+    recursions, can be vectorized by the compiler.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "FDN.h"
+#include <cmath>
+#include <algorithm>
+
+namespace stk {
+
+// Mutually prime delays for 44100 Hz sample rate.
+static const unsigned long defaultDelays[16] = { 1103, 1163, 1229, 1297, 1361, 1427, 1489, 1553,
+                                                 1621, 1693, 1759, 1831, 1901, 1973, 2039, 2069 };
+
+static bool isPrime( unsigned long number )
+{
+  if ( number == 2 ) return true;
+  if ( number < 2 || ( number & 1 ) == 0 ) return false;
+  for ( unsigned long i=3; i*i<=number; i+=2 )
+    if ( number % i == 0 ) return false;
+  return true;
+}
+
+FDN :: FDN( unsigned int nLines, unsigned int nChannels )
+  : nLines_( nLines ), nChannels_( nChannels ), blockSize_( 1 ), pole_( 0.0 ), b0_( 1.0 ), mixing_( DIAGONAL )
+{
+  if ( nLines == 0 ) {
+    oStream_ << "FDN::FDN: the number of lines must be greater than zero!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  if ( nChannels == 0 || nChannels > 16 ) {
+    oStream_ << "FDN::FDN: the number of channels (" << nChannels << ") must be between 1 and 16!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  Line empty = { 0, 0, 0, 0, 0, 0, 0, 0.0, 0.0 };
+  lines_.resize( nLines_, empty );
+  outputGains_.resize( nLines_ * nChannels_, 0.0 );
+  block_.resize( BLOCK_SIZE * nLines_, 0.0 );
+  outputs_.resize( BLOCK_SIZE * nChannels_, 0.0 );
+  lastFrame_.resize( 1, nChannels_, 0.0 );
+
+  // Scale the default delays to the sample rate, using distinct
+  // prime numbers, and longer delays for more than 16 lines.
+  double scaler = Stk::sampleRate() / 44100.0;
+  unsigned int i, j;
+  for ( i=0; i<nLines_; i++ ) {
+    unsigned long delay = (unsigned long) floor( scaler * ( defaultDelays[i % 16] + 97 * ( i / 16 ) ) );
+    while ( true ) {
+      for ( j=0; j<i; j++ )
+        if ( lines_[j].delay == delay ) break;
+      if ( j == i && isPrime( delay ) ) break;
+      delay++;
+    }
+    lines_[i].delay = delay;
+    outputGains_[i * nChannels_ + i % nChannels_] = 1.0;
+  }
+
+  this->allocate();
+  this->setT60( 1.0 );
+}
+
+FDN :: ~FDN( void )
+{
+}
+
+void FDN :: allocate( void )
+{
+  // Each line holds at least the delayed values read during a block
+  // and, with an output delay, the values written during a block.
+  std::vector<unsigned long> offset( nLines_ ), length( nLines_ );
+  unsigned long size = 0;
+  unsigned int i;
+  blockSize_ = BLOCK_SIZE;
+  for ( i=0; i<nLines_; i++ ) {
+    const Line& l = lines_[i];
+    length[i] = l.delay;
+    if ( l.outputDelay > 0 && l.outputDelay + BLOCK_SIZE > length[i] )
+      length[i] = l.outputDelay + BLOCK_SIZE;
+    offset[i] = size;
+    size += length[i];
+    if ( l.delay < blockSize_ ) blockSize_ = l.delay;
+  }
+
+  // Keep the contents of the lines whose length has not changed.
+  std::vector<StkFloat> buffer( size, 0.0 );
+  for ( i=0; i<nLines_; i++ ) {
+    Line& l = lines_[i];
+    if ( length[i] == l.length )
+      std::copy( buffer_.begin() + l.offset, buffer_.begin() + l.offset + l.length, buffer.begin() + offset[i] );
+    else
+      l.inPoint = 0;
+    l.offset = offset[i];
+    l.length = length[i];
+    this->setPoints( l );
+  }
+
+  buffer_.swap( buffer );
+}
+
+void FDN :: setPoints( Line& l )
+{
+  l.readPoint = ( l.inPoint + l.length - l.delay ) % l.length;
+  l.tapPoint = ( l.inPoint + l.length - l.outputDelay ) % l.length;
+}
+
+void FDN :: clear( void )
+{
+  std::fill( buffer_.begin(), buffer_.end(), 0.0 );
+  for ( unsigned int i=0; i<nLines_; i++ )
+    lines_[i].state = 0.0;
+  for ( unsigned int c=0; c<nChannels_; c++ )
+    lastFrame_[c] = 0.0;
+}
+
+void FDN :: setDelay( unsigned int line, unsigned long delay, unsigned long outputDelay )
+{
+  if ( line >= nLines_ ) {
+    oStream_ << "FDN::setDelay: line argument (" << line << ") is invalid!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  if ( delay == 0 || outputDelay > delay ) {
+    oStream_ << "FDN::setDelay: the delay must be positive and not smaller than the output delay!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  Line& l = lines_[line];
+  l.delay = delay;
+  l.outputDelay = outputDelay;
+  this->allocate();
+
+  std::fill( buffer_.begin() + l.offset, buffer_.begin() + l.offset + l.length, 0.0 );
+  l.inPoint = 0;
+  this->setPoints( l );
+  l.state = 0.0;
+}
+
+unsigned long FDN :: getDelay( unsigned int line ) const
+{
+  if ( line >= nLines_ ) {
+    oStream_ << "FDN::getDelay: line argument (" << line << ") is invalid!";
+    handleError( StkError::WARNING ); return 0;
+  }
+
+  return lines_[line].delay;
+}
+
+void FDN :: setFeedback( unsigned int line, StkFloat gain )
+{
+  if ( line >= nLines_ ) {
+    oStream_ << "FDN::setFeedback: line argument (" << line << ") is invalid!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  lines_[line].gain = gain;
+}
+
+void FDN :: setT60( StkFloat T60 )
+{
+  if ( T60 <= 0.0 ) {
+    oStream_ << "FDN::setT60: argument (" << T60 << ") must be positive!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  for ( unsigned int i=0; i<nLines_; i++ )
+    lines_[i].gain = pow( 10.0, -3.0 * lines_[i].delay / ( T60 * Stk::sampleRate() ) );
+}
+
+void FDN :: setDamping( StkFloat pole )
+{
+  if ( pole < 0.0 || pole >= 1.0 ) {
+    oStream_ << "FDN::setDamping: argument (" << pole << ") must be between 0.0 and 1.0!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  pole_ = pole;
+  b0_ = 1.0 - pole;
+}
+
+void FDN :: setMixing( Mixing mixing )
+{
+  if ( mixing < DIAGONAL || mixing > HOUSEHOLDER ) {
+    oStream_ << "FDN::setMixing: unknown mixing matrix!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  mixing_ = mixing;
+}
+
+void FDN :: setOutputGain( unsigned int line, unsigned int channel, StkFloat gain )
+{
+  if ( line >= nLines_ || channel >= nChannels_ ) {
+    oStream_ << "FDN::setOutputGain: line or channel argument is invalid!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  outputGains_[line * nChannels_ + channel] = gain;
+}
+
+StkFrames& FDN :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel >= iFrames.channels() || oChannel + nChannels_ > oFrames.channels() || oFrames.frames() < iFrames.frames() ) {
+    oStream_ << "FDN::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  const StkFloat *iSamples = &iFrames[iChannel];
+  StkFloat *oSamples = &oFrames[oChannel];
+  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
+  unsigned long n, m, nFrames = iFrames.frames();
+  unsigned int i, c;
+  StkFloat inputs[BLOCK_SIZE], sums[BLOCK_SIZE];
+  const StkFloat b0 = b0_, pole = pole_;
+
+  // The delayed values of all lines for a block of samples are read
+  // before the first of them is written, since the block is not
+  // longer than the shortest delay.  Each line is processed over the
+  // whole block, in contiguous segments between the wraps of its read
+  // and write positions.
+  for ( unsigned long start=0; start<nFrames; start+=blockSize_ ) {
+    unsigned long nBlock = ( nFrames - start < blockSize_ ) ? nFrames - start : blockSize_;
+    for ( n=0; n<nBlock; n++, iSamples += iHop ) inputs[n] = *iSamples;
+
+    // Damping filters and feedback gains.  With 32-bit floats, the
+    // filter outputs are clamped to zero before they decay into the
+    // denormal range (see FreeVerb).
+    for ( i=0; i<nLines_; i++ ) {
+      const Line& l = lines_[i];
+      const StkFloat *line = &buffer_[l.offset];
+      unsigned long length = l.length;
+      unsigned long j = l.readPoint;
+      StkFloat *x = &block_[i * BLOCK_SIZE];
+      StkFloat state = l.state, gain = l.gain;
+      for ( n=0; n<nBlock; n+=m ) {
+        m = std::min( nBlock - n, length - j );
+        const StkFloat *p = line + j;
+        StkFloat *q = x + n;
+        for ( unsigned long k=0; k<m; k++ ) {
+          state = b0 * p[k] + pole * state;
+#if defined(__STK_FLOAT32__)
+          state += 9.8607615E-32f;
+          state -= 9.8607615E-32f;
+#endif
+          q[k] = gain * state;
+        }
+        j += m;
+        if ( j == length ) j = 0;
+      }
+      lines_[i].state = state;
+    }
+
+    if ( mixing_ == HOUSEHOLDER ) {
+      for ( n=0; n<nBlock; n++ ) sums[n] = 0.0;
+      for ( i=0; i<nLines_; i++ ) {
+        const StkFloat *x = &block_[i * BLOCK_SIZE];
+        for ( n=0; n<nBlock; n++ ) sums[n] += x[n];
+      }
+      StkFloat scale = 2.0 / nLines_;
+      for ( n=0; n<nBlock; n++ ) sums[n] *= scale;
+    }
+
+    for ( c=0; c<nChannels_; c++ ) {
+      StkFloat *out = &outputs_[c * BLOCK_SIZE];
+      for ( n=0; n<nBlock; n++ ) out[n] = 0.0;
+    }
+
+    // Write the new values of the lines, read their output taps and
+    // add them to the output channels, in the order of the lines.
+    const StkFloat *gains = &outputGains_[0];
+    for ( i=0; i<nLines_; i++, gains += nChannels_ ) {
+      Line& l = lines_[i];
+      StkFloat *line = &buffer_[l.offset];
+      unsigned long length = l.length;
+      StkFloat *x = &block_[i * BLOCK_SIZE];
+      if ( mixing_ == HOUSEHOLDER )
+        for ( n=0; n<nBlock; n++ ) x[n] = inputs[n] + ( x[n] - sums[n] );
+      else
+        for ( n=0; n<nBlock; n++ ) x[n] = inputs[n] + x[n];
+
+      unsigned long j = l.inPoint;
+      for ( n=0; n<nBlock; n+=m ) {
+        m = std::min( nBlock - n, length - j );
+        std::copy( x + n, x + n + m, line + j );
+        j += m;
+        if ( j == length ) j = 0;
+      }
+
+      if ( l.outputDelay ) {
+        unsigned long k = l.tapPoint;
+        for ( n=0; n<nBlock; n+=m ) {
+          m = std::min( nBlock - n, length - k );
+          std::copy( line + k, line + k + m, x + n );
+          k += m;
+          if ( k == length ) k = 0;
+        }
+      }
+      l.inPoint = j;
+      this->setPoints( l );
+
+      for ( c=0; c<nChannels_; c++ ) {
+        if ( gains[c] == 0.0 ) continue;
+        StkFloat gain = gains[c], *out = &outputs_[c * BLOCK_SIZE];
+        for ( n=0; n<nBlock; n++ ) out[n] += gain * x[n];
+      }
+    }
+
+    for ( n=0; n<nBlock; n++, oSamples += oHop )
+      for ( c=0; c<nChannels_; c++ ) oSamples[c] = outputs_[c * BLOCK_SIZE + n];
+  }
+
+  if ( nFrames > 0 ) {
+    for ( c=0; c<nChannels_; c++ )
+      lastFrame_[c] = *(oSamples - oHop + c);
+  }
+
+  return iFrames;
+}
+
+} // stk namespace
@@ -0,0 +1,160 @@
+/***************************************************/
+/*! \class FFT
+    \brief STK real-input fast Fourier transform class.
+
+    This class computes the discrete Fourier transform of a block of
+    real values, the size of which must be a power of two, and its
+    inverse.  The transform of N real values is computed with a
+    complex radix-2 transform of N/2 points, and the N/2 + 1
+    non-redundant frequency bins (from DC to the Nyquist frequency)
+    are stored in separate arrays of real and imaginary parts, so
+    that spectra can be combined in loops which the compiler can
+    vectorize.
+
+    The forward transform is unscaled and the inverse transform is
+    scaled by 1/N, so that the inverse of the forward transform
+    returns the original values.  The tables and work buffers are
+    allocated when the size is set, so that the transforms do not
+    allocate memory.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "FFT.h"
+#include <cmath>
+
+namespace stk {
+
+FFT :: FFT( unsigned int size )
+  : size_( 0 )
+{
+  if ( size > 0 ) this->setSize( size );
+}
+
+FFT :: ~FFT( void )
+{
+}
+
+void FFT :: setSize( unsigned int size )
+{
+  if ( size < 4 || ( size & ( size - 1 ) ) ) {
+    oStream_ << "FFT::setSize: size (" << size << ") must be a power of two greater than or equal to 4!";
+    handleError( StkError::FUNCTION_ARGUMENT ); return;
+  }
+
+  if ( size == size_ ) return;
+  size_ = size;
+
+  unsigned int i, half = size_ / 2;
+  cosine_.resize( half + 1 );
+  sine_.resize( half + 1 );
+  for ( i=0; i<=half; i++ ) {
+    cosine_[i] = (StkFloat) cos( TWO_PI * i / size_ );
+    sine_[i] = (StkFloat) sin( TWO_PI * i / size_ );
+  }
+
+  unsigned int bits = 0;
+  while ( ( 1U << bits ) < half ) bits++;
+  bitReverse_.resize( half );
+  for ( i=0; i<half; i++ ) {
+    unsigned int reversed = 0;
+    for ( unsigned int b=0; b<bits; b++ )
+      if ( i & ( 1U << b ) ) reversed |= 1U << ( bits - 1 - b );
+    bitReverse_[i] = reversed;
+  }
+
+  workReal_.resize( half );
+  workImag_.resize( half );
+}
+
+void FFT :: transform( StkFloat *real, StkFloat *imag, bool inverse )
+{
+  unsigned int i, j, n = size_ / 2;
+  for ( i=0; i<n; i++ ) {
+    j = bitReverse_[i];
+    if ( j > i ) {
+      StkFloat temp = real[i]; real[i] = real[j]; real[j] = temp;
+      temp = imag[i]; imag[i] = imag[j]; imag[j] = temp;
+    }
+  }
+
+  // The twiddle factors of an n-point transform are taken from the
+  // tables for size_ = 2n points.
+  for ( unsigned int length=2; length<=n; length<<=1 ) {
+    unsigned int half = length / 2, step = size_ / length;
+    for ( j=0; j<half; j++ ) {
+      StkFloat wr = cosine_[j * step];
+      StkFloat wi = inverse ? sine_[j * step] : -sine_[j * step];
+      for ( i=j; i<n; i+=length ) {
+        unsigned int k = i + half;
+        StkFloat tr = wr * real[k] - wi * imag[k];
+        StkFloat ti = wr * imag[k] + wi * real[k];
+        real[k] = real[i] - tr;
+        imag[k] = imag[i] - ti;
+        real[i] += tr;
+        imag[i] += ti;
+      }
+    }
+  }
+}
+
+void FFT :: forward( const StkFloat *input, StkFloat *real, StkFloat *imag )
+{
+  unsigned int k, n = size_ / 2;
+  StkFloat *zr = &workReal_[0];
+  StkFloat *zi = &workImag_[0];
+
+  // Transform the even and odd values as the real and imaginary parts
+  // of one complex sequence.
+  for ( k=0; k<n; k++ ) {
+    zr[k] = input[2*k];
+    zi[k] = input[2*k+1];
+  }
+  this->transform( zr, zi, false );
+
+  // Separate the spectra of the even (e) and odd (o) values and
+  // combine them: X[k] = E[k] + exp(-2 pi i k / size_) O[k].
+  for ( k=0; k<=n; k++ ) {
+    unsigned int a = ( k == n ) ? 0 : k;
+    unsigned int b = ( k == 0 ) ? 0 : n - k;
+    StkFloat er = 0.5 * ( zr[a] + zr[b] );
+    StkFloat ei = 0.5 * ( zi[a] - zi[b] );
+    StkFloat orr = 0.5 * ( zi[a] + zi[b] );
+    StkFloat oi = -0.5 * ( zr[a] - zr[b] );
+    real[k] = er + cosine_[k] * orr + sine_[k] * oi;
+    imag[k] = ei + cosine_[k] * oi - sine_[k] * orr;
+  }
+  imag[0] = 0.0;
+  imag[n] = 0.0;
+}
+
+void FFT :: inverse( const StkFloat *real, const StkFloat *imag, StkFloat *output )
+{
+  unsigned int k, n = size_ / 2;
+  StkFloat *zr = &workReal_[0];
+  StkFloat *zi = &workImag_[0];
+
+  // Recover the spectra of the even and odd values and combine them
+  // as Z[k] = E[k] + i O[k].
+  for ( k=0; k<n; k++ ) {
+    StkFloat er = 0.5 * ( real[k] + real[n-k] );
+    StkFloat ei = 0.5 * ( imag[k] - imag[n-k] );
+    StkFloat dr = real[k] - real[n-k];
+    StkFloat di = imag[k] + imag[n-k];
+    if ( k == 0 ) ei = di = 0.0;
+    StkFloat orr = 0.5 * ( dr * cosine_[k] - di * sine_[k] );
+    StkFloat oi = 0.5 * ( dr * sine_[k] + di * cosine_[k] );
+    zr[k] = er - oi;
+    zi[k] = ei + orr;
+  }
+  this->transform( zr, zi, true );
+
+  StkFloat scale = 1.0 / n;
+  for ( k=0; k<n; k++ ) {
+    output[2*k] = scale * zr[k];
+    output[2*k+1] = scale * zi[k];
+  }
+}
+
+} // stk namespace
@@ -6,6 +6,9 @@
     waves and envelopes, determined via a
     constructor argument.
 
+    Operator waves use the shared SineWave table by default, and
+    can be read from rawwave files with loadWaves().
+
     Control Change Numbers: 
        - Control One = 2
        - Control Two = 4
@@ -48,6 +51,7 @@ FM :: FM( unsigned int operators )
     ratios_.push_back( 1.0 );
     gains_.push_back( 1.0 );
     adsr_[j] = new ADSR();
+    waves_[j] = new Wave();
   }
 
   modDepth_ = 0.0;
@@ -86,7 +90,15 @@ FM :: ~FM( void )
 void FM :: loadWaves( const char **filenames )
 {
   for (unsigned int i=0; i<nOperators_; i++ )
-    waves_[i] = new FileLoop( filenames[i], true );
+    waves_[i]->openFile( filenames[i] );
+}
+
+void FM :: Wave :: openFile( std::string fileName )
+{
+  // An exception could be thrown here.
+  FileLoop *loop = new FileLoop( fileName, true );
+  delete loop_;
+  loop_ = loop;
 }
 
 void FM :: setFrequency( StkFloat frequency )
@@ -38,6 +38,9 @@ FileLoop :: FileLoop( std::string fileName, bool raw, bool doNormalize,
 
 FileLoop :: ~FileLoop( void )
 {
+  // Stop prefetching while the readChunk() and nextChunk() overrides
+  // of this class can still be called.
+  this->closeFile();
   Stk::removeSampleRateAlert( this );
 }
 
@@ -46,32 +49,47 @@ void FileLoop :: openFile( std::string fileName, bool raw, bool doNormalize, boo
   // Call close() in case another file is already open.
   this->closeFile();
 
+  // Use the shared data if this file has already been loaded.
+  unsigned int variant = cacheVariant( raw, doNormalize, doInt2FloatScaling, true );
+  int2floatscaling_ = doInt2FloatScaling;
+  if ( this->openShared( fileName, variant, 1 ) ) {
+    this->setRate( data_.dataRate() / Stk::sampleRate() );
+    this->reset();
+    return;
+  }
+
   // Attempt to open the file ... an error might be thrown here.
   file_.open( fileName, raw );
 
   // Determine whether chunking or not.
-  if ( file_.fileSize() > chunkThreshold_ ) {
+  firstFrame_.resize( 0, 0 );
+  fileSize_ = file_.fileSize();
+  if ( fileSize_ > chunkThreshold_ ) {
     chunking_ = true;
     chunkPointer_ = 0;
-    data_.resize( chunkSize_ + 1, file_.channels() );
+    if ( DiskStream::isEnabled() ) {
+      // Keep the channel count and file rate in data_, without any samples.
+      data_.resize( 0, file_.channels() );
+      data_.setDataRate( file_.fileRate() );
+      stream_ = new DiskStream( this, chunkSize_ + 1, file_.channels() );
+    }
+    else
+      data_.resize( chunkSize_ + 1, file_.channels() );
   }
   else {
     chunking_ = false;
-    data_.resize( file_.fileSize() + 1, file_.channels() );
+    data_.resize( fileSize_ + 1, file_.channels() );
   }
 
-  if ( doInt2FloatScaling )
-    int2floatscaling_ = true;
-  else
-    int2floatscaling_ = false;
-
   // Load all or part of the data.
-  file_.read( data_, 0, int2floatscaling_ );
+  if ( stream_ ) stream_->fetch( 0 );
+  else file_.read( data_, 0, int2floatscaling_ );
 
   if ( chunking_ ) { // If chunking, save the first sample frame for later.
-    firstFrame_.resize( 1, data_.channels() );
-    for ( unsigned int i=0; i<data_.channels(); i++ )
-      firstFrame_[i] = data_[i];
+    const StkFrames& data = this->readData();
+    firstFrame_.resize( 1, data.channels() );
+    for ( unsigned int i=0; i<data.channels(); i++ )
+      firstFrame_[i] = data[i];
   }
   else {  // If not chunking, copy the first sample frame to the last.
     for ( unsigned int i=0; i<data_.channels(); i++ )
@@ -82,7 +100,6 @@ void FileLoop :: openFile( std::string fileName, bool raw, bool doNormalize, boo
   lastFrame_.resize( 1, file_.channels() );
 
   // Close the file unless chunking
-  fileSize_ = file_.fileSize();
   if ( !chunking_ ) file_.close();
 
   // Set default rate based on file sampling rate.
@@ -90,15 +107,18 @@ void FileLoop :: openFile( std::string fileName, bool raw, bool doNormalize, boo
 
   if ( doNormalize & !chunking_ ) this->normalize();
 
+  if ( !chunking_ ) this->shareData( fileName, variant );
+
   this->reset();
 }
 
 void FileLoop :: setRate( StkFloat rate )
 {
-  rate_ = rate;
+  // Read ahead for the new rate and direction.
+  if ( stream_ ) stream_->prefetch( rate );
 
-  if ( fmod( rate_, 1.0 ) != 0.0 ) interpolate_ = true;
-  else interpolate_ = false;
+  rate_ = rate;
+  this->setInterpolation();
 }
 
 void FileLoop :: addTime( StkFloat time )
@@ -162,35 +182,30 @@ StkFloat FileLoop :: tick( unsigned int channel )
     if ( ( time_ < (StkFloat) chunkPointer_ ) ||
          ( time_ > (StkFloat) ( chunkPointer_ + chunkSize_ - 1 ) ) ) {
 
-      while ( time_ < (StkFloat) chunkPointer_ ) { // negative rate
-        chunkPointer_ -= chunkSize_ - 1; // overlap chunks by one frame
-        if ( chunkPointer_ < 0 ) chunkPointer_ = 0;
-      }
-      while ( time_ > (StkFloat) ( chunkPointer_ + chunkSize_ - 1 ) ) { // positive rate
-        chunkPointer_ += chunkSize_ - 1; // overlap chunks by one frame
-        if ( chunkPointer_ + chunkSize_ > fileSize_ ) { // at end of file
-          chunkPointer_ = fileSize_ - chunkSize_ + 1; // leave extra frame at end of buffer
-          // Now fill extra frame with first frame data.
-          for ( unsigned int j=0; j<firstFrame_.channels(); j++ )
-            data_( data_.frames() - 1, j ) = firstFrame_[j];
-        }
-      }
+      chunkPointer_ = this->findChunk( time_, chunkPointer_ );
 
       // Load more data.
-      file_.read( data_, chunkPointer_, int2floatscaling_ );
+      if ( stream_ ) {
+        stream_->fetch( chunkPointer_ );
+        stream_->prefetch( rate_ );
+      }
+      else this->readChunk( data_, chunkPointer_ );
     }
 
     // Adjust index for the current buffer.
     tyme -= chunkPointer_;
   }
 
-  if ( interpolate_ ) {
+  const StkFrames& data = this->readData();
+  if ( interpolate_ && ( chunking_ || resampler_.getQuality() == Resampler::LINEAR ) ) {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_.interpolate( tyme, i );
+      lastFrame_[i] = data.interpolate( tyme, i );
   }
+  else if ( interpolate_ ) // the taps wrap around the loop
+    resampler_.interpolate( data, tyme, lastFrame_, fileSize_ );
   else {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_( (size_t) tyme, i );
+      lastFrame_[i] = data( (size_t) tyme, i );
   }
 
   // Increment time, which can be negative.
@@ -199,6 +214,41 @@ StkFloat FileLoop :: tick( unsigned int channel )
   return lastFrame_[channel];
 }
 
+long FileLoop :: findChunk( StkFloat time, long pointer )
+{
+  while ( time < (StkFloat) pointer ) { // negative rate
+    pointer -= chunkSize_ - 1; // overlap chunks by one frame
+    if ( pointer < 0 ) pointer = 0;
+  }
+  while ( time > (StkFloat) ( pointer + chunkSize_ - 1 ) ) { // positive rate
+    pointer += chunkSize_ - 1; // overlap chunks by one frame
+    if ( pointer + chunkSize_ > fileSize_ ) // at end of file
+      pointer = fileSize_ - chunkSize_ + 1; // leave extra frame at end of buffer
+  }
+  return pointer;
+}
+
+long FileLoop :: nextChunk( long pointer, bool forward )
+{
+  // Step to a time just beyond the given chunk, wrapping around the loop.
+  StkFloat time = ( forward ) ? pointer + chunkSize_ - 0.5 : pointer - 0.5;
+  if ( time < 0.0 ) time += fileSize_;
+  if ( time >= fileSize_ ) time -= fileSize_;
+  return this->findChunk( time, pointer );
+}
+
+void FileLoop :: readChunk( StkFrames& frames, long pointer )
+{
+  file_.read( frames, pointer, int2floatscaling_ );
+
+  // Fill the frames beyond the end of the file with the first frame
+  // data, so that interpolation wraps around the loop.
+  for ( size_t i=fileSize_-pointer; i<frames.frames(); i++ ) {
+    for ( unsigned int j=0; j<firstFrame_.channels(); j++ )
+      frames( i, j ) = firstFrame_[j];
+  }
+}
+
 StkFrames& FileLoop :: tick( StkFrames& frames, unsigned int channel)
 {
   if ( finished_ ) {
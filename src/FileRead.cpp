@@ -27,6 +27,11 @@
     such variable is found, the sample rate is
     assumed to be 44100 Hz.
 
+    On systems that support it, files can optionally
+    be memory mapped (see setMemoryMapping()), in
+    which case samples are converted directly from
+    the mapped file data.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
 /***************************************************/
@@ -38,28 +43,46 @@
 #include <cmath>
 #include <cstdio>
 
+#if defined(__unix__) || defined(__APPLE__)
+  #define __STK_FILEREAD_MMAP__
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
 namespace stk {
 
+// The size of the scratch buffer through which file data is read
+// when the file is not memory mapped.  Larger reads are converted in
+// chunks of this size.
+const unsigned long READ_BUFFER_BYTES = 65536;
+
 FileRead :: FileRead()
-  : fd_(0), fileSize_(0), channels_(0), dataType_(0), fileRate_(0.0)
+  : fd_(0), fileSize_(0), channels_(0), dataType_(0), fileRate_(0.0),
+    useMap_(false), map_(0), mapSize_(0)
 {
 }
 
 FileRead :: FileRead( std::string fileName, bool typeRaw, unsigned int nChannels,
                       StkFormat format, StkFloat rate )
-  : fd_(0)
+  : fd_(0), useMap_(false), map_(0), mapSize_(0)
 {
   open( fileName, typeRaw, nChannels, format, rate );
 }
 
 FileRead :: ~FileRead()
 {
-  if ( fd_ )
-    fclose( fd_ );
+  this->close();
 }
 
 void FileRead :: close( void )
 {
+#if defined(__STK_FILEREAD_MMAP__)
+  if ( map_ ) munmap( map_, mapSize_ );
+#endif
+  map_ = 0;
+  mapSize_ = 0;
+  std::vector<unsigned char>().swap( readBuffer_ );
+
   if ( fd_ ) fclose( fd_ );
   fd_ = 0;
   wavFile_ = false;
@@ -126,6 +149,7 @@ void FileRead :: open( std::string fileName, bool typeRaw, unsigned int nChannel
     handleError( StkError::FILE_ERROR );
   }
 
+  if ( useMap_ ) mapFile();
   return;
 
  error:
@@ -729,6 +753,26 @@ bool FileRead :: getMatInfo( const char *fileName )
   return false;
 }
 
+void FileRead :: mapFile( void )
+{
+#if defined(__STK_FILEREAD_MMAP__)
+  struct stat filestat;
+  int fd = fileno( fd_ );
+  if ( fstat( fd, &filestat ) == -1 || filestat.st_size <= 0 ) return;
+
+  void *map = mmap( 0, (size_t) filestat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+  if ( map == MAP_FAILED ) {
+    oStream_ << "FileRead::open: unable to memory map file ... using stdio reads.";
+    handleError( StkError::WARNING );
+    return;
+  }
+
+  madvise( map, (size_t) filestat.st_size, MADV_SEQUENTIAL );
+  map_ = map;
+  mapSize_ = (unsigned long) filestat.st_size;
+#endif
+}
+
 void FileRead :: read( StkFrames& buffer, unsigned long startFrame, bool doNormalize )
 {
   // Make sure we have an open file.
@@ -758,146 +802,161 @@ void FileRead :: read( StkFrames& buffer, unsigned long startFrame, bool doNorma
   if ( startFrame + nFrames > fileSize_ )
     nFrames = fileSize_ - startFrame;
 
-  long i, nSamples = (long) ( nFrames * channels_ );
-  unsigned long offset = startFrame * channels_;
+  unsigned long sampleBytes = 1;
+  if ( dataType_ == STK_SINT16 ) sampleBytes = 2;
+  else if ( dataType_ == STK_SINT24 ) sampleBytes = 3;
+  else if ( dataType_ == STK_SINT32 || dataType_ == STK_FLOAT32 ) sampleBytes = 4;
+  else if ( dataType_ == STK_FLOAT64 ) sampleBytes = 8;
+
+  unsigned long nSamples = nFrames * channels_;
+  unsigned long nBytes = nSamples * sampleBytes;
+  unsigned long position = dataOffset_ + startFrame * channels_ * sampleBytes;
+
+  if ( map_ ) {
+    if ( position + nBytes > mapSize_ ) goto error;
+    convert( (const unsigned char *) map_ + position, &buffer[0], nSamples, doNormalize );
+  }
+  else {
+    // Read the raw data in bounded chunks into a scratch buffer, which
+    // is kept between calls to avoid reallocation when streaming.
+    unsigned long maxSamples = READ_BUFFER_BYTES / sampleBytes;
+    if ( maxSamples > nSamples ) maxSamples = nSamples;
+    if ( readBuffer_.size() < maxSamples * sampleBytes ) readBuffer_.resize( maxSamples * sampleBytes );
+    if ( fseek( fd_, position, SEEK_SET ) == -1 ) goto error;
+    for ( unsigned long i=0; i<nSamples; i+=maxSamples ) {
+      unsigned long count = ( nSamples - i < maxSamples ) ? nSamples - i : maxSamples;
+      if ( fread( &readBuffer_[0], count * sampleBytes, 1, fd_ ) != 1 ) goto error;
+      convert( &readBuffer_[0], &buffer[i], count, doNormalize );
+    }
+  }
+
+#if defined(__STK_FILEREAD_MMAP__)
+  if ( map_ && position + nBytes < mapSize_ ) {
+    // Ask the kernel to prefetch the region that a streaming reader
+    // will request next.
+    unsigned long pageSize = (unsigned long) sysconf( _SC_PAGESIZE );
+    unsigned long start = ( position + nBytes ) & ~( pageSize - 1 );
+    unsigned long length = nBytes;
+    if ( start + length > mapSize_ ) length = mapSize_ - start;
+    madvise( (char *) map_ + start, length, MADV_WILLNEED );
+  }
+#endif
+
+  buffer.setDataRate( fileRate_ );
+
+  return;
 
-  // Read samples into StkFrames data buffer.
+ error:
+  oStream_ << "FileRead: Error reading file data.";
+  handleError( StkError::FILE_ERROR);
+}
+
+void FileRead :: convert( const unsigned char *data, StkFloat *samples, unsigned long nSamples, bool doNormalize )
+{
+  // The file data is not necessarily aligned, so each value is copied
+  // out with memcpy(), which compiles to a plain (unaligned) load.
+  unsigned long i;
   if ( dataType_ == STK_SINT16 ) {
-    SINT16 *buf = (SINT16 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*2), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 2, 1, fd_ ) != 1 ) goto error;
+    SINT16 temp;
+    StkFloat gain = doNormalize ? 1.0 / 32768.0 : 1.0;
     if ( byteswap_ ) {
-      SINT16 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap16( (unsigned char *) ptr++ );
-    }
-    if ( doNormalize ) {
-      StkFloat gain = 1.0 / 32768.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] * gain;
+      for ( i=0; i<nSamples; i++, data += 2 ) {
+        memcpy( &temp, data, 2 );
+        swap16( (unsigned char *) &temp );
+        samples[i] = temp * gain;
+      }
     }
     else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i];
+      for ( i=0; i<nSamples; i++, data += 2 ) {
+        memcpy( &temp, data, 2 );
+        samples[i] = temp * gain;
+      }
     }
   }
   else if ( dataType_ == STK_SINT32 ) {
-    SINT32 *buf = (SINT32 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*4 ), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 4, 1, fd_ ) != 1 ) goto error;
+    SINT32 temp;
+    StkFloat gain = doNormalize ? 1.0 / 2147483648.0 : 1.0;
     if ( byteswap_ ) {
-      SINT32 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap32( (unsigned char *) ptr++ );
-    }
-    if ( doNormalize ) {
-      StkFloat gain = 1.0 / 2147483648.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] * gain;
+      for ( i=0; i<nSamples; i++, data += 4 ) {
+        memcpy( &temp, data, 4 );
+        swap32( (unsigned char *) &temp );
+        samples[i] = temp * gain;
+      }
     }
     else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i];
+      for ( i=0; i<nSamples; i++, data += 4 ) {
+        memcpy( &temp, data, 4 );
+        samples[i] = temp * gain;
+      }
     }
   }
   else if ( dataType_ == STK_FLOAT32 ) {
-    FLOAT32 *buf = (FLOAT32 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*4), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 4, 1, fd_ ) != 1 ) goto error;
+    FLOAT32 temp;
     if ( byteswap_ ) {
-      FLOAT32 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap32( (unsigned char *) ptr++ );
+      for ( i=0; i<nSamples; i++, data += 4 ) {
+        memcpy( &temp, data, 4 );
+        swap32( (unsigned char *) &temp );
+        samples[i] = temp;
+      }
+    }
+    else {
+      for ( i=0; i<nSamples; i++, data += 4 ) {
+        memcpy( &temp, data, 4 );
+        samples[i] = temp;
+      }
     }
-    for ( i=nSamples-1; i>=0; i-- )
-      buffer[i] = buf[i];
   }
   else if ( dataType_ == STK_FLOAT64 ) {
-    FLOAT64 *buf = (FLOAT64 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*8), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 8, 1, fd_ ) != 1 ) goto error;
+    FLOAT64 temp;
     if ( byteswap_ ) {
-      FLOAT64 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap64( (unsigned char *) ptr++ );
+      for ( i=0; i<nSamples; i++, data += 8 ) {
+        memcpy( &temp, data, 8 );
+        swap64( (unsigned char *) &temp );
+        samples[i] = (StkFloat) temp;
+      }
+    }
+    else {
+      for ( i=0; i<nSamples; i++, data += 8 ) {
+        memcpy( &temp, data, 8 );
+        samples[i] = (StkFloat) temp;
+      }
     }
-    for ( i=nSamples-1; i>=0; i-- )
-      buffer[i] = buf[i];
   }
   else if ( dataType_ == STK_SINT8 && wavFile_ ) { // 8-bit WAV data is unsigned!
-    unsigned char *buf = (unsigned char *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+offset, SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples, 1, fd_) != 1 ) goto error;
     if ( doNormalize ) {
       StkFloat gain = 1.0 / 128.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = ( buf[i] - 128 ) * gain;
+      for ( i=0; i<nSamples; i++ )
+        samples[i] = ( data[i] - 128 ) * gain;
     }
     else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] - 128.0;
+      for ( i=0; i<nSamples; i++ )
+        samples[i] = data[i] - 128.0;
     }
   }
   else if ( dataType_ == STK_SINT8 ) { // signed 8-bit data
-    char *buf = (char *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+offset, SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples, 1, fd_ ) != 1 ) goto error;
-    if ( doNormalize ) {
-      StkFloat gain = 1.0 / 128.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] * gain;
-    }
-    else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i];
-    }
+    StkFloat gain = doNormalize ? 1.0 / 128.0 : 1.0;
+    for ( i=0; i<nSamples; i++ )
+      samples[i] = (signed char) data[i] * gain;
   }
   else if ( dataType_ == STK_SINT24 ) {
-    // 24-bit values are harder to import efficiently since there is
-    // no native 24-bit type.  The following routine works but is much
-    // less efficient than that used for the other data types.
-    SINT32 temp;
-    unsigned char *ptr = (unsigned char *) &temp;
-    StkFloat gain = 1.0 / 2147483648.0;
-    if ( fseek(fd_, dataOffset_+(offset*3), SEEK_SET ) == -1 ) goto error;
-    for ( i=0; i<nSamples; i++ ) {
+    // There is no native 24-bit type, so each value is assembled in
+    // the upper three bytes of a 32-bit integer, which preserves the
+    // sign.  The data byte order is independent of the host.
 #ifdef __LITTLE_ENDIAN__
-      if ( byteswap_ ) {
-        if ( fread( ptr, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0x00ffffff;
-        swap32( (unsigned char *) ptr );
-      }
-      else {
-        if ( fread( ptr+1, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0xffffff00;
-      }
+    bool bigEndian = byteswap_;
 #else
-      if ( byteswap_ ) {
-        if ( fread( ptr+1, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0xffffff00;
-        swap32( (unsigned char *) ptr );
-      }
-      else {
-        if ( fread( ptr, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0x00ffffff;
-      }
+    bool bigEndian = !byteswap_;
 #endif
-
-      if ( doNormalize ) {
-        buffer[i] = (StkFloat) temp * gain; // "gain" also  includes 1 / 256 factor.
-      }
-      else
-        buffer[i] = (StkFloat) temp / 256;  // right shift without affecting the sign bit
+    StkFloat gain = doNormalize ? 1.0 / 2147483648.0 : 1.0 / 256.0; // "gain" also includes 1 / 256 factor.
+    if ( bigEndian ) {
+      for ( i=0; i<nSamples; i++, data += 3 )
+        samples[i] = (SINT32) ( ( (UINT32) data[0] << 24 ) | ( (UINT32) data[1] << 16 ) | ( (UINT32) data[2] << 8 ) ) * gain;
+    }
+    else {
+      for ( i=0; i<nSamples; i++, data += 3 )
+        samples[i] = (SINT32) ( ( (UINT32) data[2] << 24 ) | ( (UINT32) data[1] << 16 ) | ( (UINT32) data[0] << 8 ) ) * gain;
     }
   }
-
-  buffer.setDataRate( fileRate_ );
-
-  return;
-
- error:
-  oStream_ << "FileRead: Error reading file data.";
-  handleError( StkError::FILE_ERROR);
 }
 
 } // stk namespace
@@ -6,7 +6,10 @@
     interface to the FileRead class.  It also provides variable-rate
     playback functionality.  Audio file support is provided by the
     FileRead class.  Linear interpolation is used for fractional read
-    rates.
+    rates by default.  Band-limited interpolation with the Resampler
+    class, which avoids the aliasing of linear interpolation when data
+    is transposed, can be selected with setInterpolationQuality() for
+    data read completely into local memory.
 
     FileWvIn supports multi-channel data.  It is important to
     distinguish the tick() method that computes a single frame (and
@@ -19,7 +22,10 @@
     This behavior is controlled by the optional constructor arguments
     \e chunkThreshold and \e chunkSize.  File sizes greater than \e
     chunkThreshold (in sample frames) will be read incrementally in
-    chunks of \e chunkSize each (also in sample frames).
+    chunks of \e chunkSize each (also in sample frames), which are read
+    ahead by background I/O threads.  Data read
+    completely into memory is shared with other instances through the
+    WaveCache class.
 
     When the file end is reached, subsequent calls to the tick()
     functions return zeros and isFinished() returns \e true.
@@ -38,7 +44,8 @@ namespace stk {
 
 FileWvIn :: FileWvIn( unsigned long chunkThreshold, unsigned long chunkSize )
   : finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
-    chunkThreshold_(chunkThreshold), chunkSize_(chunkSize)
+    chunkThreshold_(chunkThreshold), chunkSize_(chunkSize), stream_(0),
+    resampler_(Resampler::LINEAR)
 {
   Stk::addSampleRateAlert( this );
 }
@@ -47,7 +54,8 @@ FileWvIn :: FileWvIn( std::string fileName, bool raw, bool doNormalize,
                       unsigned long chunkThreshold, unsigned long chunkSize,
                       bool doInt2FloatScaling )
   : finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
-    chunkThreshold_(chunkThreshold), chunkSize_(chunkSize)
+    chunkThreshold_(chunkThreshold), chunkSize_(chunkSize), stream_(0),
+    resampler_(Resampler::LINEAR)
 {
   openFile( fileName, raw, doNormalize, doInt2FloatScaling );
   Stk::addSampleRateAlert( this );
@@ -67,7 +75,11 @@ void FileWvIn :: sampleRateChanged( StkFloat newRate, StkFloat oldRate )
 
 void FileWvIn :: closeFile( void )
 {
+  // Stop prefetching before closing the file.
+  delete stream_;
+  stream_ = 0;
   if ( file_.isOpen() ) file_.close();
+  sharedData_.reset();
   finished_ = true;
   lastFrame_.resize( 0, 0 );
 }
@@ -77,33 +89,45 @@ void FileWvIn :: openFile( std::string fileName, bool raw, bool doNormalize, boo
   // Call close() in case another file is already open.
   this->closeFile();
 
+  // Use the shared data if this file has already been loaded.
+  unsigned int variant = cacheVariant( raw, doNormalize, doInt2FloatScaling, false );
+  int2floatscaling_ = doInt2FloatScaling;
+  if ( this->openShared( fileName, variant, 0 ) ) {
+    this->setRate( data_.dataRate() / Stk::sampleRate() );
+    this->reset();
+    return;
+  }
+
   // Attempt to open the file ... an error might be thrown here.
   file_.open( fileName, raw );
 
   // Determine whether chunking or not.
-  if ( file_.fileSize() > chunkThreshold_ ) {
+  fileSize_ = file_.fileSize();
+  if ( fileSize_ > chunkThreshold_ ) {
     chunking_ = true;
     chunkPointer_ = 0;
-    data_.resize( chunkSize_, file_.channels() );
+    if ( DiskStream::isEnabled() ) {
+      // Keep the channel count and file rate in data_, without any samples.
+      data_.resize( 0, file_.channels() );
+      data_.setDataRate( file_.fileRate() );
+      stream_ = new DiskStream( this, chunkSize_, file_.channels() );
+    }
+    else
+      data_.resize( chunkSize_, file_.channels() );
   }
   else {
     chunking_ = false;
-    data_.resize( (size_t) file_.fileSize(), file_.channels() );
+    data_.resize( (size_t) fileSize_, file_.channels() );
   }
 
-  if ( doInt2FloatScaling )
-    int2floatscaling_ = true;
-  else
-    int2floatscaling_ = false;
-
   // Load all or part of the data.
-  file_.read( data_, 0, int2floatscaling_ );
+  if ( stream_ ) stream_->fetch( 0 );
+  else file_.read( data_, 0, int2floatscaling_ );
 
   // Resize our lastFrame container.
   lastFrame_.resize( 1, file_.channels() );
 
   // Close the file unless chunking
-  fileSize_ = file_.fileSize();
   if ( !chunking_ ) file_.close();
 
   // Set default rate based on file sampling rate.
@@ -111,9 +135,47 @@ void FileWvIn :: openFile( std::string fileName, bool raw, bool doNormalize, boo
 
   if ( doNormalize & !chunking_ ) this->normalize();
 
+  if ( !chunking_ ) this->shareData( fileName, variant );
+
   this->reset();
 }
 
+unsigned int FileWvIn :: cacheVariant( bool raw, bool doNormalize, bool doInt2FloatScaling, bool loop )
+{
+  return ( raw ? 1 : 0 ) | ( doNormalize ? 2 : 0 ) | ( doInt2FloatScaling ? 4 : 0 ) | ( loop ? 8 : 0 );
+}
+
+bool FileWvIn :: openShared( const std::string& fileName, unsigned int variant, unsigned long extraFrames )
+{
+  if ( !WaveCache::isEnabled() ) return false;
+
+  std::shared_ptr<const StkFrames> frames = WaveCache::find( fileName, variant );
+  if ( !frames || frames->frames() - extraFrames > chunkThreshold_ ) return false;
+
+  // Keep the channel count and file rate in data_, without any samples.
+  sharedData_ = frames;
+  data_ = StkFrames( 0, frames->channels() );
+  data_.setDataRate( frames->dataRate() );
+  lastFrame_.resize( 1, frames->channels() );
+  chunking_ = false;
+  fileSize_ = frames->frames() - extraFrames;
+  return true;
+}
+
+void FileWvIn :: shareData( const std::string& fileName, unsigned int variant )
+{
+  if ( !WaveCache::isEnabled() ) return;
+
+  std::shared_ptr<StkFrames> frames( new StkFrames( data_ ) );
+  StkFloat rate = data_.dataRate();
+  frames->setDataRate( rate );
+  sharedData_ = WaveCache::insert( fileName, variant, frames );
+
+  // Release the local copy.
+  data_ = StkFrames( 0, frames->channels() );
+  data_.setDataRate( rate );
+}
+
 void FileWvIn :: reset(void)
 {
   time_ = (StkFloat) 0.0;
@@ -132,6 +194,13 @@ void FileWvIn :: normalize( StkFloat peak )
   // When chunking, the "normalization" scaling is performed by FileRead.
   if ( chunking_ ) return;
 
+  // Shared data is copied before it is modified.
+  if ( sharedData_ ) {
+    data_ = *sharedData_;
+    data_.setDataRate( sharedData_->dataRate() );
+    sharedData_.reset();
+  }
+
   size_t i;
   StkFloat max = 0.0;
 
@@ -150,14 +219,32 @@ void FileWvIn :: normalize( StkFloat peak )
 
 void FileWvIn :: setRate( StkFloat rate )
 {
+  // Read ahead for the new rate and direction.
+  if ( stream_ ) stream_->prefetch( rate );
+
   rate_ = rate;
 
   // If negative rate and at beginning of sound, move pointer to end
   // of sound.
   if ( (rate_ < 0) && (time_ == 0.0) ) time_ = fileSize_ - 1.0;
 
+  this->setInterpolation();
+}
+
+void FileWvIn :: setInterpolationQuality( Resampler::Quality quality )
+{
+  resampler_.setQuality( quality );
+  this->setInterpolation();
+}
+
+void FileWvIn :: setInterpolation( void )
+{
+  // The windowed-sinc filters also remove the frequencies above the
+  // output Nyquist frequency when the data is read faster than its
+  // sample rate.
   if ( fmod( rate_, 1.0 ) != 0.0 ) interpolate_ = true;
-  else interpolate_ = false;
+  else interpolate_ = resampler_.getQuality() != Resampler::LINEAR && fabs( rate_ ) > 1.0;
+  if ( rate_ != 0.0 ) resampler_.setRate( fabs( rate_ ) );
 }
 
 void FileWvIn :: addTime( StkFloat time )   
@@ -197,31 +284,30 @@ StkFloat FileWvIn :: tick( unsigned int channel )
     if ( ( time_ < (StkFloat) chunkPointer_ ) ||
          ( time_ > (StkFloat) ( chunkPointer_ + chunkSize_ - 1 ) ) ) {
 
-      while ( time_ < (StkFloat) chunkPointer_ ) { // negative rate
-        chunkPointer_ -= chunkSize_ - 1; // overlap chunks by one frame
-        if ( chunkPointer_ < 0 ) chunkPointer_ = 0;
-      }
-      while ( time_ > (StkFloat) ( chunkPointer_ + chunkSize_ - 1 ) ) { // positive rate
-        chunkPointer_ += chunkSize_ - 1; // overlap chunks by one frame
-        if ( chunkPointer_ + chunkSize_ > fileSize_ ) // at end of file
-          chunkPointer_ = fileSize_ - chunkSize_;
-      }
+      chunkPointer_ = this->findChunk( time_, chunkPointer_ );
 
       // Load more data.
-      file_.read( data_, chunkPointer_, int2floatscaling_ );
+      if ( stream_ ) {
+        stream_->fetch( chunkPointer_ );
+        stream_->prefetch( rate_ );
+      }
+      else this->readChunk( data_, chunkPointer_ );
     }
 
     // Adjust index for the current buffer.
     tyme -= chunkPointer_;
   }
 
-  if ( interpolate_ ) {
+  const StkFrames& data = this->readData();
+  if ( interpolate_ && ( chunking_ || resampler_.getQuality() == Resampler::LINEAR ) ) {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_.interpolate( tyme, i );
+      lastFrame_[i] = data.interpolate( tyme, i );
   }
+  else if ( interpolate_ )
+    resampler_.interpolate( data, tyme, lastFrame_ );
   else {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_( (size_t) tyme, i );
+      lastFrame_[i] = data( (size_t) tyme, i );
   }
 
   // Increment time, which can be negative.
@@ -230,6 +316,33 @@ StkFloat FileWvIn :: tick( unsigned int channel )
   return lastFrame_[channel];
 }
 
+long FileWvIn :: findChunk( StkFloat time, long pointer )
+{
+  while ( time < (StkFloat) pointer ) { // negative rate
+    pointer -= chunkSize_ - 1; // overlap chunks by one frame
+    if ( pointer < 0 ) pointer = 0;
+  }
+  while ( time > (StkFloat) ( pointer + chunkSize_ - 1 ) ) { // positive rate
+    pointer += chunkSize_ - 1; // overlap chunks by one frame
+    if ( pointer + chunkSize_ > fileSize_ ) // at end of file
+      pointer = fileSize_ - chunkSize_;
+  }
+  return pointer;
+}
+
+long FileWvIn :: nextChunk( long pointer, bool forward )
+{
+  // Step to a time just beyond the given chunk.
+  StkFloat time = ( forward ) ? pointer + chunkSize_ - 0.5 : pointer - 0.5;
+  if ( time < 0.0 || time > fileSize_ - 1.0 ) return -1;
+  return this->findChunk( time, pointer );
+}
+
+void FileWvIn :: readChunk( StkFrames& frames, long pointer )
+{
+  file_.read( frames, pointer, int2floatscaling_ );
+}
+
 StkFrames& FileWvIn :: tick( StkFrames& frames, unsigned int channel)
 {
   if ( finished_ ) {
@@ -16,6 +16,12 @@
     This structure results in one extra multiply per computed sample,
     but allows easy control of the overall filter gain.
 
+    The direct form computation has a cost proportional to the number
+    of coefficients for each sample.  For long impulse responses, the
+    setPartitioning() function selects a partitioned FFT convolution
+    (see the Convolver class) without added latency, in which case the
+    gain is applied at the filter output.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
 /***************************************************/
@@ -26,14 +32,17 @@
 namespace stk {
 
 Fir :: Fir()
+  : position_( 0 ), partitionSize_( 0 ), uniform_( false )
 {
   // The default constructor should setup for pass-through.
   b_.push_back( 1.0 );
 
-  inputs_.resize( 1, 1, 0.0 );
+  inputs_.resize( 2, 1, 0.0 );
+  buffer_.resize( BLOCK_SIZE );
 }
 
 Fir :: Fir( std::vector<StkFloat> &coefficients )
+  : position_( 0 ), partitionSize_( 0 ), uniform_( false )
 {
   // Check the arguments.
   if ( coefficients.size() == 0 ) {
@@ -44,7 +53,8 @@ Fir :: Fir( std::vector<StkFloat> &coefficients )
   gain_ = 1.0;
   b_ = coefficients;
 
-  inputs_.resize( b_.size(), 1, 0.0 );
+  inputs_.resize( 2 * b_.size(), 1, 0.0 );
+  buffer_.resize( b_.size() - 1 + BLOCK_SIZE );
   this->clear();
 }
 
@@ -62,13 +72,125 @@ void Fir :: setCoefficients( std::vector<StkFloat> &coefficients, bool clearStat
 
   if ( b_.size() != coefficients.size() ) {
     b_ = coefficients;
-    inputs_.resize( b_.size(), 1, 0.0 );
+    inputs_.resize( 2 * b_.size(), channelsIn_, 0.0 );
+    position_ = 0;
+    buffer_.resize( b_.size() - 1 + BLOCK_SIZE );
   }
   else {
     for ( unsigned int i=0; i<b_.size(); i++ ) b_[i] = coefficients[i];
   }
 
-  if ( clearState ) this->clear();
+  // The convolvers are cleared when their impulse response is set.
+  if ( !convolvers_.empty() ) this->setConvolvers();
+  else if ( clearState ) this->clear();
+}
+
+void Fir :: setChannels( unsigned int nChannels )
+{
+  this->setStateChannels( nChannels );
+  if ( partitionSize_ > 0 ) this->setConvolvers();
+}
+
+void Fir :: setPartitioning( unsigned int blockSize, bool uniform )
+{
+  if ( blockSize > 0 && ( blockSize < 16 || ( blockSize & ( blockSize - 1 ) ) ) ) {
+    oStream_ << "Fir::setPartitioning: block size (" << blockSize << ") must be zero or a power of two greater than or equal to 16!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  partitionSize_ = blockSize;
+  uniform_ = uniform;
+  if ( partitionSize_ > 0 ) this->setConvolvers();
+  else convolvers_.clear();
+  this->clear();
+}
+
+void Fir :: setConvolvers( void )
+{
+  convolvers_.resize( channelsIn_ );
+  for ( unsigned int j=0; j<channelsIn_; j++ ) {
+    convolvers_[j].setPartitioning( partitionSize_, uniform_ );
+    convolvers_[j].setImpulse( b_ );
+  }
+}
+
+void Fir :: clear( void )
+{
+  Filter::clear();
+  for ( unsigned int j=0; j<convolvers_.size(); j++ )
+    convolvers_[j].clear();
+}
+
+void Fir :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return;
+
+  if ( !convolvers_.empty() ) {
+    const StkFloat gain = gain_;
+    for ( unsigned int j=0; j<channelsIn_; j++ ) {
+      StkFloat *out = output + j;
+      convolvers_[j].tick( input + j, iHop, out, oHop, nFrames );
+      if ( gain != 1.0 ) {
+        for ( unsigned long i=0; i<nFrames; i++ )
+          out[i * oHop] *= gain;
+      }
+      lastFrame_[j] = out[(nFrames-1) * oHop];
+    }
+    return;
+  }
+
+  // Each channel is filtered in blocks of frames.  The gained inputs
+  // of a block follow the previous ones in the buffer (oldest first),
+  // so that each coefficient is applied to the whole block in a loop
+  // over contiguous values.  The terms are summed in the same order
+  // as by the single-sample tick() function.  The most recent inputs
+  // are stored back in the circular buffer from position 0.
+  const unsigned int nChannels = channelsIn_;
+  const unsigned int length = (unsigned int) b_.size();
+  const int order = (int) length - 1;
+  const StkFloat gain = gain_;
+  const StkFloat *b = &b_[0];
+  StkFloat y[BLOCK_SIZE];
+  StkFloat *x = &buffer_[order];
+  unsigned long count;
+  unsigned int i, n = 0;
+  int k;
+
+  for ( unsigned int j=0; j<nChannels; j++ ) {
+    const StkFloat *in = input + j;
+    StkFloat *out = output + j;
+    for ( k=1; k<=order; k++ )
+      x[-k] = inputs_[( position_ + k - 1 ) * nChannels + j];
+
+    for ( count=nFrames; count>0; count-=n ) {
+      n = ( count < BLOCK_SIZE ) ? (unsigned int) count : BLOCK_SIZE;
+      for ( i=0; i<n; i++ ) {
+        x[i] = gain * in[i * iHop];
+        y[i] = 0.0;
+      }
+
+      for ( k=order; k>=0; k-- ) {
+        const StkFloat *xk = x - k;
+        for ( i=0; i<n; i++ )
+          y[i] += b[k] * xk[i];
+      }
+
+      for ( i=0; i<n; i++ )
+        out[i * oHop] = y[i];
+
+      for ( k=0; k<order; k++ ) // keep the most recent inputs
+        buffer_[k] = buffer_[n+k];
+
+      in += n * iHop;
+      out += n * oHop;
+    }
+
+    for ( k=1; k<=order; k++ )
+      inputs_[( k - 1 ) * nChannels + j] = inputs_[( k - 1 + length ) * nChannels + j] = x[-k];
+    lastFrame_[j] = y[n-1];
+  }
+
+  position_ = 0;
 }
 
 } // stk namespace
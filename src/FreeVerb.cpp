@@ -16,6 +16,7 @@
 
 #include "FreeVerb.h"
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 
 using namespace stk;
@@ -31,6 +32,7 @@ int FreeVerb::cDelayLengths[] = {1617, 1557, 1491, 1422, 1356, 1277, 1188, 1116}
 int FreeVerb::aDelayLengths[] = {225, 556, 441, 341};
 
 FreeVerb::FreeVerb( void )
+  : combs_( 2 * nCombs, 2 )
 {
   // Resize lastFrame_ for stereo output
   lastFrame_.resize( 1, 2, 0.0 );
@@ -48,33 +50,34 @@ FreeVerb::FreeVerb( void )
 
   // Scale delay line lengths according to the current sampling rate
   double fsScale = Stk::sampleRate() / 44100.0;
-  if ( fsScale != 1.0 ) {
-    // scale comb filter delay lines
-    for ( int i = 0; i < nCombs; i++ ) {
-      cDelayLengths[i] = (int) floor(fsScale * cDelayLengths[i]);
-    }
-
-    // Scale allpass filter delay lines
-    for ( int i = 0; i < nAllpasses; i++ ) {
-      aDelayLengths[i] = (int) floor(fsScale * aDelayLengths[i]);
-    }
-  }
-
-  // Initialize delay lines for the LBFC filters
+  int combLengths[nCombs], allpassLengths[nAllpasses];
+  for ( int i = 0; i < nCombs; i++ )
+    combLengths[i] = (int) floor(fsScale * cDelayLengths[i]);
+  for ( int i = 0; i < nAllpasses; i++ )
+    allpassLengths[i] = (int) floor(fsScale * aDelayLengths[i]);
+
+  // Initialize delay lines for the LBFC filters, the left channel
+  // lines feeding the first output and the right channel lines the
+  // second one.
   for ( int i = 0; i < nCombs; i++ ) {
-    combDelayL_[i].setMaximumDelay( cDelayLengths[i] );
-    combDelayL_[i].setDelay( cDelayLengths[i] );
-    combDelayR_[i].setMaximumDelay( cDelayLengths[i] + stereoSpread );
-    combDelayR_[i].setDelay( cDelayLengths[i] + stereoSpread );
+    combs_.setDelay( i, combLengths[i] );
+    combs_.setOutputGain( i, 0, 1.0 );
+    combs_.setOutputGain( i, 1, 0.0 );
+    combs_.setDelay( i + nCombs, combLengths[i] + stereoSpread );
+    combs_.setOutputGain( i + nCombs, 0, 0.0 );
+    combs_.setOutputGain( i + nCombs, 1, 1.0 );
   }
 
   // initialize delay lines for the allpass filters
   for (int i = 0; i < nAllpasses; i++) {
-    allPassDelayL_[i].setMaximumDelay( aDelayLengths[i] );
-    allPassDelayL_[i].setDelay( aDelayLengths[i] );
-    allPassDelayR_[i].setMaximumDelay( aDelayLengths[i] + stereoSpread );
-    allPassDelayR_[i].setDelay( aDelayLengths[i] + stereoSpread );
+    allPassDelayL_[i].setMaximumDelay( allpassLengths[i] );
+    allPassDelayL_[i].setDelay( allpassLengths[i] );
+    allPassDelayR_[i].setMaximumDelay( allpassLengths[i] + stereoSpread );
+    allPassDelayR_[i].setDelay( allpassLengths[i] + stereoSpread );
   }
+
+  combInputs_.resize( RT_BUFFER_SIZE, 1, 0.0 );
+  combOutputs_.resize( RT_BUFFER_SIZE, 2, 0.0 );
 }
 
 FreeVerb::~FreeVerb()
@@ -156,20 +159,16 @@ void FreeVerb::update()
     gain_ = fixedGain;
   }
 
-  for ( int i=0; i<nCombs; i++ ) {
-    // set low pass filter for delay output
-    combLPL_[i].setCoefficients(1.0 - damp_, -damp_);
-    combLPR_[i].setCoefficients(1.0 - damp_, -damp_);
-  }
+  // set low pass filter for delay output and feedback gain
+  combs_.setDamping( damp_ );
+  for ( int i=0; i<2*nCombs; i++ )
+    combs_.setFeedback( i, roomSize_ );
 }
 
 void FreeVerb::clear()
 {
   // Clear LBFC delay lines
-  for ( int i = 0; i < nCombs; i++ ) {
-    combDelayL_[i].clear();
-    combDelayR_[i].clear();
-  }
+  combs_.clear();
 
   // Clear allpass delay lines
   for ( int i = 0; i < nAllpasses; i++ ) {
@@ -190,11 +189,22 @@ StkFrames& FreeVerb::tick( StkFrames& frames, unsigned int channel )
   }
 #endif
 
+  // Compute the comb filters for blocks of samples.
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    *samples = tick( *samples, *(samples+1) );
-    *(samples+1) = lastFrame_[1];
+  for ( size_t i=0; i<frames.frames(); i+=RT_BUFFER_SIZE ) {
+    size_t j, nFrames = std::min( frames.frames() - i, (size_t) RT_BUFFER_SIZE );
+    combInputs_.resize( nFrames, 1 );
+    combOutputs_.resize( nFrames, 2 );
+    for ( j=0; j<nFrames; j++ )
+      combInputs_[j] = (samples[j*hop] + samples[j*hop+1]) * gain_;
+    combs_.tick( combInputs_, combOutputs_ );
+
+    for ( j=0; j<nFrames; j++, samples += hop ) {
+      tickAllpasses( combOutputs_(j,0), combOutputs_(j,1), *samples, *(samples+1) );
+      *samples = lastFrame_[0];
+      *(samples+1) = lastFrame_[1];
+    }
   }
 
   return frames;
@@ -214,13 +224,19 @@ StkFrames& FreeVerb::tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int
   unsigned int iHop = iFrames.channels();
   unsigned int oHop = oFrames.channels();
   bool stereoInput = ( iFrames.channels() > iChannel+1 ) ? true : false;
-  for ( unsigned int i=0; i<iFrames.frames(); i++, iSamples += iHop, oSamples += oHop) {
-    if ( stereoInput )
-      *oSamples = tick( *iSamples, *(iSamples+1) );
-    else
-      *oSamples = tick( *iSamples );
-
-    *(oSamples+1) = lastFrame_[1];
+  for ( size_t i=0; i<iFrames.frames(); i+=RT_BUFFER_SIZE ) {
+    size_t j, nFrames = std::min( iFrames.frames() - i, (size_t) RT_BUFFER_SIZE );
+    combInputs_.resize( nFrames, 1 );
+    combOutputs_.resize( nFrames, 2 );
+    for ( j=0; j<nFrames; j++ )
+      combInputs_[j] = ( stereoInput ) ? (iSamples[j*iHop] + iSamples[j*iHop+1]) * gain_ : (iSamples[j*iHop] + 0.0) * gain_;
+    combs_.tick( combInputs_, combOutputs_ );
+
+    for ( j=0; j<nFrames; j++, iSamples += iHop, oSamples += oHop ) {
+      tickAllpasses( combOutputs_(j,0), combOutputs_(j,1), *iSamples, ( stereoInput ) ? *(iSamples+1) : 0.0 );
+      *oSamples = lastFrame_[0];
+      *(oSamples+1) = lastFrame_[1];
+    }
   }
 
   return oFrames;
@@ -20,6 +20,11 @@
     This structure results in one extra multiply per computed sample,
     but allows easy control of the overall filter gain.
 
+    High-order filters in this direct form are sensitive to coefficient
+    rounding.  They can instead be implemented as a cascade of
+    second-order sections with the setSections() function, which is
+    numerically more robust and faster.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
 /***************************************************/
@@ -29,16 +34,18 @@
 namespace stk {
 
 Iir :: Iir()
+  : inPosition_( 0 ), outPosition_( 0 )
 {
   // The default constructor should setup for pass-through.
   b_.push_back( 1.0 );
   a_.push_back( 1.0 );
 
-  inputs_.resize( 1, 1, 0.0 );
-  outputs_.resize( 1, 1, 0.0 );
+  inputs_.resize( 2, 1, 0.0 );
+  outputs_.resize( 2, 1, 0.0 );
 }
 
 Iir :: Iir( std::vector<StkFloat> &bCoefficients, std::vector<StkFloat> &aCoefficients )
+  : inPosition_( 0 ), outPosition_( 0 )
 {
   // Check the arguments.
   if ( bCoefficients.size() == 0 || aCoefficients.size() == 0 ) {
@@ -55,8 +62,8 @@ Iir :: Iir( std::vector<StkFloat> &bCoefficients, std::vector<StkFloat> &aCoeffi
   b_ = bCoefficients;
   a_ = aCoefficients;
 
-  inputs_.resize( b_.size(), 1, 0.0 );
-  outputs_.resize( a_.size(), 1, 0.0 );
+  inputs_.resize( 2 * b_.size(), 1, 0.0 );
+  outputs_.resize( 2 * a_.size(), 1, 0.0 );
   this->clear();
 }
 
@@ -80,9 +87,17 @@ void Iir :: setNumerator( std::vector<StkFloat> &bCoefficients, bool clearState
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 
+  if ( !sections_.empty() ) {
+    // Return to the direct form.
+    sections_.clear();
+    sectionStates_.clear();
+    clearState = true;
+  }
+
   if ( b_.size() != bCoefficients.size() ) {
     b_ = bCoefficients;
-    inputs_.resize( b_.size(), 1, 0.0 );
+    inputs_.resize( 2 * b_.size(), 1, 0.0 );
+    inPosition_ = 0;
   }
   else {
     for ( unsigned int i=0; i<b_.size(); i++ ) b_[i] = bCoefficients[i];
@@ -104,9 +119,17 @@ void Iir :: setDenominator( std::vector<StkFloat> &aCoefficients, bool clearStat
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 
+  if ( !sections_.empty() ) {
+    // Return to the direct form.
+    sections_.clear();
+    sectionStates_.clear();
+    clearState = true;
+  }
+
   if ( a_.size() != aCoefficients.size() ) {
     a_ = aCoefficients;
-    outputs_.resize( a_.size(), 1, 0.0 );
+    outputs_.resize( 2 * a_.size(), 1, 0.0 );
+    outPosition_ = 0;
   }
   else {
     for ( unsigned int i=0; i<a_.size(); i++ ) a_[i] = aCoefficients[i];
@@ -122,4 +145,115 @@ void Iir :: setDenominator( std::vector<StkFloat> &aCoefficients, bool clearStat
   }
 }
 
+void Iir :: setSections( std::vector<StkFloat> &sections, bool clearState )
+{
+  // Check the argument.
+  if ( sections.size() == 0 || sections.size() % 6 != 0 ) {
+    oStream_ << "Iir::setSections: coefficient vector size must be a positive multiple of 6!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  size_t i, j, k, nSections = sections.size() / 6;
+  for ( i=0; i<nSections; i++ ) {
+    if ( sections[6*i+3] == 0.0 ) {
+      oStream_ << "Iir::setSections: a[0] coefficient of section " << i << " cannot == 0!";
+      handleError( StkError::FUNCTION_ARGUMENT );
+    }
+  }
+
+  if ( sectionStates_.size() != 2 * nSections ) {
+    sectionStates_.assign( 2 * nSections, 0.0 );
+    clearState = true;
+  }
+
+  // Normalize the coefficients of each section by its a[0] and
+  // multiply the numerators and denominators.
+  std::vector<StkFloat> b( 1, 1.0 ), a( 1, 1.0 ), product;
+  sections_.resize( 5 * nSections );
+  for ( i=0; i<nSections; i++ ) {
+    const StkFloat *section = &sections[6*i];
+    StkFloat *c = &sections_[5*i];
+    for ( j=0; j<3; j++ ) c[j] = section[j] / section[3];
+    c[3] = section[4] / section[3];
+    c[4] = section[5] / section[3];
+    StkFloat numerator[3] = { c[0], c[1], c[2] };
+    StkFloat denominator[3] = { 1.0, c[3], c[4] };
+
+    product.assign( b.size() + 2, 0.0 );
+    for ( j=0; j<b.size(); j++ )
+      for ( k=0; k<3; k++ ) product[j+k] += b[j] * numerator[k];
+    b = product;
+
+    product.assign( a.size() + 2, 0.0 );
+    for ( j=0; j<a.size(); j++ )
+      for ( k=0; k<3; k++ ) product[j+k] += a[j] * denominator[k];
+    a = product;
+  }
+
+  if ( b_.size() != b.size() ) {
+    inputs_.resize( 2 * b.size(), 1, 0.0 );
+    inPosition_ = 0;
+  }
+  if ( a_.size() != a.size() ) {
+    outputs_.resize( 2 * a.size(), 1, 0.0 );
+    outPosition_ = 0;
+  }
+  b_ = b;
+  a_ = a;
+
+  if ( clearState ) this->clear();
+}
+
+void Iir :: clear( void )
+{
+  Filter::clear();
+  for ( unsigned int i=0; i<sectionStates_.size(); i++ )
+    sectionStates_[i] = 0.0;
+}
+
+void Iir :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return;
+
+  const StkFloat gain = gain_;
+  if ( !sections_.empty() ) {
+    // The sections of one frame are computed in turn, so that the
+    // computations of successive sections (and frames) can overlap.
+    for ( unsigned long i=0; i<nFrames; i++ )
+      output[i * oHop] = this->tickSections( gain * input[i * iHop] );
+    lastFrame_[0] = output[(nFrames-1) * oHop];
+    return;
+  }
+
+  // Direct form, with the circular buffer positions in local
+  // variables.
+  const size_t nb = b_.size(), na = a_.size();
+  const StkFloat *b = &b_[0], *a = &a_[0];
+  StkFloat *inputs = &inputs_[0], *outputs = &outputs_[0];
+  size_t inPosition = inPosition_, outPosition = outPosition_, k;
+  StkFloat y = 0.0;
+  for ( unsigned long i=0; i<nFrames; i++ ) {
+    inPosition = ( inPosition == 0 ? nb : inPosition ) - 1;
+    StkFloat *x = inputs + inPosition;
+    x[0] = x[nb] = gain * input[i * iHop];
+
+    y = 0.0;
+    for ( k=nb-1; k>0; k-- )
+      y += b[k] * x[k];
+    y += b[0] * x[0];
+
+    outPosition = ( outPosition == 0 ? na : outPosition ) - 1;
+    StkFloat *yp = outputs + outPosition;
+    for ( k=na-1; k>0; k-- )
+      y += -a[k] * yp[k];
+    yp[0] = yp[na] = y;
+
+    output[i * oHop] = y;
+  }
+
+  inPosition_ = (unsigned int) inPosition;
+  outPosition_ = (unsigned int) outPosition;
+  lastFrame_[0] = y;
+}
+
 } // stk namespace
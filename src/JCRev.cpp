@@ -21,10 +21,12 @@
 
 #include "JCRev.h"
 #include <cmath>
+#include <algorithm>
 
 namespace stk {
 
 JCRev :: JCRev( StkFloat T60 )
+  : combs_( 4, 1 )
 {
   if ( T60 <= 0.0 ) {
     oStream_ << "JCRev::JCRev: argument (" << T60 << ") must be positive!";
@@ -52,11 +54,14 @@ JCRev :: JCRev( StkFloat T60 )
 	  allpassDelays_[i].setDelay( lengths[i+4] );
   }
 
+  // The feedback loops of the comb filters are one sample longer
+  // than their delay lengths, which set the decay time, and all the
+  // comb filters are summed.
   for ( i=0; i<4; i++ ) {
-    combDelays_[i].setMaximumDelay( lengths[i] );
-    combDelays_[i].setDelay( lengths[i] );
-    combFilters_[i].setPole( 0.2 );
+    combs_.setDelay( i, lengths[i] + 1 );
+    combs_.setOutputGain( i, 0, 1.0 );
   }
+  combs_.setDamping( 0.2 );
 
   this->setT60( T60 );
   outLeftDelay_.setMaximumDelay( lengths[7] );
@@ -65,6 +70,8 @@ JCRev :: JCRev( StkFloat T60 )
   outRightDelay_.setDelay( lengths[8] );
   allpassCoefficient_ = 0.7;
   effectMix_ = 0.3;
+  combInputs_.resize( RT_BUFFER_SIZE, 1, 0.0 );
+  combOutputs_.resize( RT_BUFFER_SIZE, 1, 0.0 );
   this->clear();
 }
 
@@ -73,10 +80,7 @@ void JCRev :: clear()
   allpassDelays_[0].clear();
   allpassDelays_[1].clear();
   allpassDelays_[2].clear();
-  combDelays_[0].clear();
-  combDelays_[1].clear();
-  combDelays_[2].clear();
-  combDelays_[3].clear();
+  combs_.clear();
   outRightDelay_.clear();
   outLeftDelay_.clear();
   lastFrame_[0] = 0.0;
@@ -91,7 +95,7 @@ void JCRev :: setT60( StkFloat T60 )
   }
 
   for ( int i=0; i<4; i++ )
-    combCoefficient_[i] = pow(10.0, (-3.0 * combDelays_[i].getDelay() / (T60 * Stk::sampleRate())));
+    combs_.setFeedback( i, pow(10.0, (-3.0 * (combs_.getDelay( i ) - 1) / (T60 * Stk::sampleRate()))) );
 }
 
 StkFrames& JCRev :: tick( StkFrames& frames, unsigned int channel )
@@ -103,11 +107,22 @@ StkFrames& JCRev :: tick( StkFrames& frames, unsigned int channel )
   }
 #endif
 
+  // Compute the comb filters for blocks of samples.
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    *samples = tick( *samples );
-    *(samples+1) = lastFrame_[1];
+  for ( size_t i=0; i<frames.frames(); i+=RT_BUFFER_SIZE ) {
+    size_t j, nFrames = std::min( frames.frames() - i, (size_t) RT_BUFFER_SIZE );
+    combInputs_.resize( nFrames, 1 );
+    combOutputs_.resize( nFrames, 1 );
+    for ( j=0; j<nFrames; j++ )
+      combInputs_[j] = tickAllpasses( samples[j*hop] );
+    combs_.tick( combInputs_, combOutputs_ );
+
+    for ( j=0; j<nFrames; j++, samples += hop ) {
+      tickOutputs( combOutputs_[j], *samples );
+      *samples = 0.7 * lastFrame_[0];
+      *(samples+1) = lastFrame_[1];
+    }
   }
 
   return frames;
@@ -125,9 +140,19 @@ StkFrames& JCRev :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int i
   StkFloat *iSamples = &iFrames[iChannel];
   StkFloat *oSamples = &oFrames[oChannel];
   unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
-  for ( unsigned int i=0; i<iFrames.frames(); i++, iSamples += iHop, oSamples += oHop ) {
-    *oSamples = tick( *iSamples );
-    *(oSamples+1) = lastFrame_[1];
+  for ( size_t i=0; i<iFrames.frames(); i+=RT_BUFFER_SIZE ) {
+    size_t j, nFrames = std::min( iFrames.frames() - i, (size_t) RT_BUFFER_SIZE );
+    combInputs_.resize( nFrames, 1 );
+    combOutputs_.resize( nFrames, 1 );
+    for ( j=0; j<nFrames; j++ )
+      combInputs_[j] = tickAllpasses( iSamples[j*iHop] );
+    combs_.tick( combInputs_, combOutputs_ );
+
+    for ( j=0; j<nFrames; j++, iSamples += iHop, oSamples += oHop ) {
+      tickOutputs( combOutputs_[j], *iSamples );
+      *oSamples = 0.7 * lastFrame_[0];
+      *(oSamples+1) = lastFrame_[1];
+    }
   }
 
   return iFrames;
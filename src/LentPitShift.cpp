@@ -3,7 +3,8 @@
     \brief Pitch shifter effect class based on the Lent algorithm.
 
     This class implements a pitch shifter using pitch 
-    tracking and sample windowing and shifting.
+    tracking and sample windowing and shifting.  The
+    pitch is tracked by the PitchTracker class.
 
     by Francois Germain, 2009.
 */
@@ -14,16 +15,9 @@
 namespace stk {
 
 LentPitShift::LentPitShift( StkFloat periodRatio, int tMax )
-  : inputFrames(0.,tMax,1), outputFrames(0.,tMax,1), ptrFrames(0), inputPtr(0), outputPtr(0.), tMax_(tMax), periodRatio_(periodRatio), zeroFrame(0., tMax, 1)
+  : inputFrames(0.,tMax,1), outputFrames(0.,tMax,1), ptrFrames(0), inputPtr(0), outputPtr(0.), tMax_(tMax), tracker_(tMax), periodRatio_(periodRatio), zeroFrame(0., tMax, 1)
 {
 	window = new StkFloat[2*tMax_]; // Allocation of the array for the hamming window
-	threshold_ = 0.1;               // Default threshold for pitch tracking
-
-	dt = new StkFloat[tMax+1]; // Allocation of the euclidian distance coefficient array.  The first one is never used.
-	cumDt = new StkFloat[tMax+1];  // Allocation of the cumulative sum array
-	cumDt[0] = 0.;                 // Initialization of the first coefficient of the cumulative sum
-	dpt = new StkFloat[tMax+1];    // Allocation of the pitch tracking function coefficient array
-	dpt[0]   = 1.;                 // Initialization of the first coefficient of dpt which is always the same
 
 	// Initialisation of the input and output delay lines
 	inputLine_.setMaximumDelay( 3 * tMax_ );
@@ -41,6 +35,7 @@ void LentPitShift :: clear()
 {
 	inputLine_.clear();
 	outputLine_.clear();
+	tracker_.clear();
 }
 
 void LentPitShift :: setShift( StkFloat shift )
@@ -9,6 +9,16 @@
     Waveguide Mesh", Proceedings of the 1993
     International Computer Music Conference.
 
+    The wave variables are stored in contiguous
+    rows, so that the junctions of a row are
+    updated by vectorizable loops, and the mesh
+    dimensions are only limited by memory.  The
+    dimension control changes cover sizes up to
+    NXMAX and NYMAX, while larger meshes can be set
+    with setNX() and setNY().  The rows of large
+    meshes can be computed by several threads (see
+    setThreads()).
+
     This is a digital waveguide model, making its
     use possibly subject to patents held by Stanford
     University, Yamaha, and others.
@@ -26,33 +36,25 @@
 
 #include "Mesh2D.h"
 #include "SKINImsg.h"
+#include <algorithm>
+#include <chrono>
 
 namespace stk {
 
 Mesh2D :: Mesh2D( unsigned short nX, unsigned short nY )
+  : NX_( 2 ), NY_( 2 ), maxX_( 0 ), maxY_( 0 ), stride_( 0 ), decay_( 0.99 ),
+    nThreads_( 1 ), step_( 0 ), finished_( 0 ), running_( false )
 {
   if ( nX == 0.0 || nY == 0.0 ) {
     oStream_ << "Mesh2D::Mesh2D: one or more argument is equal to zero!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 
+  // Allocate at least the dimensions reached by the control changes.
+  this->resize( std::max( nX, NXMAX ), std::max( nY, NYMAX ) );
   this->setNX( nX );
   this->setNY( nY );
 
-  StkFloat pole = 0.05;
-  unsigned short i;
-  for ( i=0; i<NYMAX; i++ ) {
-    filterY_[i].setPole( pole );
-    filterY_[i].setGain( 0.99 );
-  }
-
-  for ( i=0; i<NXMAX; i++ ) {
-    filterX_[i].setPole( pole );
-    filterX_[i].setGain( 0.99 );
-  }
-
-  this->clearMesh();
-
   counter_ = 0;
   xInput_ = 0;
   yInput_ = 0;
@@ -60,6 +62,40 @@ Mesh2D :: Mesh2D( unsigned short nX, unsigned short nY )
 
 Mesh2D :: ~Mesh2D( void )
 {
+  this->stopThreads();
+}
+
+void Mesh2D :: resize( unsigned short maxX, unsigned short maxY )
+{
+  // Pad the rows to a multiple of four values, for aligned vector
+  // access, and separate the arrays by a few cache lines, so that
+  // they do not start at the same offset within memory pages (which
+  // stalls the loads following stores to another array).  Then copy
+  // the existing wave variables.
+  size_t stride = ( (size_t) maxY + 3 ) & ~( (size_t) 3 );
+  size_t size = maxX * stride + 16, oldSize = maxX_ * stride_ + 16;
+  std::vector<StkFloat> data( 8 * size, 0.0 );
+  for ( unsigned int i=0; i<8; i++ )
+    for ( size_t x=0; x<maxX_; x++ )
+      std::copy( &data_[i * oldSize + x * stride_], &data_[i * oldSize + x * stride_] + maxY_,
+                 &data[i * size + x * stride] );
+
+  data_.swap( data );
+  for ( unsigned int i=0; i<2; i++ ) {
+    waves_[i].xp = &data_[( 4 * i ) * size];
+    waves_[i].xm = &data_[( 4 * i + 1 ) * size];
+    waves_[i].yp = &data_[( 4 * i + 2 ) * size];
+    waves_[i].ym = &data_[( 4 * i + 3 ) * size];
+  }
+
+  OnePole filter( 0.05 );
+  filter.setGain( decay_ );
+  filterX_.resize( maxX, filter );
+  filterY_.resize( maxY, filter );
+
+  maxX_ = maxX;
+  maxY_ = maxY;
+  stride_ = stride;
 }
 
 void Mesh2D :: clear( void )
@@ -78,26 +114,7 @@ void Mesh2D :: clear( void )
 
 void Mesh2D :: clearMesh( void )
 {
-  int x, y;
-  for ( x=0; x<NXMAX-1; x++ ) {
-    for ( y=0; y<NYMAX-1; y++ ) {
-      v_[x][y] = 0;
-    }
-  }
-  for ( x=0; x<NXMAX; x++ ) {
-    for ( y=0; y<NYMAX; y++ ) {
-
-      vxp_[x][y] = 0;
-      vxm_[x][y] = 0;
-      vyp_[x][y] = 0;
-      vym_[x][y] = 0;
-
-      vxp1_[x][y] = 0;
-      vxm1_[x][y] = 0;
-      vyp1_[x][y] = 0;
-      vym1_[x][y] = 0;
-    }
-  }
+  std::fill( data_.begin(), data_.end(), 0.0 );
 }
 
 StkFloat Mesh2D :: energy( void )
@@ -105,35 +122,22 @@ StkFloat Mesh2D :: energy( void )
   // Return total energy contained in wave variables Note that some
   // energy is also contained in any filter delay elements.
 
+  const Waves& waves = waves_[counter_ & 1];
   int x, y;
+  size_t index;
   StkFloat t;
   StkFloat e = 0;
-  if ( counter_ & 1 ) { // Ready for Mesh2D::tick1() to be called.
-    for ( x=0; x<NX_; x++ ) {
-      for ( y=0; y<NY_; y++ ) {
-        t = vxp1_[x][y];
-        e += t*t;
-        t = vxm1_[x][y];
-        e += t*t;
-        t = vyp1_[x][y];
-        e += t*t;
-        t = vym1_[x][y];
-        e += t*t;
-      }
-    }
-  }
-  else { // Ready for Mesh2D::tick0() to be called.
-    for ( x=0; x<NX_; x++ ) {
-      for ( y=0; y<NY_; y++ ) {
-        t = vxp_[x][y];
-        e += t*t;
-        t = vxm_[x][y];
-        e += t*t;
-        t = vyp_[x][y];
-        e += t*t;
-        t = vym_[x][y];
-        e += t*t;
-      }
+  for ( x=0; x<NX_; x++ ) {
+    for ( y=0; y<NY_; y++ ) {
+      index = x * stride_ + y;
+      t = waves.xp[index];
+      e += t*t;
+      t = waves.xm[index];
+      e += t*t;
+      t = waves.yp[index];
+      e += t*t;
+      t = waves.ym[index];
+      e += t*t;
     }
   }
 
@@ -146,11 +150,8 @@ void Mesh2D :: setNX( unsigned short lenX )
     oStream_ << "Mesh2D::setNX(" << lenX << "): Minimum length is 2!";
     handleError( StkError::WARNING ); return;
   }
-  else if ( lenX > NXMAX ) {
-    oStream_ << "Mesh2D::setNX(" << lenX << "): Maximum length is " << NXMAX << '!';
-    handleError( StkError::WARNING ); return;
-  }
 
+  if ( lenX > maxX_ ) this->resize( lenX, maxY_ );
   NX_ = lenX;
 }
 
@@ -160,12 +161,59 @@ void Mesh2D :: setNY( unsigned short lenY )
     oStream_ << "Mesh2D::setNY(" << lenY << "): Minimum length is 2!";
     handleError( StkError::WARNING ); return;
   }
-  else if ( lenY > NYMAX ) {
-    oStream_ << "Mesh2D::setNY(" << lenY << "): Maximum length is " << NXMAX << '!';
+
+  if ( lenY > maxY_ ) this->resize( maxX_, lenY );
+  NY_ = lenY;
+}
+
+void Mesh2D :: setThreads( unsigned int nThreads )
+{
+  if ( nThreads == 0 ) {
+    oStream_ << "Mesh2D::setThreads: the number of threads must be greater than zero!";
     handleError( StkError::WARNING ); return;
   }
 
-  NY_ = lenY;
+  this->stopThreads();
+  nThreads_ = nThreads;
+  running_ = true;
+  for ( unsigned int i=1; i<nThreads_; i++ )
+    threads_.push_back( std::thread( &Mesh2D::runThread, this, i, step_.load() ) );
+}
+
+void Mesh2D :: stopThreads( void )
+{
+  if ( threads_.empty() ) return;
+
+  running_ = false;
+  step_.fetch_add( 1, std::memory_order_release );
+  for ( unsigned int i=0; i<threads_.size(); i++ )
+    threads_[i].join();
+  threads_.clear();
+  nThreads_ = 1;
+}
+
+// Wait actively, yielding to other threads after a while and
+// sleeping when the mesh is not computed for a longer time.
+static void spinWait( unsigned long& spins )
+{
+  if ( ++spins < 1000 ) return;
+  if ( spins < 100000 ) std::this_thread::yield();
+  else std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+}
+
+void Mesh2D :: runThread( unsigned int index, unsigned long step )
+{
+  while ( true ) {
+    unsigned long spins = 0, current;
+    while ( ( current = step_.load( std::memory_order_acquire ) ) == step )
+      spinWait( spins );
+    if ( !running_ ) return;
+    step = current;
+
+    unsigned int rows = NX_ - 1;
+    this->tickRows( rows * index / nThreads_, rows * ( index + 1 ) / nThreads_ );
+    finished_.fetch_add( 1, std::memory_order_release );
+  }
 }
 
 void Mesh2D :: setDecay( StkFloat decayFactor )
@@ -175,11 +223,12 @@ void Mesh2D :: setDecay( StkFloat decayFactor )
     handleError( StkError::WARNING ); return;
   }
 
-  int i;
-  for ( i=0; i<NYMAX; i++ )
+  decay_ = decayFactor;
+  unsigned int i;
+  for ( i=0; i<maxY_; i++ )
     filterY_[i].setGain( decayFactor );
 
-  for (i=0; i<NXMAX; i++)
+  for ( i=0; i<maxX_; i++ )
     filterX_[i].setGain( decayFactor );
 }
 
@@ -202,14 +251,10 @@ void Mesh2D :: setInputPosition( StkFloat xFactor, StkFloat yFactor )
 void Mesh2D :: noteOn( StkFloat frequency, StkFloat amplitude )
 {
   // Input at corner.
-  if ( counter_ & 1 ) {
-    vxp1_[xInput_][yInput_] += amplitude;
-    vyp1_[xInput_][yInput_] += amplitude;
-  }
-  else {
-    vxp_[xInput_][yInput_] += amplitude;
-    vyp_[xInput_][yInput_] += amplitude;
-  }
+  Waves& waves = waves_[counter_ & 1];
+  size_t index = xInput_ * stride_ + yInput_;
+  waves.xp[index] += amplitude;
+  waves.yp[index] += amplitude;
 }
 
 void Mesh2D :: noteOff( StkFloat amplitude )
@@ -219,16 +264,11 @@ void Mesh2D :: noteOff( StkFloat amplitude )
 
 StkFloat Mesh2D :: inputTick( StkFloat input )
 {
-  if ( counter_ & 1 ) {
-    vxp1_[xInput_][yInput_] += input;
-    vyp1_[xInput_][yInput_] += input;
-    lastFrame_[0] = tick1();
-  }
-  else {
-    vxp_[xInput_][yInput_] += input;
-    vyp_[xInput_][yInput_] += input;
-    lastFrame_[0] = tick0();
-  }
+  Waves& waves = waves_[counter_ & 1];
+  size_t index = xInput_ * stride_ + yInput_;
+  waves.xp[index] += input;
+  waves.yp[index] += input;
+  lastFrame_[0] = this->tickMesh();
 
   counter_++;
   return lastFrame_[0];
@@ -236,106 +276,81 @@ StkFloat Mesh2D :: inputTick( StkFloat input )
 
 StkFloat Mesh2D :: tick( unsigned int )
 {
-  lastFrame_[0] = ((counter_ & 1) ? this->tick1() : this->tick0());
+  lastFrame_[0] = this->tickMesh();
   counter_++;
   return lastFrame_[0];
 }
 
 const StkFloat VSCALE = 0.5;
 
-StkFloat Mesh2D :: tick0( void )
+// Update the junctions of a row, given the wave variables of the row
+// (incoming from the junction at x - 1 or y - 1) and those of the
+// next rows (incoming from the junction at x + 1 or y + 1).
+static void updateRow( const StkFloat * __restrict xp, const StkFloat * __restrict xm,
+                       const StkFloat * __restrict yp, const StkFloat * __restrict ym,
+                       StkFloat * __restrict xpOut, StkFloat * __restrict xmOut,
+                       StkFloat * __restrict ypOut, StkFloat * __restrict ymOut, unsigned int n )
 {
-  int x, y;
-  StkFloat outsamp = 0;
-
-  // Update junction velocities.
-  for (x=0; x<NX_-1; x++) {
-    for (y=0; y<NY_-1; y++) {
-      v_[x][y] = ( vxp_[x][y] + vxm_[x+1][y] + 
-		  vyp_[x][y] + vym_[x][y+1] ) * VSCALE;
-    }
-  }    
-
-  // Update junction outgoing waves, using alternate wave-variable buffers.
-  for (x=0; x<NX_-1; x++) {
-    for (y=0; y<NY_-1; y++) {
-      StkFloat vxy = v_[x][y];
-      // Update positive-going waves.
-      vxp1_[x+1][y] = vxy - vxm_[x+1][y];
-      vyp1_[x][y+1] = vxy - vym_[x][y+1];
-      // Update minus-going waves.
-      vxm1_[x][y] = vxy - vxp_[x][y];
-      vym1_[x][y] = vxy - vyp_[x][y];
-    }
-  }    
-
-  // Loop over velocity-junction boundary faces, update edge
-  // reflections, with filtering.  We're only filtering on one x and y
-  // edge here and even this could be made much sparser.
-  for (y=0; y<NY_-1; y++) {
-    vxp1_[0][y] = filterY_[y].tick(vxm_[0][y]);
-    vxm1_[NX_-1][y] = vxp_[NX_-1][y];
+  for ( unsigned int y=0; y<n; y++ ) {
+    StkFloat vxy = ( xp[y] + xm[y] + yp[y] + ym[y] ) * VSCALE;
+    // Update positive-going waves.
+    xpOut[y] = vxy - xm[y];
+    ypOut[y] = vxy - ym[y];
+    // Update minus-going waves.
+    xmOut[y] = vxy - xp[y];
+    ymOut[y] = vxy - yp[y];
   }
-  for (x=0; x<NX_-1; x++) {
-    vyp1_[x][0] = filterX_[x].tick(vym_[x][0]);
-    vym1_[x][NY_-1] = vyp_[x][NY_-1];
-  }
-
-  // Output = sum of outgoing waves at far corner.  Note that the last
-  // index in each coordinate direction is used only with the other
-  // coordinate indices at their next-to-last values.  This is because
-  // the "unit strings" attached to each velocity node to terminate
-  // the mesh are not themselves connected together.
-  outsamp = vxp_[NX_-1][NY_-2] + vyp_[NX_-2][NY_-1];
-
-  return outsamp;
 }
 
-StkFloat Mesh2D :: tick1( void )
+void Mesh2D :: tickRows( unsigned short xBegin, unsigned short xEnd )
 {
-  int x, y;
-  StkFloat outsamp = 0;
-
-  // Update junction velocities.
-  for (x=0; x<NX_-1; x++) {
-    for (y=0; y<NY_-1; y++) {
-      v_[x][y] = ( vxp1_[x][y] + vxm1_[x+1][y] + 
-		  vyp1_[x][y] + vym1_[x][y+1] ) * VSCALE;
-    }
+  // Update junction velocities and outgoing waves, using the
+  // alternate wave-variable buffers.
+  const Waves& in = waves_[counter_ & 1];
+  const Waves& out = waves_[( counter_ + 1 ) & 1];
+  for ( size_t x=xBegin; x<xEnd; x++ ) {
+    size_t row = x * stride_, next = row + stride_;
+    updateRow( in.xp + row, in.xm + next, in.yp + row, in.ym + row + 1,
+               out.xp + next, out.xm + row, out.yp + row + 1, out.ym + row, NY_ - 1 );
   }
+}
 
-  // Update junction outgoing waves, 
-  // using alternate wave-variable buffers.
-  for (x=0; x<NX_-1; x++) {
-    for (y=0; y<NY_-1; y++) {
-      StkFloat vxy = v_[x][y];
-
-      // Update positive-going waves.
-      vxp_[x+1][y] = vxy - vxm1_[x+1][y];
-      vyp_[x][y+1] = vxy - vym1_[x][y+1];
-
-      // Update minus-going waves.
-      vxm_[x][y] = vxy - vxp1_[x][y];
-      vym_[x][y] = vxy - vyp1_[x][y];
-    }
+StkFloat Mesh2D :: tickMesh( void )
+{
+  unsigned int rows = NX_ - 1;
+  if ( threads_.empty() )
+    this->tickRows( 0, rows );
+  else {
+    // Start the other threads and compute the first band of rows.
+    finished_.store( 0, std::memory_order_relaxed );
+    step_.fetch_add( 1, std::memory_order_release );
+    this->tickRows( 0, rows / nThreads_ );
+    unsigned long spins = 0;
+    while ( finished_.load( std::memory_order_acquire ) < threads_.size() )
+      spinWait( spins );
   }
 
   // Loop over velocity-junction boundary faces, update edge
   // reflections, with filtering.  We're only filtering on one x and y
   // edge here and even this could be made much sparser.
-  for (y=0; y<NY_-1; y++) {
-    vxp_[0][y] = filterY_[y].tick(vxm1_[0][y]);
-    vxm_[NX_-1][y] = vxp1_[NX_-1][y];
+  const Waves& in = waves_[counter_ & 1];
+  const Waves& out = waves_[( counter_ + 1 ) & 1];
+  size_t x, y, last = ( NX_ - 1 ) * stride_;
+  for ( y=0; y<(size_t) NY_-1; y++ ) {
+    out.xp[y] = filterY_[y].tick( in.xm[y] );
+    out.xm[last + y] = in.xp[last + y];
   }
-  for (x=0; x<NX_-1; x++) {
-    vyp_[x][0] = filterX_[x].tick(vym1_[x][0]);
-    vym_[x][NY_-1] = vyp1_[x][NY_-1];
+  for ( x=0; x<(size_t) NX_-1; x++ ) {
+    out.yp[x * stride_] = filterX_[x].tick( in.ym[x * stride_] );
+    out.ym[x * stride_ + NY_ - 1] = in.yp[x * stride_ + NY_ - 1];
   }
 
-  // Output = sum of outgoing waves at far corner.
-  outsamp = vxp1_[NX_-1][NY_-2] + vyp1_[NX_-2][NY_-1];
-
-  return outsamp;
+  // Output = sum of outgoing waves at far corner.  Note that the last
+  // index in each coordinate direction is used only with the other
+  // coordinate indices at their next-to-last values.  This is because
+  // the "unit strings" attached to each velocity node to terminate
+  // the mesh are not themselves connected together.
+  return in.xp[last + NY_ - 2] + in.yp[last - stride_ + NY_ - 1];
 }
 
 void Mesh2D :: controlChange( int number, StkFloat value )
@@ -0,0 +1,72 @@
+/***************************************************/
+/*! \class MessageQueue
+    \brief STK multi-producer / single-consumer control message queue.
+
+    This class implements a bounded, lock-free queue of
+    Skini::Message structures for passing control messages from any
+    number of producer threads (for example, MIDI, socket and stdin
+    input threads) to one consumer thread (typically an audio
+    callback), using the BoundedQueue class template.
+
+    Neither push() nor pop() blocks, locks or allocates memory.  When
+    the queue is full, push() returns \c false immediately and the
+    overrun counter is incremented.  Each message is stored with the
+    time at which it was pushed.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "MessageQueue.h"
+#include <chrono>
+
+namespace stk {
+
+MessageQueue :: MessageQueue( unsigned long nMessages )
+  : queue_( nMessages )
+{
+}
+
+MessageQueue :: ~MessageQueue( void )
+{
+}
+
+void MessageQueue :: resize( unsigned long nMessages )
+{
+  queue_.resize( nMessages );
+}
+
+void MessageQueue :: reset( void )
+{
+  queue_.reset();
+}
+
+bool MessageQueue :: push( const Skini::Message& message, double timeStamp )
+{
+  unsigned long position;
+  Item *item = queue_.claim( position );
+  if ( !item ) return false;
+
+  item->message = message;
+  item->timeStamp = timeStamp;
+  queue_.publish( position );
+  return true;
+}
+
+bool MessageQueue :: pop( Skini::Message& message, double *timeStamp )
+{
+  Item *item = queue_.front();
+  if ( !item ) return false;
+
+  message = item->message;
+  if ( timeStamp ) *timeStamp = item->timeStamp;
+  queue_.release();
+  return true;
+}
+
+double MessageQueue :: currentTime( void )
+{
+  return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+} // stk namespace
@@ -25,6 +25,13 @@
     an "exit" or "Exit" message is received from stdin or when all
     socket connections close and no stdin thread is running.
 
+    The queue is a lock-free MessageQueue, so popMessage() never
+    blocks or allocates memory and can be called from an audio
+    callback.  When the queue is full, MIDI messages are dropped,
+    while the stdin and socket threads hold their current message and
+    retry after a millisecond.  Each queued message carries the time
+    at which it arrived.
+
     This class is primarily for use in STK example programs but it is
     generic enough to work in many other contexts.
 
@@ -55,7 +62,6 @@ MessagerSourceType STK_SOCKET = 0x8;
 Messager :: Messager()
 {
   data_.sources = 0;
-  data_.queueLimit = DEFAULT_QUEUE_LIMIT;
 #if defined(__STK_REALTIME__)
   data_.socket = 0;
   data_.midi = 0;
@@ -64,15 +70,10 @@ Messager :: Messager()
 
 Messager :: ~Messager()
 {
-  // Clear the queue in case any thread is waiting on its limit.
-#if defined(__STK_REALTIME__)
-  data_.mutex.lock();
-#endif
-  while ( data_.queue.size() ) data_.queue.pop();
+  // Stop the input threads, including any waiting for queue space.
   data_.sources = 0;
 
 #if defined(__STK_REALTIME__)
-  data_.mutex.unlock();
   if ( data_.socket ) {
     socketThread_.wait();
     delete data_.socket;
@@ -101,40 +102,28 @@ bool Messager :: setScoreFile( const char* filename )
   return true;
 }
 
-void Messager :: popMessage( Skini::Message& message )
+bool Messager :: isScoreInput( void ) const
+{
+  return data_.sources == STK_FILE;
+}
+
+void Messager :: popMessage( Skini::Message& message, double *timeStamp )
 {
   if ( data_.sources == STK_FILE ) { // scorefile input
     if ( !data_.skini.nextMessage( message ) )
       message.type = __SK_Exit_;
+    if ( timeStamp ) *timeStamp = MessageQueue::currentTime();
     return;
   }
 
-  if ( data_.queue.size() == 0 ) {
-    // An empty (or invalid) message is indicated by a type = 0.
+  // An empty (or invalid) message is indicated by a type = 0.
+  if ( !data_.queue.pop( message, timeStamp ) )
     message.type = 0;
-    return;
-  }
-
-  // Copy queued message to the message pointer structure and then "pop" it.
-#if defined(__STK_REALTIME__)
-  data_.mutex.lock();
-#endif
-  message = data_.queue.front();
-  data_.queue.pop();
-#if defined(__STK_REALTIME__)
-  data_.mutex.unlock();
-#endif
 }
 
-void Messager :: pushMessage( Skini::Message& message )
+bool Messager :: pushMessage( Skini::Message& message )
 {
-#if defined(__STK_REALTIME__)
-  data_.mutex.lock();
-#endif
-  data_.queue.push( message );
-#if defined(__STK_REALTIME__)
-  data_.mutex.unlock();
-#endif
+  return data_.queue.push( message );
 }
 
 #if defined(__STK_REALTIME__)
@@ -163,9 +152,19 @@ bool Messager :: startStdInput()
   return true;
 }
 
+// Queue a message from a text input thread.  If the queue is full,
+// the message is held and retried until there is room or the given
+// input source is stopped.
+static void queueMessage( Messager::MessagerData *data, Skini::Message& message, int source )
+{
+  while ( !data->queue.push( message ) && ( data->sources & source ) )
+    Stk::sleep( 1 );
+}
+
 THREAD_RETURN THREAD_TYPE stdinHandler(void *ptr)
 {
   Messager::MessagerData *data = (Messager::MessagerData *) ptr;
+  Skini skini;
   Skini::Message message;
 
   std::string line;
@@ -174,18 +173,14 @@ THREAD_RETURN THREAD_TYPE stdinHandler(void *ptr)
     if ( line.compare(0, 4, "Exit") == 0 || line.compare(0, 4, "exit") == 0 )
       break;
 
-    data->mutex.lock();
-    if ( data->skini.parseString( line, message ) )
-      data->queue.push( message );
-    data->mutex.unlock();
-
-    while ( data->queue.size() >= data->queueLimit ) Stk::sleep( 50 );
+    if ( skini.parseString( line, message ) )
+      queueMessage( data, message, STK_STDIN );
   }
 
   // We assume here that if someone types an "exit" message in the
   // terminal window, all processing should stop.
   message.type = __SK_Exit_;
-  data->queue.push( message );
+  queueMessage( data, message, STK_STDIN );
   data->sources &= ~STK_STDIN;
 
   return NULL;
@@ -218,11 +213,9 @@ void midiHandler( double timeStamp, std::vector<unsigned char> *bytes, void *ptr
       message.floatValues[1] = (StkFloat) message.intValues[1];
   }
 
-  while ( data->queue.size() >= data->queueLimit ) Stk::sleep( 50 );
-
-  data->mutex.lock();
+  // The RtMidi callback must not wait, so the message is dropped (and
+  // counted) if the queue is full.
   data->queue.push( message );
-  data->mutex.unlock();
 }
 
 bool Messager :: startMidiInput( int port )
@@ -315,6 +308,7 @@ bool Messager :: startSocketInput( int port )
 THREAD_RETURN THREAD_TYPE socketHandler(void *ptr)
 {
   Messager::MessagerData *data = (Messager::MessagerData *) ptr;
+  Skini skini;
   Skini::Message message;
   std::vector<int>& fd = data->fd;
 
@@ -374,15 +368,13 @@ THREAD_RETURN THREAD_TYPE socketHandler(void *ptr)
         while ( index < bytesRead ) {
           line += buffer[index];
           if ( buffer[index++] == '\n' ) {
-            data->mutex.lock();
             if ( line.compare(0, 4, "Exit") == 0 || line.compare(0, 4, "exit") == 0 ) {
               // Ignore this line and assume the connection will be
               // closed on a subsequent read call.
               ;
             }
-            else if ( data->skini.parseString( line, message ) )
-              data->queue.push( message );
-            data->mutex.unlock();
+            else if ( skini.parseString( line, message ) )
+              queueMessage( data, message, STK_SOCKET );
             line.erase();
           }
         }
@@ -410,20 +402,17 @@ THREAD_RETURN THREAD_TYPE socketHandler(void *ptr)
       // Check to see whether all connections are closed.  Note that
       // the server descriptor will always remain.
       if ( fd.size() == 1 ) {
-        data->sources &= ~STK_SOCKET;
         if ( data->sources & STK_MIDI )
           std::cout << "MIDI input still running ... type 'exit<cr>' to quit.\n" << std::endl;
         else if ( !(data->sources & STK_STDIN) ) {
           // No stdin thread running, so quit now.
           message.type = __SK_Exit_;
-          data->queue.push( message );
+          queueMessage( data, message, STK_SOCKET );
         }
+        data->sources &= ~STK_SOCKET;
       }
       fdclose.clear();
     }
-
-    // Wait until we're below the queue limit.
-    while ( data->queue.size() >= data->queueLimit ) Stk::sleep( 50 );
   }
 
   return NULL;
@@ -29,11 +29,8 @@ Modal :: Modal( unsigned int modes )
 
   ratios_.resize( nModes_ );
   radii_.resize( nModes_ );
-  filters_ = (BiQuad **) calloc( nModes_, sizeof(BiQuad *) );
-  for (unsigned int i=0; i<nModes_; i++ ) {
-    filters_[i] = new BiQuad;
-    filters_[i]->setEqualGainZeroes();
-  }
+  filters_.resize( nModes_ );
+  filters_.setEqualGainZeroes();
 
   // Set some default values.
   vibrato_.setFrequency( 6.0 );
@@ -50,17 +47,12 @@ Modal :: Modal( unsigned int modes )
 
 Modal :: ~Modal( void )
 {
-  for ( unsigned int i=0; i<nModes_; i++ ) {
-    delete filters_[i];
-  }
-  free( filters_ );
 }
 
 void Modal :: clear( void )
 {    
   onepole_.clear();
-  for ( unsigned int i=0; i<nModes_; i++ )
-    filters_[i]->clear();
+  filters_.clear();
 }
 
 void Modal :: setFrequency( StkFloat frequency )
@@ -105,7 +97,7 @@ void Modal :: setRatioAndRadius( unsigned int modeIndex, StkFloat ratio, StkFloa
   else
     temp = ratio * baseFrequency_;
 
-  filters_[modeIndex]->setResonance(temp, radius);
+  filters_.setResonance( modeIndex, temp, radius );
 }
 
 void Modal :: setModeGain( unsigned int modeIndex, StkFloat gain )
@@ -115,7 +107,7 @@ void Modal :: setModeGain( unsigned int modeIndex, StkFloat gain )
     handleError( StkError::WARNING ); return;
   }
 
-  filters_[modeIndex]->setGain( gain );
+  filters_.setGain( modeIndex, gain );
 }
 
 void Modal :: strike( StkFloat amplitude )
@@ -137,7 +129,7 @@ void Modal :: strike( StkFloat amplitude )
       temp = -ratios_[i];
     else
       temp = ratios_[i] * baseFrequency_;
-    filters_[i]->setResonance(temp, radii_[i]);
+    filters_.setResonance( i, temp, radii_[i] );
   }
 }
 
@@ -162,7 +154,7 @@ void Modal :: damp( StkFloat amplitude )
       temp = -ratios_[i];
     else
       temp = ratios_[i] * baseFrequency_;
-    filters_[i]->setResonance( temp, radii_[i]*amplitude );
+    filters_.setResonance( i, temp, radii_[i]*amplitude );
   }
 }
 
@@ -16,10 +16,12 @@
 
 #include "NRev.h"
 #include <cmath>
+#include <algorithm>
 
 namespace stk {
 
 NRev :: NRev( StkFloat T60 )
+  : combs_( 6, 1 )
 {
   if ( T60 <= 0.0 ) {
     oStream_ << "NRev::NRev: argument (" << T60 << ") must be positive!";
@@ -39,10 +41,12 @@ NRev :: NRev( StkFloat T60 )
     lengths[i] = delay;
   }
 
+  // The feedback loops of the comb filters are one sample longer
+  // than their delay lengths, which set the decay time and the delay
+  // of their outputs, and all the comb filters are summed.
   for ( i=0; i<6; i++ ) {
-    combDelays_[i].setMaximumDelay( lengths[i] );
-    combDelays_[i].setDelay( lengths[i] );
-    combCoefficient_[i] = pow(10.0, (-3 * lengths[i] / (T60 * Stk::sampleRate())));
+    combs_.setDelay( i, lengths[i] + 1, lengths[i] );
+    combs_.setOutputGain( i, 0, 1.0 );
   }
 
   for ( i=0; i<8; i++ ) {
@@ -53,13 +57,15 @@ NRev :: NRev( StkFloat T60 )
   this->setT60( T60 );
   allpassCoefficient_ = 0.7;
   effectMix_ = 0.3;
+  combInputs_.resize( RT_BUFFER_SIZE, 1, 0.0 );
+  combOutputs_.resize( RT_BUFFER_SIZE, 1, 0.0 );
   this->clear();
 }
 
 void NRev :: clear()
 {
   int i;
-  for (i=0; i<6; i++) combDelays_[i].clear();
+  combs_.clear();
   for (i=0; i<8; i++) allpassDelays_[i].clear();
   lastFrame_[0] = 0.0;
   lastFrame_[1] = 0.0;
@@ -74,7 +80,7 @@ void NRev :: setT60( StkFloat T60 )
   }
 
   for ( int i=0; i<6; i++ )
-    combCoefficient_[i] = pow(10.0, (-3.0 * combDelays_[i].getDelay() / (T60 * Stk::sampleRate())));
+    combs_.setFeedback( i, pow(10.0, (-3.0 * (combs_.getDelay( i ) - 1) / (T60 * Stk::sampleRate()))) );
 }
 
 StkFrames& NRev :: tick( StkFrames& frames, unsigned int channel )
@@ -86,11 +92,22 @@ StkFrames& NRev :: tick( StkFrames& frames, unsigned int channel )
   }
 #endif
 
+  // Compute the comb filters for blocks of samples.
   StkFloat *samples = &frames[channel];
   unsigned int hop = frames.channels();
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    *samples = tick( *samples );
-    *(samples+1) = lastFrame_[1];
+  for ( size_t i=0; i<frames.frames(); i+=RT_BUFFER_SIZE ) {
+    size_t j, nFrames = std::min( frames.frames() - i, (size_t) RT_BUFFER_SIZE );
+    combInputs_.resize( nFrames, 1 );
+    combOutputs_.resize( nFrames, 1 );
+    for ( j=0; j<nFrames; j++ )
+      combInputs_[j] = samples[j*hop];
+    combs_.tick( combInputs_, combOutputs_ );
+
+    for ( j=0; j<nFrames; j++, samples += hop ) {
+      tickOutputs( combOutputs_[j], *samples );
+      *samples = lastFrame_[0];
+      *(samples+1) = lastFrame_[1];
+    }
   }
 
   return frames;
@@ -108,9 +125,19 @@ StkFrames& NRev :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iC
   StkFloat *iSamples = &iFrames[iChannel];
   StkFloat *oSamples = &oFrames[oChannel];
   unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
-  for ( unsigned int i=0; i<iFrames.frames(); i++, iSamples += iHop, oSamples += oHop ) {
-    *oSamples = tick( *iSamples );
-    *(oSamples+1) = lastFrame_[1];
+  for ( size_t i=0; i<iFrames.frames(); i+=RT_BUFFER_SIZE ) {
+    size_t j, nFrames = std::min( iFrames.frames() - i, (size_t) RT_BUFFER_SIZE );
+    combInputs_.resize( nFrames, 1 );
+    combOutputs_.resize( nFrames, 1 );
+    for ( j=0; j<nFrames; j++ )
+      combInputs_[j] = iSamples[j*iHop];
+    combs_.tick( combInputs_, combOutputs_ );
+
+    for ( j=0; j<nFrames; j++, iSamples += iHop, oSamples += oHop ) {
+      tickOutputs( combOutputs_[j], *iSamples );
+      *oSamples = lastFrame_[0];
+      *(oSamples+1) = lastFrame_[1];
+    }
   }
 
   return iFrames;
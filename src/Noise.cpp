@@ -2,9 +2,13 @@
 /*! \class Noise
     \brief STK noise generator.
 
-    Generic random number generation using the
-    C rand() function.  The quality of the rand()
-    function varies from one OS to another.
+    Generic random number generation using a per-instance
+    xorshift128+ generator, which is much faster than the C rand()
+    function, is reentrant (so that separate instances can be used in
+    separate threads) and gives the same sequence for a given seed on
+    all platforms.  Each instance has its own state, so a render with
+    fixed seeds is reproducible regardless of the number of noise
+    generators or threads in use.
 
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
@@ -12,9 +16,23 @@
 
 #include "Noise.h"
 #include <time.h>
+#include <atomic>
 
 namespace stk {
 
+// A count of time-seeded instances, so that generators seeded in the
+// same second differ.
+static std::atomic<unsigned long> instanceCount( 0 );
+
+// The splitmix64 generator, used to spread a seed over the state.
+static unsigned long long splitMix( unsigned long long& x )
+{
+  unsigned long long z = ( x += 0x9E3779B97F4A7C15ULL );
+  z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+  return z ^ ( z >> 31 );
+}
+
 Noise :: Noise( unsigned int seed )
 {
   // Seed the random number generator
@@ -23,10 +41,13 @@ Noise :: Noise( unsigned int seed )
 
 void Noise :: setSeed( unsigned int seed )
 {
+  unsigned long long x = seed;
   if ( seed == 0 )
-    srand( (unsigned int) time( NULL ) );
-  else
-    srand( seed );
+    x = ( (unsigned long long) time( NULL ) << 20 ) ^ instanceCount++;
+
+  state_[0] = splitMix( x );
+  state_[1] = splitMix( x );
+  if ( state_[0] == 0 && state_[1] == 0 ) state_[1] = 1;
 }
 
 } // stk namespace
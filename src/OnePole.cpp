@@ -58,4 +58,39 @@ void OnePole :: setCoefficients( StkFloat b0, StkFloat a1, bool clearState )
   if ( clearState ) this->clear();
 }
 
+void OnePole :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return;
+
+  const StkFloat gain = gain_, b0 = b_[0], a1 = a_[1];
+  unsigned long i;
+  if ( channelsIn_ == 1 ) {
+    StkFloat x = 0.0, y1 = outputs_[1];
+    for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+      x = gain * *input;
+      y1 = b0 * x - a1 * y1;
+      *output = y1;
+    }
+
+    inputs_[0] = x;
+    outputs_[1] = y1;
+    lastFrame_[0] = y1;
+    return;
+  }
+
+  const unsigned int nChannels = channelsIn_;
+  StkFloat *y1 = &outputs_[nChannels];
+  unsigned int j;
+  for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+    for ( j=0; j<nChannels; j++ ) {
+      StkFloat y = b0 * ( gain * input[j] ) - a1 * y1[j];
+      y1[j] = y;
+      output[j] = y;
+    }
+  }
+
+  for ( j=0; j<nChannels; j++ )
+    lastFrame_[j] = y1[j];
+}
+
 } // stk namespace
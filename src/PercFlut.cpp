@@ -33,10 +33,9 @@ namespace stk {
 PercFlut :: PercFlut( void )
   : FM()
 {
-  // Concatenate the STK rawwave path to the rawwave files
-  for ( unsigned int i=0; i<3; i++ )
-    waves_[i] = new FileLoop( (Stk::rawwavePath() + "sinewave.raw").c_str(), true );
-  waves_[3] = new FileLoop( (Stk::rawwavePath() + "fwavblnk.raw").c_str(), true );
+  // The first three waves are sinusoids.  Concatenate the STK
+  // rawwave path to the rawwave file of the last one.
+  waves_[3]->openFile( Stk::rawwavePath() + "fwavblnk.raw" );
 
   this->setRatio(0, 1.50 * 1.000);
   this->setRatio(1, 3.00 * 0.995);
@@ -218,7 +218,7 @@ const char *Phonemes :: name( unsigned int index )
 {
   if ( index > 31 ) {
     oStream_ << "Phonemes::name: index is greater than 31!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0;
   }
   return phonemeNames[index];
@@ -228,7 +228,7 @@ StkFloat Phonemes :: voiceGain( unsigned int index )
 {
   if ( index > 31 ) {
     oStream_ << "Phonemes::voiceGain: index is greater than 31!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   return phonemeGains[index][0];
@@ -238,7 +238,7 @@ StkFloat Phonemes :: noiseGain( unsigned int index )
 {
   if ( index > 31 ) {
     oStream_ << "Phonemes::noiseGain: index is greater than 31!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   return phonemeGains[index][1];
@@ -248,12 +248,12 @@ StkFloat Phonemes :: formantFrequency( unsigned int index, unsigned int partial
 {
   if ( index > 31 ) {
     oStream_ << "Phonemes::formantFrequency: index is greater than 31!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   if ( partial > 3 ) {
     oStream_ << "Phonemes::formantFrequency: partial is greater than 3!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   return phonemeParameters[index][partial][0];
@@ -263,12 +263,12 @@ StkFloat Phonemes :: formantRadius( unsigned int index, unsigned int partial )
 {
   if ( index > 31 ) {
     oStream_ << "Phonemes::formantRadius: index is greater than 31!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   if ( partial > 3 ) {
     oStream_ << "Phonemes::formantRadius: partial is greater than 3!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   return phonemeParameters[index][partial][1];
@@ -278,12 +278,12 @@ StkFloat Phonemes :: formantGain( unsigned int index, unsigned int partial )
 {
   if ( index > 31 ) {
     oStream_ << "Phonemes::formantGain: index is greater than 31!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   if ( partial > 3 ) {
     oStream_ << "Phonemes::formantGain: partial is greater than 3!";
-    handleError( oStream_.str(), StkError::WARNING );
+    handleError( StkError::WARNING );
     return 0.0;
   }
   return phonemeParameters[index][partial][2];
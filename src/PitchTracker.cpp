@@ -0,0 +1,154 @@
+/***************************************************/
+/*! \class PitchTracker
+    \brief STK pitch tracking class based on the difference function.
+
+    This class estimates the period of its input signal for
+    successive frames of samples, with the cumulative mean normalized
+    difference function of the YIN algorithm (de Cheveigne and
+    Kawahara, 2002), as in the LentPitShift class.  The size of the
+    frames is the maximal period which can be detected.
+
+    The difference function of a frame of N samples and the N
+    previous ones is computed for all periods up to N from the
+    autocorrelation, which is computed with an FFT of 2N points (or
+    the next power of two), and the energies of the frame and of the
+    delayed frames.  This takes O(N log N) operations instead of the
+    O(N^2) of the direct computation.
+
+    The detected period is the first minimum of the normalized
+    difference function below the threshold or, without such a
+    minimum, the smallest minimum.  The confidence is one minus the
+    value of the normalized difference function at the period, which
+    is close to one for periodic signals and close to zero for noise.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "PitchTracker.h"
+#include <algorithm>
+
+namespace stk {
+
+PitchTracker :: PitchTracker( unsigned long tMax, StkFloat threshold )
+  : tMax_( tMax ), threshold_( threshold ), period_( tMax ), confidence_( 0.0 ), inputCount_( 0 )
+{
+  if ( tMax == 0 ) {
+    oStream_ << "PitchTracker::PitchTracker: frame size must be greater than zero!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  // The correlations of the frame with the previous and current
+  // frames do not wrap around with a transform of 2 * tMax_ points.
+  unsigned int size = 4;
+  while ( size < 2 * tMax_ ) size *= 2;
+  fft_.setSize( size );
+
+  history_.resize( size, 0.0 );
+  frame_.resize( size, 0.0 );
+  real_.resize( size / 2 + 1 );
+  imag_.resize( size / 2 + 1 );
+  frameReal_.resize( size / 2 + 1 );
+  frameImag_.resize( size / 2 + 1 );
+  correlation_.resize( size );
+  dpt_.resize( tMax_ + 1 );
+}
+
+PitchTracker :: ~PitchTracker( void )
+{
+}
+
+void PitchTracker :: clear( void )
+{
+  std::fill( history_.begin(), history_.end(), 0.0 );
+  std::fill( frame_.begin(), frame_.end(), 0.0 );
+  inputCount_ = 0;
+  period_ = tMax_;
+  confidence_ = 0.0;
+}
+
+void PitchTracker :: setThreshold( StkFloat threshold )
+{
+  if ( threshold < 0.0 ) {
+    oStream_ << "PitchTracker::setThreshold: threshold must be positive!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  threshold_ = threshold;
+}
+
+unsigned long PitchTracker :: analyze( const StkFloat *input, unsigned int stride )
+{
+  unsigned long N = tMax_, tau, n;
+
+  // Append the frame to the previous one.
+  std::copy( history_.begin() + N, history_.begin() + 2 * N, history_.begin() );
+  for ( n=0; n<N; n++ ) {
+    frame_[n] = input[n * stride];
+    history_[N + n] = frame_[n];
+  }
+
+  // Compute the correlation of the frame with the previous and
+  // current frames, r[tau] = sum x[n] x[n - tau] = correlation_[N - tau].
+  fft_.forward( &history_[0], &real_[0], &imag_[0] );
+  fft_.forward( &frame_[0], &frameReal_[0], &frameImag_[0] );
+  for ( n=0; n<real_.size(); n++ ) {
+    StkFloat re = frameReal_[n] * real_[n] + frameImag_[n] * imag_[n];
+    StkFloat im = frameReal_[n] * imag_[n] - frameImag_[n] * real_[n];
+    real_[n] = re;
+    imag_[n] = im;
+  }
+  fft_.inverse( &real_[0], &imag_[0], &correlation_[0] );
+
+  // The difference function d[tau] = sum ( x[n] - x[n - tau] )^2 is
+  // the sum of the energies of the frame and the delayed frame minus
+  // twice the correlation.  Its cumulative mean normalized version
+  // dpt[tau] = tau d[tau] / sum d[1...tau] is then computed, looking
+  // for its first minimum below the threshold.
+  StkFloat energy = 0.0;
+  for ( n=N; n<2*N; n++ )
+    energy += history_[n] * history_[n];
+
+  StkFloat delayedEnergy = energy, cumDt = 0.0;
+  unsigned long alternativePitch = N;  // smallest minimum above the threshold
+  StkFloat minimum = -1.0;
+  period_ = N + 1;
+  dpt_[0] = 1.0;
+  for ( tau=1; tau<=N; tau++ ) {
+    delayedEnergy += history_[N - tau] * history_[N - tau] - history_[2 * N - tau] * history_[2 * N - tau];
+    StkFloat dt = energy + delayedEnergy - 2.0 * correlation_[N - tau];
+    if ( dt < 0.0 ) dt = 0.0;
+    cumDt += dt;
+    dpt_[tau] = dt * tau / cumDt;
+
+    // Look for a minimum.
+    if ( tau > 1 && dpt_[tau-1] - dpt_[tau-2] < 0 && dpt_[tau] - dpt_[tau-1] > 0 ) {
+      if ( dpt_[tau-1] < threshold_ ) {
+        period_ = tau - 1;
+        break;
+      }
+      else if ( minimum < 0.0 || minimum > dpt_[tau-1] ) {
+        alternativePitch = tau - 1;
+        minimum = dpt_[tau-1];
+      }
+    }
+  }
+
+  // Test for a minimum at the maximal period.
+  if ( period_ == N + 1 && N > 1 && dpt_[N] - dpt_[N-1] < 0 ) {
+    if ( dpt_[N] < threshold_ )
+      period_ = N;
+    else if ( minimum < 0.0 || minimum > dpt_[N] )
+      alternativePitch = N;
+  }
+
+  // Without a minimum below the threshold, use the smallest one.
+  if ( period_ == N + 1 ) period_ = alternativePitch;
+
+  confidence_ = 1.0 - dpt_[period_];
+  if ( !( confidence_ > 0.0 ) ) confidence_ = 0.0;
+  else if ( confidence_ > 1.0 ) confidence_ = 1.0;
+  return period_;
+}
+
+} // stk namespace
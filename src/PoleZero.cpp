@@ -70,4 +70,44 @@ void PoleZero :: setBlockZero( StkFloat thePole )
   a_[1] = -thePole;
 }
 
+void PoleZero :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return;
+
+  const StkFloat gain = gain_, b0 = b_[0], b1 = b_[1], a1 = a_[1];
+  unsigned long i;
+  if ( channelsIn_ == 1 ) {
+    StkFloat x, x1 = inputs_[1], y1 = outputs_[1];
+    for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+      x = gain * *input;
+      y1 = b0 * x + b1 * x1 - a1 * y1;
+      x1 = x;
+      *output = y1;
+    }
+
+    inputs_[0] = x1;
+    inputs_[1] = x1;
+    outputs_[1] = y1;
+    lastFrame_[0] = y1;
+    return;
+  }
+
+  const unsigned int nChannels = channelsIn_;
+  StkFloat *x1 = &inputs_[nChannels];
+  StkFloat *y1 = &outputs_[nChannels];
+  unsigned int j;
+  for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+    for ( j=0; j<nChannels; j++ ) {
+      StkFloat x = gain * input[j];
+      StkFloat y = b0 * x + b1 * x1[j] - a1 * y1[j];
+      x1[j] = x;
+      y1[j] = y;
+      output[j] = y;
+    }
+  }
+
+  for ( j=0; j<nChannels; j++ )
+    lastFrame_[j] = y1[j];
+}
+
 } // stk namespace
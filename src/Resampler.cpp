@@ -0,0 +1,310 @@
+/***************************************************/
+/*! \class Resampler
+    \brief STK band-limited interpolation and sample rate conversion class.
+
+    This class computes values of sampled data at arbitrary fractional
+    times with windowed-sinc (Kaiser window) interpolation filters,
+    which avoids most of the aliasing and imaging of linear
+    interpolation.  The filters are tabulated for 256 fractional
+    positions (phases) between samples, with linear interpolation
+    between the phases, so that any rate can be used and the rate can
+    change at any time.  When the data is read faster than its sample
+    rate (a rate greater than one), the filter bandwidth is reduced
+    accordingly and the number of filter taps increases.
+
+    The tables are computed once, when a quality level is first used,
+    and are shared by all instances.  The LINEAR quality uses linear
+    interpolation (a triangular filter, with reduced bandwidth for
+    rates greater than one) and the LOW, MEDIUM and HIGH qualities use
+    windowed-sinc filters with 8, 16 and 32 taps at rates up to one.
+
+    The interpolate() function computes the value of a multi-channel
+    frame at any time of an StkFrames object, as used by the FileWvIn
+    and FileLoop classes.  The process() function provides a streaming
+    converter between arbitrary rates, with an output delay of
+    getLatency() input frames.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "Resampler.h"
+#include <cmath>
+#include <cstring>
+
+namespace stk {
+
+// Zeroth-order modified Bessel function of the first kind.
+static double besselI0( double x )
+{
+  double sum = 1.0, term = 1.0, y = x * x / 4.0;
+  for ( int k=1; k<50 && term > 1.0e-12 * sum; k++ ) {
+    term *= y / ( (double) k * k );
+    sum += term;
+  }
+  return sum;
+}
+
+Resampler :: Table :: Table( Quality quality )
+{
+  // The number of zero crossings on each side, the cutoff frequency
+  // (relative to the Nyquist frequency) and the Kaiser window
+  // parameter of each quality level.
+  static const unsigned int crossings[4] = { 1, 4, 8, 16 };
+  static const double cutoffs[4] = { 1.0, 0.8, 0.88, 0.93 };
+  static const double betas[4] = { 0.0, 5.0, 7.0, 9.0 };
+
+  unsigned int p, k, Z = crossings[quality];
+  double cutoff = cutoffs[quality], beta = betas[quality];
+  zeroCrossings = Z;
+  coefficients.resize( ( PHASES + 1 ) * Z );
+  differences.resize( PHASES * Z );
+
+  for ( p=0; p<=PHASES; p++ ) {
+    for ( k=0; k<Z; k++ ) {
+      double t = k + (double) p / PHASES, h = 0.0;
+      if ( t < Z ) {
+        if ( quality == LINEAR ) h = 1.0 - t;
+        else {
+          double x = cutoff * t, r = t / Z;
+          h = cutoff * ( ( x == 0.0 ) ? 1.0 : sin( PI * x ) / ( PI * x ) );
+          h *= besselI0( beta * sqrt( 1.0 - r * r ) ) / besselI0( beta );
+        }
+      }
+      coefficients[p * Z + k] = h;
+    }
+  }
+
+  // Scale the two sides of each phase (p and PHASES - p) to a unit
+  // sum, so that constant data is reproduced exactly.
+  std::vector<StkFloat> sums( PHASES + 1, 0.0 );
+  for ( p=0; p<=PHASES; p++ )
+    for ( k=0; k<Z; k++ )
+      sums[p] += coefficients[p * Z + k];
+  for ( p=0; p<=PHASES; p++ ) {
+    StkFloat scale = 1.0 / ( sums[p] + sums[PHASES - p] );
+    for ( k=0; k<Z; k++ )
+      coefficients[p * Z + k] *= scale;
+  }
+
+  for ( p=0; p<PHASES; p++ )
+    for ( k=0; k<Z; k++ )
+      differences[p * Z + k] = coefficients[( p + 1 ) * Z + k] - coefficients[p * Z + k];
+}
+
+const Resampler::Table& Resampler :: getTable( Quality quality )
+{
+  switch ( quality ) {
+  case LOW: { static const Table low( LOW ); return low; }
+  case MEDIUM: { static const Table medium( MEDIUM ); return medium; }
+  case HIGH: { static const Table high( HIGH ); return high; }
+  default: { static const Table linear( LINEAR ); return linear; }
+  }
+}
+
+Resampler :: Resampler( Quality quality, unsigned int nChannels )
+  : quality_( quality ), rate_( 1.0 ), nChannels_( 1 ), historyFrames_( 0 ), time_( 0.0 )
+{
+  this->setQuality( quality );
+  this->setChannels( nChannels );
+}
+
+Resampler :: ~Resampler( void )
+{
+}
+
+void Resampler :: setQuality( Quality quality )
+{
+  if ( quality < LINEAR || quality > HIGH ) {
+    oStream_ << "Resampler::setQuality: unknown quality level!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  quality_ = quality;
+  table_ = &getTable( quality );
+  this->setRate( rate_ );
+}
+
+void Resampler :: setRate( StkFloat rate )
+{
+  if ( rate <= 0.0 ) {
+    oStream_ << "Resampler::setRate: rate must be positive!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  // The filter is stretched by the rate when it is greater than one.
+  rate_ = rate;
+  taps_ = table_->zeroCrossings;
+  if ( rate_ > 1.0 ) taps_ = (unsigned int) ceil( taps_ * rate_ );
+  if ( weights_.size() < 2 * taps_ ) weights_.resize( 2 * taps_ );
+}
+
+void Resampler :: setChannels( unsigned int nChannels )
+{
+  if ( nChannels == 0 ) {
+    oStream_ << "Resampler::setChannels: number of channels must be greater than zero!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  nChannels_ = nChannels;
+  history_.resize( 0, nChannels );
+  this->clear();
+}
+
+void Resampler :: clear( void )
+{
+  historyFrames_ = 0;
+  time_ = 0.0;
+}
+
+void Resampler :: setWeights( StkFloat time )
+{
+  // The left taps are at the distances time + k and the right taps
+  // at the distances 1 - time + k, with k = 0 ... taps_ - 1.
+  const StkFloat *c = &table_->coefficients[0], *d = &table_->differences[0];
+  unsigned int k, Z = table_->zeroCrossings;
+  StkFloat *left = &weights_[0], *right = left + taps_;
+
+  if ( rate_ <= 1.0 ) {
+    // One phase for each side, with contiguous coefficients.
+    StkFloat phase = time * PHASES;
+    unsigned int p = (unsigned int) phase;
+    if ( p >= PHASES ) p = PHASES - 1;
+    StkFloat alpha = phase - p;
+    const StkFloat *cp = c + p * Z, *dp = d + p * Z;
+    for ( k=0; k<Z; k++ )
+      left[k] = cp[k] + alpha * dp[k];
+
+    phase = ( 1.0 - time ) * PHASES;
+    p = (unsigned int) phase;
+    if ( p >= PHASES ) p = PHASES - 1;
+    alpha = phase - p;
+    cp = c + p * Z;
+    dp = d + p * Z;
+    for ( k=0; k<Z; k++ )
+      right[k] = cp[k] + alpha * dp[k];
+    return;
+  }
+
+  // The filter is scaled in time and amplitude by the cutoff, so that
+  // the phase steps by cutoff * PHASES for each tap.
+  StkFloat cutoff = 1.0 / rate_, step = cutoff * PHASES;
+  for ( int side=0; side<2; side++ ) {
+    StkFloat *weights = ( side == 0 ) ? left : right;
+    StkFloat phase = ( ( side == 0 ) ? time : 1.0 - time ) * step;
+    for ( k=0; k<taps_; k++, phase += step ) {
+      unsigned long index = (unsigned long) phase;
+      unsigned long column = index / PHASES;
+      if ( column >= Z ) {
+        weights[k] = 0.0;
+        continue;
+      }
+      unsigned long offset = ( index & ( PHASES - 1 ) ) * Z + column;
+      weights[k] = cutoff * ( c[offset] + ( phase - index ) * d[offset] );
+    }
+  }
+}
+
+void Resampler :: compute( const StkFrames& data, unsigned long nFrames, StkFloat time, StkFloat *output, unsigned long loopSize )
+{
+  StkFloat floored = floor( time );
+  long first = (long) floored;
+  this->setWeights( time - floored );
+
+  const StkFloat *left = &weights_[0], *right = left + taps_;
+  unsigned int j, k, K = taps_, nChannels = data.channels();
+  long size = (long) ( ( loopSize > 0 ) ? loopSize : nFrames );
+
+  if ( first >= (long) K - 1 && first + (long) K < size ) {
+    // All taps are within the data.
+    for ( j=0; j<nChannels; j++ ) {
+      size_t index = (size_t) first * nChannels + j;
+      StkFloat sum = 0.0;
+      for ( k=0; k<K; k++ )
+        sum += left[k] * data[index - k * nChannels];
+      index += nChannels;
+      for ( k=0; k<K; k++ )
+        sum += right[k] * data[index + k * nChannels];
+      output[j] = sum;
+    }
+    return;
+  }
+
+  // Wrap the frame indices around the loop or skip those outside of
+  // the data.
+  for ( j=0; j<nChannels; j++ )
+    output[j] = 0.0;
+  for ( int side=0; side<2; side++ ) {
+    const StkFloat *weights = ( side == 0 ) ? left : right;
+    for ( k=0; k<K; k++ ) {
+      long frame = ( side == 0 ) ? first - (long) k : first + 1 + (long) k;
+      if ( loopSize > 0 ) {
+        frame %= size;
+        if ( frame < 0 ) frame += size;
+      }
+      else if ( frame < 0 || frame >= size ) continue;
+      size_t index = (size_t) frame * nChannels;
+      for ( j=0; j<nChannels; j++ )
+        output[j] += weights[k] * data[index + j];
+    }
+  }
+}
+
+void Resampler :: interpolate( const StkFrames& data, StkFloat time, StkFrames& frame, unsigned long loopSize )
+{
+#if defined(_STK_DEBUG_)
+  if ( frame.channels() < data.channels() ) {
+    oStream_ << "Resampler::interpolate(): frame argument has fewer channels than the data!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  if ( data.frames() == 0 ) return;
+  this->compute( data, data.frames(), time, &frame[0], loopSize );
+}
+
+unsigned long Resampler :: process( const StkFrames& input, StkFrames& output )
+{
+  if ( input.channels() != nChannels_ || output.channels() != nChannels_ ) {
+    oStream_ << "Resampler::process(): StkFrames arguments and resampler channels are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT ); return 0;
+  }
+
+  // Append the input frames to the history, growing it if necessary.
+  unsigned long nInput = input.frames();
+  if ( historyFrames_ + nInput > history_.frames() ) {
+    StkFrames history( historyFrames_ + nInput, nChannels_ );
+    if ( historyFrames_ > 0 )
+      memcpy( &history[0], &history_[0], historyFrames_ * nChannels_ * sizeof( StkFloat ) );
+    history_ = history;
+  }
+  for ( size_t i=0; i<nInput * nChannels_; i++ )
+    history_[historyFrames_ * nChannels_ + i] = input[i];
+  historyFrames_ += nInput;
+
+  // Compute the outputs for which all right taps are available.  The
+  // frames before the start of the stream are zero.
+  unsigned long n = 0;
+  while ( n < output.frames() ) {
+    StkFloat floored = floor( time_ );
+    if ( (unsigned long) floored + taps_ >= historyFrames_ ) break;
+    this->compute( history_, historyFrames_, time_, &output[n * nChannels_], 0 );
+    time_ += rate_;
+    n++;
+  }
+
+  // Discard the frames which are no longer needed by the left taps.
+  long first = (long) floor( time_ ) - (long) taps_ + 1;
+  if ( first > 0 ) {
+    if ( (unsigned long) first > historyFrames_ ) first = (long) historyFrames_;
+    unsigned long remaining = historyFrames_ - first;
+    if ( remaining > 0 )
+      memmove( &history_[0], &history_[first * nChannels_], remaining * nChannels_ * sizeof( StkFloat ) );
+    historyFrames_ = remaining;
+    time_ -= first;
+  }
+
+  return n;
+}
+
+} // stk namespace
@@ -0,0 +1,176 @@
+/***************************************************/
+/*! \class RingBuffer
+    \brief STK single-producer / single-consumer audio ring buffer.
+
+    This class implements a wait-free ring buffer of interleaved
+    StkFloat sample frames for passing audio between exactly one
+    producer thread and one consumer thread (for example, a user
+    thread and an RtAudio callback).  The read and write positions are
+    atomic counters kept on separate cache lines and the storage is
+    rounded up to a power of two frames, so that index wrapping is a
+    simple mask, while the capacity stays as requested.
+
+    The read(), write() and region functions never block or lock and
+    can be called from a realtime audio callback.  A short read() is
+    counted as an underrun and a short write() is counted as an
+    overrun.  The waitForData() and waitForSpace() functions allow the
+    non-realtime side to block on a condition variable until the
+    other side has made progress, rather than polling with
+    Stk::sleep().  The realtime side only touches the condition
+    variable while the other side is actually blocked.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "RingBuffer.h"
+
+namespace stk {
+
+RingBuffer :: RingBuffer( unsigned long nFrames, unsigned int nChannels )
+  : size_( 0 ), mask_( 0 ), limit_( 0 ), nChannels_( 0 ), writeIndex_( 0 ), readIndex_( 0 ),
+    underruns_( 0 ), overruns_( 0 ), waiting_( false )
+{
+  this->resize( nFrames, nChannels );
+}
+
+RingBuffer :: ~RingBuffer( void )
+{
+}
+
+void RingBuffer :: resize( unsigned long nFrames, unsigned int nChannels )
+{
+  if ( nChannels == 0 ) {
+    oStream_ << "RingBuffer::resize: the number of channels must be greater than zero!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  size_ = 1;
+  while ( size_ < nFrames ) size_ <<= 1;
+  mask_ = size_ - 1;
+  limit_ = nFrames;
+  nChannels_ = nChannels;
+  data_.resize( size_, nChannels_, 0.0 );
+  this->reset();
+}
+
+void RingBuffer :: reset( void )
+{
+  writeIndex_.store( 0 );
+  readIndex_.store( 0 );
+  underruns_.store( 0 );
+  overruns_.store( 0 );
+}
+
+StkFloat *RingBuffer :: writeRegion( unsigned long *nFrames )
+{
+  unsigned long index = writeIndex_.load( std::memory_order_relaxed ) & mask_;
+  unsigned long contiguous = size_ - index;
+  unsigned long nFree = this->framesFree();
+  *nFrames = ( nFree < contiguous ) ? nFree : contiguous;
+  return &data_[index * nChannels_];
+}
+
+void RingBuffer :: commitWrite( unsigned long nFrames )
+{
+  writeIndex_.store( writeIndex_.load( std::memory_order_relaxed ) + nFrames );
+  this->wake();
+}
+
+StkFloat *RingBuffer :: readRegion( unsigned long *nFrames )
+{
+  unsigned long index = readIndex_.load( std::memory_order_relaxed ) & mask_;
+  unsigned long contiguous = size_ - index;
+  unsigned long nAvailable = this->framesAvailable();
+  *nFrames = ( nAvailable < contiguous ) ? nAvailable : contiguous;
+  return &data_[index * nChannels_];
+}
+
+void RingBuffer :: commitRead( unsigned long nFrames )
+{
+  readIndex_.store( readIndex_.load( std::memory_order_relaxed ) + nFrames );
+  this->wake();
+}
+
+unsigned long RingBuffer :: write( const StkFloat *samples, unsigned long nFrames )
+{
+  unsigned long counter, nSamples, framesWritten = 0;
+  StkFloat *region;
+
+  // At most two contiguous copies are needed to wrap around the end
+  // of the buffer.
+  for ( int i=0; i<2 && framesWritten < nFrames; i++ ) {
+    region = this->writeRegion( &counter );
+    if ( counter == 0 ) break;
+    if ( counter > nFrames - framesWritten ) counter = nFrames - framesWritten;
+    nSamples = counter * nChannels_;
+    memcpy( region, samples, nSamples * sizeof( StkFloat ) );
+    samples += nSamples;
+    framesWritten += counter;
+    this->commitWrite( counter );
+  }
+
+  if ( framesWritten < nFrames )
+    overruns_.fetch_add( 1, std::memory_order_relaxed );
+  return framesWritten;
+}
+
+unsigned long RingBuffer :: read( StkFloat *samples, unsigned long nFrames )
+{
+  unsigned long counter, nSamples, framesRead = 0;
+  StkFloat *region;
+
+  for ( int i=0; i<2 && framesRead < nFrames; i++ ) {
+    region = this->readRegion( &counter );
+    if ( counter == 0 ) break;
+    if ( counter > nFrames - framesRead ) counter = nFrames - framesRead;
+    nSamples = counter * nChannels_;
+    memcpy( samples, region, nSamples * sizeof( StkFloat ) );
+    samples += nSamples;
+    framesRead += counter;
+    this->commitRead( counter );
+  }
+
+  if ( framesRead < nFrames )
+    underruns_.fetch_add( 1, std::memory_order_relaxed );
+  return framesRead;
+}
+
+void RingBuffer :: waitForData( unsigned long nFrames )
+{
+  if ( nFrames > limit_ ) nFrames = limit_;
+  if ( this->framesAvailable() >= nFrames ) return;
+
+  // The waiting_ flag is raised before the final check so that a
+  // concurrent commit either sees it and signals, or publishes its
+  // index before we test it (both sides use sequentially consistent
+  // operations).
+  std::unique_lock<std::mutex> lock( mutex_ );
+  waiting_.store( true );
+  while ( this->framesAvailable() < nFrames )
+    condition_.wait( lock );
+  waiting_.store( false );
+}
+
+void RingBuffer :: waitForSpace( unsigned long nFrames )
+{
+  if ( nFrames > limit_ ) nFrames = limit_;
+  if ( this->framesFree() >= nFrames ) return;
+
+  std::unique_lock<std::mutex> lock( mutex_ );
+  waiting_.store( true );
+  while ( this->framesFree() < nFrames )
+    condition_.wait( lock );
+  waiting_.store( false );
+}
+
+void RingBuffer :: wake( void )
+{
+  // Only take the lock when the other side is actually blocked.
+  if ( waiting_.load() ) {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    condition_.notify_one();
+  }
+}
+
+} // stk namespace
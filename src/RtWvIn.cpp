@@ -4,9 +4,9 @@
 
     This class provides a simplified interface to RtAudio for realtime
     audio input.  It is a subclass of WvIn.  This class makes use of
-    RtAudio's callback functionality by creating a large ring-buffer
-    from which data is read.  This class should not be used when
-    low-latency is desired.
+    RtAudio's callback functionality by creating a large lock-free
+    ring-buffer (see RingBuffer) from which data is read.  This class
+    should not be used when low-latency is desired.
 
     RtWvIn supports multi-channel data in both interleaved and
     non-interleaved formats.  It is important to distinguish the
@@ -33,45 +33,20 @@ int read( void *outputBuffer, void *inputBuffer, unsigned int nBufferFrames,
 }
 
 // This function does not block.  If the user does not read the buffer
-// data fast enough, unread data will be overwritten (data overrun).
+// data fast enough, the newest input data will be discarded (data
+// overrun).
 void RtWvIn :: fillBuffer( void *buffer, unsigned int nFrames )
 {
-  StkFloat *samples = (StkFloat *) buffer;
-  unsigned int counter, iStart, nSamples = nFrames * data_.channels();
-
-  while ( nSamples > 0 ) {
-
-    // I'm assuming that both the RtAudio and StkFrames buffers
-    // contain interleaved data.
-    iStart = writeIndex_ * data_.channels();
-    counter = nSamples;
-
-    // Pre-increment write pointer and check bounds.
-    writeIndex_ += nSamples / data_.channels();
-    if ( writeIndex_ >= data_.frames() ) {
-      writeIndex_ = 0;
-      counter = data_.size() - iStart;
-    }
-
-    // Copy data to the StkFrames container.
-    for ( unsigned int i=0; i<counter; i++ )
-      data_[iStart++] = *samples++;
-
-    nSamples -= counter;
-  }
-
-  mutex_.lock();
-  framesFilled_ += nFrames;
-  mutex_.unlock();
-  if ( framesFilled_ > data_.frames() ) {
-    framesFilled_ = data_.frames();
+  // I'm assuming that both the RtAudio and StkFrames buffers
+  // contain interleaved data.
+  if ( buffer_.write( (StkFloat *) buffer, nFrames ) < nFrames ) {
     oStream_ << "RtWvIn: audio buffer overrun!";
     handleError( StkError::WARNING );
   }
 }
 
 RtWvIn :: RtWvIn( unsigned int nChannels, StkFloat sampleRate, int deviceIndex, int bufferFrames, int nBuffers )
-  : stopped_( true ), readIndex_( 0 ), writeIndex_( 0 ), framesFilled_( 0 )
+  : stopped_( true )
 {
   std::vector<unsigned int> deviceIds = adc_.getDeviceIds();
   if ( deviceIds.size() < 1 )
@@ -94,7 +69,7 @@ RtWvIn :: RtWvIn( unsigned int nChannels, StkFloat sampleRate, int deviceIndex,
     handleError( adc_.getErrorText(), StkError::AUDIO_SYSTEM );
   }
 
-  data_.resize( size * nBuffers, nChannels );
+  buffer_.resize( size * nBuffers, nChannels );
   lastFrame_.resize( 1, nChannels );
 }
 
@@ -124,7 +99,7 @@ void RtWvIn :: stop()
 StkFloat RtWvIn :: tick( unsigned int channel )
 {
 #if defined(_STK_DEBUG_)
-  if ( channel >= data_.channels() ) {
+  if ( channel >= buffer_.channels() ) {
     oStream_ << "RtWvIn::tick(): channel argument is incompatible with streamed channels!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
@@ -133,19 +108,14 @@ StkFloat RtWvIn :: tick( unsigned int channel )
   if ( stopped_ ) this->start();
 
   // Block until at least one frame is available.
-  while ( framesFilled_ == 0 ) Stk::sleep( 1 );
+  buffer_.waitForData( 1 );
 
-  unsigned long index = readIndex_ * lastFrame_.channels();
+  unsigned long nFrames;
+  StkFloat *samples = buffer_.readRegion( &nFrames );
   for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-    lastFrame_[i] = data_[index++];
-
-  mutex_.lock();
-  framesFilled_--;
-  mutex_.unlock();
-  readIndex_++;
-  if ( readIndex_ >= data_.frames() )
-    readIndex_ = 0;
+    lastFrame_[i] = *samples++;
 
+  buffer_.commitRead( 1 );
   return lastFrame_[channel];
 }
 
@@ -161,46 +131,38 @@ StkFrames& RtWvIn :: tick( StkFrames& frames, unsigned int channel )
 
   if ( stopped_ ) this->start();
 
-  // See how much space we have and fill as much as we can ... if we
+  // See how much data we have and read as much as we can ... if we
   // still have space left in the frames object, then wait and repeat.
-  unsigned int nFrames, bytes, framesRead = 0;
+  unsigned long nFrames, framesRead = 0;
+  unsigned int j, hop = frames.channels() - nChannels;
+  StkFloat *fSamples = &frames[channel];
   while ( framesRead < frames.frames() ) {
 
     // Block until we have some input data.
-    while ( framesFilled_ == 0 ) Stk::sleep( 1 );
+    buffer_.waitForData( 1 );
 
-    // Copy data in one chunk up to the end of the data buffer.
-    nFrames = framesFilled_;
-    if ( readIndex_ + nFrames > data_.frames() )
-      nFrames = data_.frames() - readIndex_;
+    // Copy data in one chunk up to the end of the ring buffer.
+    StkFloat *samples = buffer_.readRegion( &nFrames );
     if ( nFrames > frames.frames() - framesRead )
       nFrames = frames.frames() - framesRead;
-    bytes = nFrames * nChannels * sizeof( StkFloat );
-    StkFloat *samples = &data_[readIndex_ * nChannels];
-    unsigned int hop = frames.channels() - nChannels;
-    if ( hop == 0 ) 
-      memcpy( &frames[framesRead * nChannels], samples, bytes );
+    if ( hop == 0 ) {
+      memcpy( fSamples, samples, nFrames * nChannels * sizeof( StkFloat ) );
+      fSamples += nFrames * nChannels;
+    }
     else {
-      StkFloat *fSamples = &frames[channel];
-      unsigned int j;
-      for ( unsigned int i=0; i<frames.frames(); i++, fSamples += hop ) {
-        for ( j=1; j<nChannels; j++ )
+      for ( unsigned long i=0; i<nFrames; i++, fSamples += hop ) {
+        for ( j=0; j<nChannels; j++ )
           *fSamples++ = *samples++;
       }
     }
 
-    readIndex_ += nFrames;
-    if ( readIndex_ == data_.frames() ) readIndex_ = 0;
-
+    buffer_.commitRead( nFrames );
     framesRead += nFrames;
-    mutex_.lock();
-    framesFilled_ -= nFrames;
-    mutex_.unlock();
   }
 
-  unsigned long index = (frames.frames() - 1) * nChannels;
+  unsigned long index = (frames.frames() - 1) * frames.channels() + channel;
   for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-    lastFrame_[i] = frames[channel+index++];
+    lastFrame_[i] = frames[index++];
 
   return frames;
 }
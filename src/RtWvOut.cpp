@@ -4,9 +4,9 @@
 
     This class provides a simplified interface to RtAudio for realtime
     audio output.  It is a subclass of WvOut.  This class makes use of
-    RtAudio's callback functionality by creating a large ring-buffer
-    into which data is written.  This class should not be used when
-    low-latency is desired.
+    RtAudio's callback functionality by creating a large lock-free
+    ring-buffer (see RingBuffer) into which data is written.  This
+    class should not be used when low-latency is desired.
 
     RtWvOut supports multi-channel data in interleaved format.  It is
     important to distinguish the tick() method that outputs a single
@@ -34,54 +34,25 @@ int write( void *outputBuffer, void *inputBuffer, unsigned int nBufferFrames,
 }
 
 // This function does not block.  If the user does not write output
-// data to the buffer fast enough, previous data will be re-output
-// (data underrun).
+// data to the buffer fast enough, silence is output for the missing
+// frames (data underrun).
 int RtWvOut :: readBuffer( void *buffer, unsigned int frameCount )
 {
-  unsigned int nSamples, nChannels = data_.channels();
-  unsigned int nFrames = frameCount;
-  StkFloat *input = (StkFloat *) &data_[ readIndex_ * nChannels ];
+  unsigned int nChannels = buffer_.channels();
   StkFloat *output = (StkFloat *) buffer;
-  long counter;
-
-  while ( nFrames > 0 ) {
-
-    // I'm assuming that both the RtAudio and StkFrames buffers
-    // contain interleaved data.
-    counter = nFrames;
-
-    // Pre-increment read pointer and check bounds.
-    readIndex_ += nFrames;
-    if ( readIndex_ >= data_.frames() ) {
-      counter -= readIndex_ - data_.frames();
-      readIndex_ = 0;
-    }
-
-    // Copy data from the StkFrames container.
-    if ( status_ == EMPTYING && framesFilled_ <= counter ) {
-      nSamples = framesFilled_ * nChannels;
-      unsigned int i;
-      for ( i=0; i<nSamples; i++ ) *output++ = *input++;
-      nSamples = (counter - framesFilled_) * nChannels;
-      for ( i=0; i<nSamples; i++ ) *output++ = 0.0;
-      status_ = FINISHED;
-      return 1;
-    }
-    else {
-      nSamples = counter * nChannels;
-      for ( unsigned int i=0; i<nSamples; i++ )
-        *output++ = *input++;
-    }
-
-    nFrames -= counter;
+  unsigned long nFrames;
+
+  if ( status_ == EMPTYING && buffer_.framesAvailable() <= frameCount ) {
+    nFrames = buffer_.framesAvailable();
+    buffer_.read( output, nFrames );
+    memset( output + nFrames * nChannels, 0, (frameCount - nFrames) * nChannels * sizeof( StkFloat ) );
+    status_ = FINISHED;
+    return 1;
   }
 
-  mutex_.lock();
-  framesFilled_ -= frameCount;
-  mutex_.unlock();
-  if ( framesFilled_ < 0 ) {
-    framesFilled_ = 0;
-    //    writeIndex_ = readIndex_;
+  nFrames = buffer_.read( output, frameCount );
+  if ( nFrames < frameCount ) {
+    memset( output + nFrames * nChannels, 0, (frameCount - nFrames) * nChannels * sizeof( StkFloat ) );
     oStream_ << "RtWvOut: audio buffer underrun!";
     handleError( StkError::WARNING );
   }
@@ -91,7 +62,7 @@ int RtWvOut :: readBuffer( void *buffer, unsigned int frameCount )
 
 
 RtWvOut :: RtWvOut( unsigned int nChannels, StkFloat sampleRate, int deviceIndex, int bufferFrames, int nBuffers )
-  : stopped_( true ), readIndex_( 0 ), writeIndex_( 0 ), framesFilled_( 0 ), status_(0)
+  : stopped_( true ), status_(0)
 {
   std::vector<unsigned int> deviceIds = dac_.getDeviceIds();
   if ( deviceIds.size() < 1 )
@@ -115,11 +86,10 @@ RtWvOut :: RtWvOut( unsigned int nChannels, StkFloat sampleRate, int deviceIndex
     handleError( dac_.getErrorText(), StkError::AUDIO_SYSTEM );
   }
 
-  data_.resize( size * nBuffers, nChannels );
+  buffer_.resize( size * nBuffers, nChannels );
 
-  // Start writing half-way into buffer.
-  writeIndex_ = (unsigned int ) (data_.frames() / 2.0);
-  framesFilled_ = writeIndex_;
+  // Start writing half-way into the (zero-filled) buffer.
+  buffer_.commitWrite( buffer_.frames() / 2 );
 }
 
 RtWvOut :: ~RtWvOut( void )
@@ -151,28 +121,24 @@ void RtWvOut :: tick( const StkFloat sample )
   if ( stopped_ ) this->start();
 
   // Block until we have room for at least one frame of output data.
-  while ( framesFilled_ == (long) data_.frames() ) Stk::sleep( 1 );
+  buffer_.waitForSpace( 1 );
 
-  unsigned int nChannels = data_.channels();
+  unsigned long nFrames;
+  unsigned int nChannels = buffer_.channels();
+  StkFloat *samples = buffer_.writeRegion( &nFrames );
   StkFloat input = sample;
   clipTest( input );
-  unsigned long index = writeIndex_ * nChannels;
   for ( unsigned int j=0; j<nChannels; j++ )
-    data_[index++] = input;
+    *samples++ = input;
 
-  mutex_.lock();
-  framesFilled_++;
-  mutex_.unlock();
+  buffer_.commitWrite( 1 );
   frameCounter_++;
-  writeIndex_++;
-  if ( writeIndex_ == data_.frames() )
-    writeIndex_ = 0;
 }
 
 void RtWvOut :: tick( const StkFrames& frames )
 {
 #if defined(_STK_DEBUG_)
-  if ( data_.channels() != frames.channels() ) {
+  if ( buffer_.channels() != frames.channels() ) {
     oStream_ << "RtWvOut::tick(): incompatible channel value in StkFrames argument!";
     handleError( StkError::FUNCTION_ARGUMENT );
   }
@@ -183,33 +149,23 @@ void RtWvOut :: tick( const StkFrames& frames )
   // See how much space we have and fill as much as we can ... if we
   // still have samples left in the frames object, then wait and
   // repeat.
-  unsigned int framesEmpty, nFrames, bytes, framesWritten = 0;
-  unsigned int nChannels = data_.channels();
+  unsigned long nFrames, framesWritten = 0;
+  unsigned int nChannels = buffer_.channels();
+  StkFrames *ins = (StkFrames *) &frames;
   while ( framesWritten < frames.frames() ) {
 
     // Block until we have some room for output data.
-    while ( framesFilled_ == (long) data_.frames() ) Stk::sleep( 1 );
-    framesEmpty = data_.frames() - framesFilled_;
+    buffer_.waitForSpace( 1 );
 
-    // Copy data in one chunk up to the end of the data buffer.
-    nFrames = framesEmpty;
-    if ( writeIndex_ + nFrames > data_.frames() )
-      nFrames = data_.frames() - writeIndex_;
+    // Copy data in one chunk up to the end of the ring buffer.
+    StkFloat *samples = buffer_.writeRegion( &nFrames );
     if ( nFrames > frames.frames() - framesWritten )
       nFrames = frames.frames() - framesWritten;
-    bytes = nFrames * nChannels * sizeof( StkFloat );
-    StkFloat *samples = &data_[writeIndex_ * nChannels];
-    StkFrames *ins = (StkFrames *) &frames;
-    memcpy( samples, &(*ins)[framesWritten * nChannels], bytes );
+    memcpy( samples, &(*ins)[framesWritten * nChannels], nFrames * nChannels * sizeof( StkFloat ) );
     for ( unsigned int i=0; i<nFrames * nChannels; i++ ) clipTest( *samples++ );
 
-    writeIndex_ += nFrames;
-    if ( writeIndex_ == data_.frames() ) writeIndex_ = 0;
-
+    buffer_.commitWrite( nFrames );
     framesWritten += nFrames;
-    mutex_.lock();
-    framesFilled_ += nFrames;
-    mutex_.unlock();
     frameCounter_ += nFrames;
   }
 }
@@ -45,6 +45,13 @@ void Sampler :: keyOff( void )
   adsr_.keyOff();
 }
 
+void Sampler :: setInterpolationQuality( Resampler::Quality quality )
+{
+  unsigned int i;
+  for ( i=0; i<attacks_.size(); i++ ) attacks_[i]->setInterpolationQuality( quality );
+  for ( i=0; i<loops_.size(); i++ ) loops_[i]->setInterpolationQuality( quality );
+}
+
 void Sampler :: noteOff( StkFloat amplitude )
 {
   this->keyOff();
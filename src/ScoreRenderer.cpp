@@ -0,0 +1,300 @@
+/***************************************************/
+/*! \class ScoreRenderer
+    \brief STK offline SKINI score renderer.
+
+    This class renders SKINI scorefiles to audio files as fast as
+    possible, without a realtime audio device.  Each score is played
+    by a Voicer holding instruments created by a user-supplied
+    function, followed by a JCRev reverberator, and is written with
+    FileWvOut.  Messages are applied at their exact sample frame and
+    the audio between messages is computed in blocks.  Independent
+    scores, at the same or different sample rates, can be rendered
+    in parallel on several threads.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "ScoreRenderer.h"
+#include "SKINImsg.h"
+#include "Skini.h"
+#include "JCRev.h"
+#include "FileWvOut.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace stk {
+
+ScoreRenderer :: ScoreRenderer( InstrumentCreator creator, void *userData )
+  : creator_( creator ), userData_( userData ), blockSize_( 1024 ), nChannels_( 1 ),
+    fileType_( FileWrite::FILE_WAV ), dataFormat_( STK_SINT16 ), t60_( 0.75 ), effectMix_( 0.2 )
+{
+}
+
+ScoreRenderer :: ~ScoreRenderer( void )
+{
+}
+
+void ScoreRenderer :: setBlockSize( unsigned int nFrames )
+{
+  if ( nFrames == 0 ) {
+    oStream_ << "ScoreRenderer::setBlockSize: block size must be greater than zero!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  blockSize_ = nFrames;
+}
+
+void ScoreRenderer :: setChannels( unsigned int nChannels )
+{
+  if ( nChannels < 1 || nChannels > 2 ) {
+    oStream_ << "ScoreRenderer::setChannels: number of channels must be 1 or 2!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  nChannels_ = nChannels;
+}
+
+void ScoreRenderer :: setFileFormat( FileWrite::FILE_TYPE type, Stk::StkFormat format )
+{
+  fileType_ = type;
+  dataFormat_ = format;
+}
+
+void ScoreRenderer :: setReverb( StkFloat t60, StkFloat mix )
+{
+  if ( t60 <= 0.0 ) {
+    oStream_ << "ScoreRenderer::setReverb: T60 argument must be positive!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  t60_ = t60;
+  effectMix_ = mix;
+}
+
+ScoreRenderer::Report ScoreRenderer :: render( const Job& job ) const
+{
+  Report report;
+  report.scoreFile = job.scoreFile;
+  report.outputFile = job.outputFile;
+
+  // The instruments, reverberator and output file are created within
+  // the context of the score.
+  RenderContext context( ( job.sampleRate > 0.0 ) ? job.sampleRate : Stk::sampleRate(), blockSize_ );
+  RenderContext::Scope scope( context );
+
+  std::vector<Instrmnt *> instruments;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  try {
+    report.ok = this->renderScore( job, report, instruments );
+  }
+  catch ( StkError& error ) {
+    report.ok = false;
+    report.error = error.getMessage();
+  }
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+  for ( unsigned int i=0; i<instruments.size(); i++ )
+    delete instruments[i];
+
+  report.renderTime = std::chrono::duration<double>( stop - start ).count();
+  report.audioTime = report.frames / Stk::sampleRate();
+  if ( report.renderTime > 0.0 )
+    report.realtimeFactor = report.audioTime / report.renderTime;
+
+  if ( !report.ok ) {
+    oStream_ << "ScoreRenderer::render: " << job.scoreFile << ": " << report.error;
+    handleError( StkError::WARNING );
+  }
+
+  return report;
+}
+
+std::vector<ScoreRenderer::Report> ScoreRenderer :: render( const std::vector<Job>& jobs, unsigned int nThreads ) const
+{
+  std::vector<Report> reports( jobs.size() );
+  if ( nThreads == 0 ) nThreads = std::thread::hardware_concurrency();
+  if ( nThreads == 0 ) nThreads = 1;
+  if ( nThreads > jobs.size() ) nThreads = (unsigned int) jobs.size();
+
+  // Each thread takes the next unrendered score until none are left.
+  // The scores without a sample rate use the rate of this thread.
+  std::atomic<size_t> next( 0 );
+  RenderContext context( Stk::sampleRate(), blockSize_ );
+  auto renderJobs = [this, &jobs, &reports, &next, &context]() {
+    RenderContext::Scope scope( context );
+    size_t i;
+    while ( ( i = next++ ) < jobs.size() )
+      reports[i] = this->render( jobs[i] );
+  };
+
+  std::vector<std::thread> threads;
+  for ( unsigned int i=1; i<nThreads; i++ )
+    threads.push_back( std::thread( renderJobs ) );
+  renderJobs();
+  for ( unsigned int i=0; i<threads.size(); i++ )
+    threads[i].join();
+
+  return reports;
+}
+
+bool ScoreRenderer :: renderScore( const Job& job, Report& report, std::vector<Instrmnt *>& instruments ) const
+{
+  Skini score;
+  if ( !score.setFile( job.scoreFile ) ) {
+    report.error = "unable to open scorefile";
+    return false;
+  }
+
+  Voicer voicer( 0.0 );
+  int program = job.program;
+  for ( unsigned int i=0; i<job.nVoices; i++ ) {
+    Instrmnt *instrument = creator_( program, userData_ );
+    if ( instrument == 0 ) {
+      report.error = "no instrument for program number";
+      return false;
+    }
+    instruments.push_back( instrument );
+    voicer.addInstrument( instrument );
+  }
+
+  JCRev reverb( t60_ );
+  reverb.setEffectMix( effectMix_ );
+  FileWvOut output( job.outputFile, nChannels_, fileType_, dataFormat_ );
+
+  StkFrames block( blockSize_, 2 ), mono( blockSize_, 1 );
+  StkFloat volume = 1.0;
+  unsigned long settleFrames = (unsigned long) ( 0.3 * t60_ * Stk::sampleRate() );
+
+  // Compute nFrames frames in blocks of at most blockSize_ frames.
+  auto renderFrames = [&]( unsigned long nFrames ) {
+    while ( nFrames > 0 ) {
+      unsigned int n = ( nFrames < blockSize_ ) ? (unsigned int) nFrames : blockSize_;
+      block.resize( n, 2 );
+      voicer.tick( block, 0 );
+      reverb.tick( block, 0 );
+      if ( nChannels_ == 1 ) {
+        mono.resize( n, 1 );
+        for ( unsigned int i=0; i<n; i++ )
+          mono[i] = volume * block( i, 0 );
+        output.tick( mono );
+      }
+      else {
+        for ( unsigned int i=0; i<block.size(); i++ )
+          block[i] *= volume;
+        output.tick( block );
+      }
+      report.frames += n;
+      nFrames -= n;
+    }
+  };
+
+  Skini::Message message;
+  unsigned long eventFrame = 0;
+  int frequency = 0;
+  bool done = false;
+  while ( !done && score.nextMessage( message ) > 0 ) {
+    report.messages++;
+
+    // Delta times are counted from the previous message, while
+    // absolute times (negative values) are counted from the start.
+    if ( message.time >= 0.0 )
+      eventFrame += (unsigned long) ( message.time * Stk::sampleRate() );
+    else if ( (unsigned long) ( -message.time * Stk::sampleRate() ) > eventFrame )
+      eventFrame = (unsigned long) ( -message.time * Stk::sampleRate() );
+    if ( eventFrame > report.frames )
+      renderFrames( eventFrame - report.frames );
+
+    StkFloat value1 = message.floatValues[0];
+    StkFloat value2 = message.floatValues[1];
+    switch( message.type ) {
+
+    case __SK_Exit_:
+      done = true;
+      break;
+
+    case __SK_NoteOn_:
+      if ( value2 > 0.0 ) { // velocity > 0
+        voicer.noteOn( value1, value2 );
+        break;
+      }
+      // else a note off, so continue to next case
+
+    case __SK_NoteOff_:
+      voicer.noteOff( value1, value2 );
+      break;
+
+    case __SK_ControlChange_:
+      if ( value1 == 44.0 )
+        reverb.setEffectMix( value2 * ONE_OVER_128 );
+      else if ( value1 == 7.0 )
+        volume = value2 * ONE_OVER_128;
+      else if ( value1 == 49.0 )
+        voicer.setFrequency( value2 );
+      else if ( value1 == 50.0 )
+        voicer.controlChange( 128, value2 );
+      else if ( value1 == 51.0 )
+        frequency = message.intValues[1];
+      else if ( value1 == 52.0 ) {
+        frequency += ( message.intValues[1] << 7 );
+        // Convert to a fractional MIDI note value
+        StkFloat note = 12.0 * log( frequency / 220.0 ) / log( 2.0 ) + 57.0;
+        voicer.setFrequency( note );
+      }
+      else
+        voicer.controlChange( (int) value1, value2 );
+      break;
+
+    case __SK_AfterTouch_:
+      voicer.controlChange( 128, value1 );
+      break;
+
+    case __SK_PitchChange_:
+      voicer.setFrequency( value1 );
+      break;
+
+    case __SK_PitchBend_:
+      voicer.pitchBend( value1 );
+      break;
+
+    case __SK_Volume_:
+      volume = value1 * ONE_OVER_128;
+      break;
+
+    case __SK_ProgramChange_:
+      if ( program == (int) value1 ) break;
+
+      // Let the current voices settle before replacing them.
+      voicer.silence();
+      renderFrames( settleFrames );
+      eventFrame = report.frames;
+
+      program = (int) value1;
+      for ( unsigned int i=0; i<instruments.size(); i++ ) {
+        voicer.removeInstrument( instruments[i] );
+        delete instruments[i];
+        instruments[i] = creator_( program, userData_ );
+        if ( instruments[i] == 0 ) {
+          program = 0;
+          instruments[i] = creator_( program, userData_ );
+        }
+        if ( instruments[i] == 0 ) {
+          instruments.erase( instruments.begin() + i, instruments.end() );
+          report.error = "no instrument for program number";
+          return false;
+        }
+        voicer.addInstrument( instruments[i] );
+      }
+    }
+  }
+
+  // The end of the score is followed by a short settling period.
+  voicer.silence();
+  renderFrames( settleFrames );
+
+  return true;
+}
+
+} // stk namespace
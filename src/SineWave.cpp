@@ -2,34 +2,40 @@
 /*! \class SineWave
     \brief STK sinusoid oscillator class.
 
-    This class computes and saves a static sine "table" that can be
-    shared by multiple instances.  It has an interface similar to the
-    WaveLoop class but inherits from the Generator class.  Output
-    values are computed using linear interpolation.
-
-    The "table" length, set in SineWave.h, is 2048 samples by default.
+    This class computes and saves static sine "tables" that are
+    shared by all instances using the same table size.  It has an
+    interface similar to the FileLoop class but inherits from the
+    Generator class.  Output values are computed using linear
+    interpolation by default, or with cubic (Catmull-Rom) or no
+    interpolation (see setInterpolation()).
+
+    The table length must be a power of two.  It is 2048 samples by
+    default (TABLE_SIZE, set in SineWave.h) and can be set for each
+    instance.  The phase is a 32-bit fixed-point value whose highest
+    bits give the table index and lowest bits the interpolation
+    coefficient, so that it wraps around the table without a test.
 
     by Perry R. Cook and Gary P. Scavone, 1995--2023.
 */
 /***************************************************/
 
 #include "SineWave.h"
-#include <cmath>
+#include <map>
+#include <vector>
+#include <mutex>
 
 namespace stk {
 
-StkFrames SineWave :: table_;
-
-SineWave :: SineWave( void )
-  : time_(0.0), rate_(1.0), phaseOffset_(0.0)
+SineWave :: SineWave( unsigned long tableSize )
+  : table_(0), tableSize_(0), interpolation_(LINEAR), cycles_(0.0), phase_(0), increment_(0), offset_(0)
 {
-  if ( table_.empty() ) {
-    table_.resize( TABLE_SIZE + 1, 1 );
-    StkFloat temp = 1.0 / TABLE_SIZE;
-    for ( unsigned long i=0; i<=TABLE_SIZE; i++ )
-      table_[i] = sin( TWO_PI * i * temp );
+  if ( tableSize < 4 || tableSize > 1048576 || ( tableSize & ( tableSize - 1 ) ) ) {
+    oStream_ << "SineWave::SineWave: table size (" << tableSize << ") must be a power of two between 4 and 2^20!";
+    handleError( StkError::FUNCTION_ARGUMENT );
   }
 
+  this->setTableSize( tableSize );
+  this->setRate( 1.0 );
   Stk::addSampleRateAlert( this );
 }
 
@@ -38,41 +44,91 @@ SineWave :: ~SineWave()
   Stk::removeSampleRateAlert( this );
 }
 
+const StkFloat *SineWave :: getTable( unsigned long tableSize )
+{
+  // The tables are computed once for each size, even if instances
+  // are created concurrently on several threads, and are never
+  // moved or freed.
+  static std::mutex mutex;
+  static std::map< unsigned long, std::vector<StkFloat> > tables;
+  std::lock_guard<std::mutex> lock( mutex );
+
+  std::vector<StkFloat>& table = tables[tableSize];
+  if ( table.empty() ) {
+    table.resize( tableSize + 3 );
+    double temp = 1.0 / tableSize;
+    for ( unsigned long i=0; i<tableSize+3; i++ )
+      table[i] = (StkFloat) sin( TWO_PI * ( (double) i - 1.0 ) * temp );
+  }
+
+  return &table[1];
+}
+
 void SineWave :: sampleRateChanged( StkFloat newRate, StkFloat oldRate )
 {
-  if ( !ignoreSampleRateChange_ )
-    this->setRate( oldRate * rate_ / newRate );
+  if ( !ignoreSampleRateChange_ ) {
+    cycles_ = oldRate * cycles_ / newRate;
+    increment_ = toPhase( cycles_ );
+  }
 }
 
 void SineWave :: reset( void )
 {
-  time_ = 0.0;
+  phase_ = 0;
+  offset_ = 0;
   lastFrame_[0] = 0;
 }
 
+void SineWave :: setTableSize( unsigned long tableSize )
+{
+  if ( tableSize < 4 || tableSize > 1048576 || ( tableSize & ( tableSize - 1 ) ) ) {
+    oStream_ << "SineWave::setTableSize: table size (" << tableSize << ") must be a power of two between 4 and 2^20!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  // The table index is given by the highest bits of the phase.
+  unsigned int bits = 0;
+  while ( ( 1UL << bits ) < tableSize ) bits++;
+  table_ = getTable( tableSize );
+  tableSize_ = tableSize;
+  shift_ = 32 - bits;
+  mask_ = ( (UINT32) 1 << shift_ ) - 1;
+  scale_ = 1.0 / ( (StkFloat) mask_ + 1.0 );
+}
+
+void SineWave :: setInterpolation( Interpolation interpolation )
+{
+  if ( interpolation < TRUNCATE || interpolation > CUBIC ) {
+    oStream_ << "SineWave::setInterpolation: unknown interpolation method!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  interpolation_ = interpolation;
+}
+
+void SineWave :: setRate( StkFloat rate )
+{
+  cycles_ = (double) rate / tableSize_;
+  increment_ = toPhase( cycles_ );
+}
+
 void SineWave :: setFrequency( StkFloat frequency )
 {
   // This is a looping frequency.
-  this->setRate( TABLE_SIZE * frequency / Stk::sampleRate() );
+  cycles_ = (double) frequency / Stk::sampleRate();
+  increment_ = toPhase( cycles_ );
 }
 
 void SineWave :: addTime( StkFloat time )
 {
   // Add an absolute time in samples.
-  time_ += time;
+  phase_ += toPhase( (double) time / tableSize_ );
 }
 
 void SineWave :: addPhase( StkFloat phase )
 {
-  // Add a time in cycles (one cycle = TABLE_SIZE).
-  time_ += TABLE_SIZE * phase;
-}
-
-void SineWave :: addPhaseOffset( StkFloat phaseOffset )
-{
-  // Add a phase offset relative to any previous offset value.
-  time_ += ( phaseOffset - phaseOffset_ ) * TABLE_SIZE;
-  phaseOffset_ = phaseOffset;
+  // Add a time in cycles (one cycle = tableSize_).
+  phase_ += toPhase( phase );
 }
 
 } // stk namespace
@@ -25,8 +25,9 @@
 
 #include "Skini.h"
 #include "SKINItbl.h"
+#include <algorithm>
 #include <cstdlib>
-#include <sstream>
+#include <cstring>
 
 namespace stk {
 
@@ -60,73 +61,110 @@ long Skini :: nextMessage( Message& message )
 {
   if ( !file_.is_open() ) return 0;
 
-  std::string line;
   bool done = false;
   while ( !done ) {
 
-    // Read a line from the file and skip over invalid messages.
-    if ( std::getline( file_, line ).eof() ) {
+    // Read a line from the file and skip over invalid messages.  The
+    // line buffer is reused, so its memory is allocated only when a
+    // line is longer than any previous one.
+    if ( std::getline( file_, line_ ).eof() ) {
       oStream_ << "// End of Score.  Thanks for using SKINI!!";
       handleError( StkError::STATUS );
       file_.close();
       message.type = 0;
       done = true;
     }
-    else if ( parseString( line, message ) > 0 ) done = true;
+    else if ( parseString( line_.c_str(), message ) > 0 ) done = true;
   }
 
   return message.type;  
 }
 
-void Skini :: tokenize( const std::string&        str,
-                        std::vector<std::string>& tokens,
-                        const std::string&        delimiters )
+unsigned int Skini :: tokenize( const char *line, Token *tokens, unsigned int maxTokens, const char *delimiters )
 {
-  // Skip delimiters at beginning.
-  std::string::size_type lastPos = str.find_first_not_of(delimiters, 0);
-  // Find first "non-delimiter".
-  std::string::size_type pos     = str.find_first_of(delimiters, lastPos);
-
-  while (std::string::npos != pos || std::string::npos != lastPos) {
-    // Found a token, add it to the vector.
-    tokens.push_back(str.substr(lastPos, pos - lastPos));
-    // Skip delimiters.  Note the "not_of"
-    lastPos = str.find_first_not_of(delimiters, pos);
-    // Find next "non-delimiter"
-    pos = str.find_first_of(delimiters, lastPos);
+  unsigned int nTokens = 0;
+  while ( nTokens < maxTokens ) {
+    // Skip delimiters, then find the end of the token.
+    line += strspn( line, delimiters );
+    if ( *line == '\0' ) break;
+    tokens[nTokens].begin = line;
+    tokens[nTokens].length = strcspn( line, delimiters );
+    line += tokens[nTokens++].length;
   }
-} 
+
+  return nTokens;
+}
+
+// Compare a token with a null-terminated string, like strcmp().
+static int compareToken( const char *begin, size_t length, const char *string )
+{
+  int result = strncmp( begin, string, length );
+  if ( result == 0 && string[length] != '\0' ) result = -1;
+  return result;
+}
+
+// The message table indices, sorted by message name.  Of several
+// entries with the same name, the first one in the table comes first.
+struct SkiniIndex {
+  int order[__SK_MaxMsgTypes_];
+
+  SkiniIndex() {
+    for ( int i=0; i<__SK_MaxMsgTypes_; i++ ) order[i] = i;
+    std::stable_sort( order, order + __SK_MaxMsgTypes_, []( int a, int b ) {
+        return strcmp( skini_msgs[a].messageString, skini_msgs[b].messageString ) < 0; } );
+  }
+};
+
+int Skini :: findMessage( const Token& name )
+{
+  static const SkiniIndex index;
+
+  // Binary search for the first entry which is not less than the name.
+  int low = 0, high = __SK_MaxMsgTypes_;
+  while ( low < high ) {
+    int middle = ( low + high ) / 2;
+    if ( compareToken( name.begin, name.length, skini_msgs[index.order[middle]].messageString ) > 0 )
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  if ( low < __SK_MaxMsgTypes_ &&
+       compareToken( name.begin, name.length, skini_msgs[index.order[low]].messageString ) == 0 )
+    return index.order[low];
+  return -1;
+}
 
 long Skini :: parseString( std::string& line, Message& message )
+{
+  return this->parseString( line.c_str(), message );
+}
+
+long Skini :: parseString( const char *line, Message& message )
 {
   message.type = 0;
-  if ( line.empty() ) return message.type;
+  if ( line == 0 || *line == '\0' ) return message.type;
 
   // Check for comment lines.
-  std::string::size_type lastPos = line.find_first_not_of(" ,\t", 0);
-  std::string::size_type pos     = line.find_first_of("/", lastPos);
-  if ( std::string::npos != pos ) {
+  const char *delimiters = " ,\t";
+  if ( strchr( line + strspn( line, delimiters ), '/' ) ) {
     oStream_ << "// Comment Line: " << line;
     handleError( StkError::STATUS );
     return message.type;
   }
 
-  // Tokenize the string.
-  std::vector<std::string> tokens; 
-  this->tokenize( line, tokens, " ,\t");
+  // Tokenize the string in place.  A message never uses more than
+  // the type, time and channel fields and three more.
+  Token tokens[8];
+  unsigned int nTokens = tokenize( line, tokens, 8, delimiters );
 
   // Valid SKINI messages must have at least three fields (type, time,
   // and channel).
-  if ( tokens.size() < 3 ) return message.type;
+  if ( nTokens < 3 ) return message.type;
 
   // Determine message type.
-  int iSkini = 0;
-  while ( iSkini < __SK_MaxMsgTypes_ ) {
-    if ( tokens[0] == skini_msgs[iSkini].messageString ) break;
-    iSkini++;
-  }
-
-  if ( iSkini >= __SK_MaxMsgTypes_ )  {
+  int iSkini = findMessage( tokens[0] );
+  if ( iSkini < 0 )  {
     oStream_ << "Skini::parseString: couldn't parse this line:\n   " << line;
     handleError( StkError::WARNING );
     return message.type;
@@ -135,21 +173,22 @@ long Skini :: parseString( std::string& line, Message& message )
   // Found the type.
   message.type = skini_msgs[iSkini].type;
 
-  // Parse time field.
-  if ( tokens[1][0] == '=' ) {
-    tokens[1].erase( tokens[1].begin() );
-    if ( tokens[1].empty() ) {
+  // Parse time field.  Numeric fields are converted directly from the
+  // line, since each token is followed by a delimiter or the end of
+  // the line, which terminates the conversion.
+  if ( tokens[1].begin[0] == '=' ) {
+    if ( tokens[1].length == 1 ) {
       oStream_ << "Skini::parseString: couldn't parse time field in line:\n   " << line;
       handleError( StkError::WARNING );
       return message.type = 0;
     }
-    message.time = (StkFloat) -atof( tokens[1].c_str() );
+    message.time = (StkFloat) -atof( tokens[1].begin + 1 );
   }
   else
-    message.time = (StkFloat) atof( tokens[1].c_str() );
+    message.time = (StkFloat) atof( tokens[1].begin );
 
   // Parse the channel field.
-  message.channel = atoi( tokens[2].c_str() );
+  message.channel = atoi( tokens[2].begin );
 
   // Parse the remaining fields (maximum of 2 more).
   int iValue = 0;
@@ -157,9 +196,7 @@ long Skini :: parseString( std::string& line, Message& message )
   long dataType = skini_msgs[iSkini].data2;
   while ( dataType != NOPE ) {
 
-//    if ( tokens.size() <= (unsigned int) (iValue+3) ) { //rgh: test iToken rather than always testing iValue+3
-//    if (tokens.size() <= iToken) { //rgh: iToken only tests it more tokens are to be consumed (SK_INT, SK_DBL, SK_STR)
-	  if ((tokens.size() <= iToken) && (dataType < 0))  { //Don't fail if remaining iValues come from skini_msgs[] rather than tokens[].
+	  if ((nTokens <= iToken) && (dataType < 0))  { //Don't fail if remaining iValues come from skini_msgs[] rather than tokens[].
       oStream_ <<  "Skini::parseString: inconsistency between type table and parsed line:\n   " << line;
       handleError( StkError::WARNING );
       return message.type = 0;
@@ -168,20 +205,24 @@ long Skini :: parseString( std::string& line, Message& message )
     switch ( dataType ) {
 
     case SK_INT:
-      message.intValues[iValue] = atoi( tokens[iToken].c_str() ); //rgh: use new index
+      message.intValues[iValue] = atoi( tokens[iToken].begin ); //rgh: use new index
       message.floatValues[iValue] = (StkFloat) message.intValues[iValue];
       ++iToken; //rgh: increment token index and value index (below)
       break;
 
     case SK_DBL:
-      message.floatValues[iValue] = atof( tokens[iToken].c_str() ); //rgh: use new index
+      message.floatValues[iValue] = atof( tokens[iToken].begin ); //rgh: use new index
       message.intValues[iValue] = (long) message.floatValues[iValue];
       ++iToken; //rgh: increment token index and value index (below)
       break;
 
-    case SK_STR: // Must be the last field.
-      message.remainder = tokens[iToken]; //rgh: use new index
+    case SK_STR: { // Must be the last field.
+      size_t length = tokens[iToken].length; //rgh: use new index
+      if ( length >= REMAINDER_SIZE ) length = REMAINDER_SIZE - 1;
+      memcpy( message.remainder, tokens[iToken].begin, length );
+      message.remainder[length] = '\0';
       return message.type;
+    }
 
     default: // MIDI extension message
       message.intValues[iValue] = dataType;
@@ -52,6 +52,8 @@
 
 #include "Stk.h"
 #include <stdlib.h>
+#include <mutex>
+#include <chrono>
 
 namespace stk {
 
@@ -66,7 +68,14 @@ const Stk::StkFormat Stk :: STK_FLOAT64 = 0x20;
 bool Stk :: showWarnings_ = true;
 bool Stk :: printErrors_ = true;
 std::vector<Stk *> Stk :: alertList_;
-std::ostringstream Stk :: oStream_;
+ErrorLog *Stk :: errorLog_ = 0;
+thread_local StkMessageStream Stk :: oStream_;
+thread_local const RenderContext *RenderContext :: current_ = 0;
+
+// Protects alertList_ against concurrent object creation and deletion
+// and global sample rate changes.  It is recursive because objects can
+// be created or deleted by sampleRateChanged() functions.
+static std::recursive_mutex alertMutex;
 
 Stk :: Stk( void )
   : ignoreSampleRateChange_(false)
@@ -79,6 +88,7 @@ Stk :: ~Stk( void )
 
 void Stk :: setSampleRate( StkFloat rate )
 {
+  std::lock_guard<std::recursive_mutex> lock( alertMutex );
   if ( rate > 0.0 && rate != srate_ ) {
     StkFloat oldRate = srate_;
     srate_ = rate;
@@ -97,6 +107,10 @@ void Stk :: sampleRateChanged( StkFloat /*newRate*/, StkFloat /*oldRate*/ )
 
 void Stk :: addSampleRateAlert( Stk *ptr )
 {
+  // Objects created within a render context have a fixed rate.
+  if ( RenderContext::current() ) return;
+
+  std::lock_guard<std::recursive_mutex> lock( alertMutex );
   for ( unsigned int i=0; i<alertList_.size(); i++ )
     if ( alertList_[i] == ptr ) return;
 
@@ -105,6 +119,7 @@ void Stk :: addSampleRateAlert( Stk *ptr )
 
 void Stk :: removeSampleRateAlert( Stk *ptr )
 {
+  std::lock_guard<std::recursive_mutex> lock( alertMutex );
   for ( unsigned int i=0; i<alertList_.size(); i++ ) {
     if ( alertList_[i] == ptr ) {
       alertList_.erase( alertList_.begin() + i );
@@ -192,31 +207,36 @@ void Stk :: sleep(unsigned long milliseconds)
 #endif
 }
 
-void Stk :: handleError( StkError::Type type ) const
+void Stk :: handleError( StkError::Type type )
 {
-  handleError( oStream_.str(), type );
-  oStream_.str( std::string() ); // reset the ostringstream buffer
+  // The stream is reset first, so that it is also reset when an
+  // exception is thrown.
+  const char *message = oStream_.message();
+  oStream_.reset();
+  handleError( message, type );
 }
 
-void Stk :: handleError( const char *message, StkError::Type type )
+void Stk :: handleError( std::string message, StkError::Type type )
 {
-  std::string msg( message );
-  handleError( msg, type );
+  handleError( message.c_str(), type );
 }
 
-void Stk :: handleError( std::string message, StkError::Type type )
+void Stk :: handleError( const char *message, StkError::Type type )
 {
   if ( type == StkError::WARNING || type == StkError::STATUS ) {
     if ( !showWarnings_ ) return;
-    std::cerr << '\n' << message << '\n' << std::endl;
+    if ( errorLog_ ) errorLog_->push( message, type );
+    else std::cerr << '\n' << message << '\n' << std::endl;
   }
   else if (type == StkError::DEBUG_PRINT) {
 #if defined(_STK_DEBUG_)
-    std::cerr << '\n' << message << '\n' << std::endl;
+    if ( errorLog_ ) errorLog_->push( message, type );
+    else std::cerr << '\n' << message << '\n' << std::endl;
 #endif
   }
   else {
-    if ( printErrors_ ) {
+    if ( errorLog_ ) errorLog_->push( message, type );
+    else if ( printErrors_ ) {
       // Print error message before throwing.
       std::cerr << '\n' << message << '\n' << std::endl;
     }
@@ -398,4 +418,82 @@ StkFloat StkFrames :: interpolate( StkFloat frame, unsigned int channel ) const
   return output;
 }
 
+//
+// ErrorLog definitions
+//
+
+ErrorLog :: ErrorLog( unsigned long nMessages )
+  : queue_( nMessages ), printedOverruns_( 0 )
+{
+}
+
+ErrorLog :: ~ErrorLog( void )
+{
+}
+
+bool ErrorLog :: push( const char *message, StkError::Type type )
+{
+  // Write the entry in place, since it is fairly large.
+  unsigned long position;
+  Entry *entry = queue_.claim( position );
+  if ( !entry ) return false;
+
+  entry->type = type;
+  entry->timeStamp = std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+  unsigned int i = 0;
+  if ( message ) {
+    for ( ; i<MESSAGE_SIZE-1 && message[i] != '\0'; i++ )
+      entry->message[i] = message[i];
+  }
+  entry->message[i] = '\0';
+
+  queue_.publish( position );
+  return true;
+}
+
+bool ErrorLog :: pop( Entry& entry )
+{
+  return queue_.pop( entry );
+}
+
+unsigned long ErrorLog :: print( std::ostream& stream )
+{
+  Entry entry;
+  unsigned long count = 0;
+  while ( this->pop( entry ) ) {
+    stream << '\n' << entry.message << '\n' << std::endl;
+    count++;
+  }
+
+  unsigned long overruns = queue_.getOverrunCount();
+  if ( overruns != printedOverruns_ ) {
+    stream << "\nErrorLog: " << overruns - printedOverruns_ << " message(s) dropped!\n" << std::endl;
+    printedOverruns_ = overruns;
+  }
+
+  return count;
+}
+
+//
+// RenderContext definitions
+//
+
+RenderContext :: RenderContext( StkFloat sampleRate, unsigned int blockSize )
+  : sampleRate_( sampleRate ), blockSize_( blockSize )
+{
+  if ( sampleRate <= 0.0 || blockSize == 0 )
+    Stk::handleError( "RenderContext: sample rate and block size must be positive!", StkError::FUNCTION_ARGUMENT );
+}
+
+RenderContext :: Scope :: Scope( const RenderContext& context )
+  : previous_( current_ )
+{
+  current_ = &context;
+}
+
+RenderContext :: Scope :: ~Scope( void )
+{
+  current_ = previous_;
+}
+
 } // stk namespace
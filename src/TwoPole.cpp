@@ -73,4 +73,44 @@ void TwoPole :: setCoefficients( StkFloat b0, StkFloat a1, StkFloat a2, bool cle
   if ( clearState ) this->clear();
 }
 
+void TwoPole :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return;
+
+  const StkFloat gain = gain_, b0 = b_[0], a1 = a_[1], a2 = a_[2];
+  unsigned long i;
+  if ( channelsIn_ == 1 ) {
+    StkFloat x = 0.0, y, y1 = outputs_[1], y2 = outputs_[2];
+    for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+      x = gain * *input;
+      y = b0 * x - a1 * y1 - a2 * y2;
+      y2 = y1;
+      y1 = y;
+      *output = y;
+    }
+
+    inputs_[0] = x;
+    outputs_[1] = y1;
+    outputs_[2] = y2;
+    lastFrame_[0] = y1;
+    return;
+  }
+
+  const unsigned int nChannels = channelsIn_;
+  StkFloat *y1 = &outputs_[nChannels];
+  StkFloat *y2 = &outputs_[2 * nChannels];
+  unsigned int j;
+  for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+    for ( j=0; j<nChannels; j++ ) {
+      StkFloat y = b0 * ( gain * input[j] ) - a1 * y1[j] - a2 * y2[j];
+      y2[j] = y1[j];
+      y1[j] = y;
+      output[j] = y;
+    }
+  }
+
+  for ( j=0; j<nChannels; j++ )
+    lastFrame_[j] = y1[j];
+}
+
 } // stk namespace
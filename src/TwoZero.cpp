@@ -71,4 +71,45 @@ void TwoZero :: setNotch( StkFloat frequency, StkFloat radius )
   b_[2] *= b_[0];
 }
 
+void TwoZero :: tickFrames( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned long nFrames )
+{
+  if ( nFrames == 0 ) return;
+
+  const StkFloat gain = gain_, b0 = b_[0], b1 = b_[1], b2 = b_[2];
+  unsigned long i;
+  if ( channelsIn_ == 1 ) {
+    StkFloat x, x1 = inputs_[1], x2 = inputs_[2], y = 0.0;
+    for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+      x = gain * *input;
+      y = b2 * x2 + b1 * x1 + b0 * x;
+      x2 = x1;
+      x1 = x;
+      *output = y;
+    }
+
+    inputs_[0] = x1;
+    inputs_[1] = x1;
+    inputs_[2] = x2;
+    lastFrame_[0] = y;
+    return;
+  }
+
+  const unsigned int nChannels = channelsIn_;
+  StkFloat *x1 = &inputs_[nChannels];
+  StkFloat *x2 = &inputs_[2 * nChannels];
+  unsigned int j;
+  for ( i=0; i<nFrames; i++, input += iHop, output += oHop ) {
+    for ( j=0; j<nChannels; j++ ) {
+      StkFloat x = gain * input[j];
+      output[j] = b2 * x2[j] + b1 * x1[j] + b0 * x;
+      x2[j] = x1[j];
+      x1[j] = x;
+    }
+  }
+
+  output -= oHop;
+  for ( j=0; j<nChannels; j++ )
+    lastFrame_[j] = output[j];
+}
+
 } // stk namespace
@@ -25,10 +25,13 @@
 
 #include "Voicer.h"
 #include <cmath>
+#include <algorithm>
+#include <functional>
 
 namespace stk {
 
 Voicer :: Voicer( StkFloat decayTime )
+  : ranges_( 0 ), generation_( 0 ), pending_( 0 ), sleepers_( 0 ), quit_( false )
 {
   if ( decayTime < 0.0 ) {
     oStream_ << "Voicer::Voicer: argument (" << decayTime << ") must be positive!";
@@ -38,6 +41,14 @@ Voicer :: Voicer( StkFloat decayTime )
   tags_ = 23456;
   muteTime_ = (int) ( decayTime * Stk::sampleRate() );
   lastFrame_.resize( 1, 1, 0.0 );
+  ranges_ = new TaskRange[1];
+  ranges_[0].tasks = 0;
+}
+
+Voicer :: ~Voicer( void )
+{
+  this->stopWorkers();
+  delete [] ranges_;
 }
 
 void Voicer :: addInstrument( Instrmnt *instrument, int group )
@@ -47,6 +58,10 @@ void Voicer :: addInstrument( Instrmnt *instrument, int group )
   voice.group = group;
   voice.noteNumber = -1;
   voices_.push_back( voice );
+  soundingVoices_.reserve( voices_.size() );
+  voiceFrames_.resize( voices_.size() );
+  voiceLengths_.resize( voices_.size() );
+  this->rebuildIndex();
 
   // Check output channels and resize lastFrame_ if necessary.
   if ( instrument->channelsOut() > lastFrame_.channels() ) {
@@ -69,6 +84,9 @@ void Voicer :: removeInstrument( Instrmnt *instrument )
   }
 
   if ( found ) {
+    // Voice indices have shifted, so rebuild the voice indices.
+    this->rebuildIndex();
+
     // Check output channels and resize lastFrame_ if necessary.
     unsigned int maxChannels = 1;
     for ( i=voices_.begin(); i!=voices_.end(); ++i ) {
@@ -85,61 +103,57 @@ void Voicer :: removeInstrument( Instrmnt *instrument )
 
 long Voicer :: noteOn(StkFloat noteNumber, StkFloat amplitude, int group )
 {
-  unsigned int i;
-  StkFloat frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
-  for ( i=0; i<voices_.size(); i++ ) {
-    if (voices_[i].noteNumber < 0 && voices_[i].group == group) {
-      voices_[i].tag = tags_++;
-      voices_[i].group = group;
-      voices_[i].noteNumber = noteNumber;
-      voices_[i].frequency = frequency;
-      voices_[i].instrument->noteOn( frequency, amplitude * ONE_OVER_128 );
-      voices_[i].sounding = 1;
-      return voices_[i].tag;
-    }
-  }
-
-  // All voices are sounding, so interrupt the oldest voice.
-  int voice = -1;
-  for ( i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].group == group ) {
-      if ( voice == -1 ) voice = i;
-      else if ( voices_[i].tag < voices_[voice].tag ) voice = (int) i;
-    }
-  }
+  std::map<int, unsigned int>::iterator it = groupIndex_.find( group );
+  if ( it == groupIndex_.end() ) return -1;
 
-  if ( voice >= 0 ) {
-    voices_[voice].tag = tags_++;
-    voices_[voice].group = group;
-    voices_[voice].noteNumber = noteNumber;
-    voices_[voice].frequency = frequency;
-    voices_[voice].instrument->noteOn( frequency, amplitude * ONE_OVER_128 );
-    voices_[voice].sounding = 1;
-    return voices_[voice].tag;
+  // Use the first available unused voice or, if all voices are
+  // sounding, interrupt the oldest voice.
+  int voice;
+  Voicer::VoiceGroup& voiceGroup = groups_[it->second];
+  if ( !voiceGroup.freeVoices.empty() ) {
+    std::pop_heap( voiceGroup.freeVoices.begin(), voiceGroup.freeVoices.end(), std::greater<unsigned int>() );
+    voice = voiceGroup.freeVoices.back();
+    voiceGroup.freeVoices.pop_back();
   }
+  else
+    voice = voiceGroup.oldest;
 
-  return -1;
+  StkFloat frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
+  tagIndex_.erase( voices_[voice].tag );
+  voices_[voice].tag = tags_++;
+  tagIndex_[ voices_[voice].tag ] = voice;
+  voices_[voice].noteNumber = noteNumber;
+  voices_[voice].frequency = frequency;
+  this->indexNote( voice, noteNumber );
+  this->makeNewest( voice );
+  voices_[voice].instrument->noteOn( frequency, amplitude * ONE_OVER_128 );
+  voices_[voice].sounding = 1;
+  this->activateVoice( voice );
+  return voices_[voice].tag;
 }
 
 void Voicer :: noteOff( StkFloat noteNumber, StkFloat amplitude, int group )
 {
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].noteNumber == noteNumber && voices_[i].group == group ) {
+  typedef std::multimap<std::pair<int, StkFloat>, unsigned int>::iterator NoteIterator;
+  std::pair<NoteIterator, NoteIterator> range = noteIndex_.equal_range( std::make_pair( group, noteNumber ) );
+  for ( NoteIterator it=range.first; it!=range.second; ++it ) {
+    unsigned int i = it->second;
+    if ( voices_[i].noteNumber == noteNumber ) {
       voices_[i].instrument->noteOff( amplitude * ONE_OVER_128 );
       voices_[i].sounding = -muteTime_;
+      this->activateVoice( i );
     }
   }
 }
 
 void Voicer :: noteOff( long tag, StkFloat amplitude )
 {
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].instrument->noteOff( amplitude * ONE_OVER_128 );
-      voices_[i].sounding = -muteTime_;
-      break;
-    }
-  }
+  int i = this->findVoice( tag );
+  if ( i < 0 ) return;
+
+  voices_[i].instrument->noteOff( amplitude * ONE_OVER_128 );
+  voices_[i].sounding = -muteTime_;
+  this->activateVoice( i );
 }
 
 void Voicer :: setFrequency( StkFloat noteNumber, int group )
@@ -147,7 +161,11 @@ void Voicer :: setFrequency( StkFloat noteNumber, int group )
   StkFloat frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
   for ( unsigned int i=0; i<voices_.size(); i++ ) {
     if ( voices_[i].group == group ) {
-      voices_[i].noteNumber = noteNumber;
+      // Free voices keep noteNumber = -1 so they remain free.
+      if ( voices_[i].noteNumber >= 0 ) {
+        voices_[i].noteNumber = noteNumber;
+        this->indexNote( i, noteNumber );
+      }
       voices_[i].frequency = frequency;
       voices_[i].instrument->setFrequency( frequency );
     }
@@ -156,15 +174,16 @@ void Voicer :: setFrequency( StkFloat noteNumber, int group )
 
 void Voicer :: setFrequency( long tag, StkFloat noteNumber )
 {
+  int i = this->findVoice( tag );
+  if ( i < 0 ) return;
+
   StkFloat frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].noteNumber = noteNumber;
-      voices_[i].frequency = frequency;
-      voices_[i].instrument->setFrequency( frequency );
-      break;
-    }
+  if ( voices_[i].noteNumber >= 0 ) {
+    voices_[i].noteNumber = noteNumber;
+    this->indexNote( i, noteNumber );
   }
+  voices_[i].frequency = frequency;
+  voices_[i].instrument->setFrequency( frequency );
 }
 
 void Voicer :: pitchBend( StkFloat value, int group )
@@ -187,12 +206,9 @@ void Voicer :: pitchBend( long tag, StkFloat value )
     pitchScaler = pow( 0.5, (8192.0-value) / 8192.0 );
   else
     pitchScaler = pow( 2.0, (value-8192.0) / 8192.0 );
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].instrument->setFrequency( (StkFloat) (voices_[i].frequency * pitchScaler) );
-      break;
-    }
-  }
+  int i = this->findVoice( tag );
+  if ( i >= 0 )
+    voices_[i].instrument->setFrequency( (StkFloat) (voices_[i].frequency * pitchScaler) );
 }
 
 void Voicer :: controlChange( int number, StkFloat value, int group )
@@ -205,12 +221,316 @@ void Voicer :: controlChange( int number, StkFloat value, int group )
 
 void Voicer :: controlChange( long tag, int number, StkFloat value )
 {
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].instrument->controlChange( number, value );
-      break;
+  int i = this->findVoice( tag );
+  if ( i >= 0 )
+    voices_[i].instrument->controlChange( number, value );
+}
+
+int Voicer :: findVoice( long tag ) const
+{
+  std::unordered_map<long, unsigned int>::const_iterator it = tagIndex_.find( tag );
+  if ( it == tagIndex_.end() ) return -1;
+  return (int) it->second;
+}
+
+void Voicer :: indexNote( unsigned int index, StkFloat noteNumber )
+{
+  // Entries are removed lazily: a voice whose note has ended keeps its
+  // entry until it is re-indexed, and lookups check the current note.
+  Voicer::Voice& voice = voices_[index];
+  if ( voice.indexedNote == noteNumber ) return;
+  if ( voice.indexedNote >= 0.0 ) {
+    typedef std::multimap<std::pair<int, StkFloat>, unsigned int>::iterator NoteIterator;
+    std::pair<NoteIterator, NoteIterator> range = noteIndex_.equal_range( std::make_pair( voice.group, voice.indexedNote ) );
+    for ( NoteIterator it=range.first; it!=range.second; ++it ) {
+      if ( it->second == index ) {
+        noteIndex_.erase( it );
+        break;
+      }
+    }
+  }
+
+  noteIndex_.insert( std::make_pair( std::make_pair( voice.group, noteNumber ), index ) );
+  voice.indexedNote = noteNumber;
+}
+
+void Voicer :: makeNewest( unsigned int index )
+{
+  Voicer::Voice& voice = voices_[index];
+  Voicer::VoiceGroup& voiceGroup = groups_[voice.groupIndex];
+  if ( voiceGroup.newest == (int) index ) return;
+
+  // Unlink ...
+  if ( voice.older >= 0 ) voices_[voice.older].newer = voice.newer;
+  else voiceGroup.oldest = voice.newer;
+  voices_[voice.newer].older = voice.older;
+
+  // ... and append at the newest end.
+  voice.older = voiceGroup.newest;
+  voice.newer = -1;
+  voices_[voiceGroup.newest].newer = index;
+  voiceGroup.newest = index;
+}
+
+void Voicer :: releaseVoice( unsigned int index )
+{
+  // Return a voice whose sound has ended to its group's free heap.
+  // The heap capacity is reserved in rebuildIndex(), so this never
+  // allocates.
+  Voicer::Voice& voice = voices_[index];
+  if ( voice.noteNumber < 0 ) return;
+  voice.noteNumber = -1;
+  std::vector<unsigned int>& freeVoices = groups_[voice.groupIndex].freeVoices;
+  freeVoices.push_back( index );
+  std::push_heap( freeVoices.begin(), freeVoices.end(), std::greater<unsigned int>() );
+}
+
+void Voicer :: rebuildIndex( void )
+{
+  unsigned int i;
+  groups_.clear();
+  groupIndex_.clear();
+  tagIndex_.clear();
+  noteIndex_.clear();
+  soundingVoices_.clear();
+
+  // Age-ordered group lists are built in tag order.
+  std::vector< std::pair<long, unsigned int> > order;
+  for ( i=0; i<voices_.size(); i++ )
+    order.push_back( std::make_pair( voices_[i].tag, i ) );
+  std::sort( order.begin(), order.end() );
+
+  for ( unsigned int k=0; k<order.size(); k++ ) {
+    i = order[k].second;
+    Voicer::Voice& voice = voices_[i];
+    std::map<int, unsigned int>::iterator it = groupIndex_.find( voice.group );
+    if ( it == groupIndex_.end() ) {
+      it = groupIndex_.insert( std::make_pair( voice.group, (unsigned int) groups_.size() ) ).first;
+      groups_.push_back( Voicer::VoiceGroup() );
+    }
+    voice.groupIndex = it->second;
+
+    Voicer::VoiceGroup& voiceGroup = groups_[voice.groupIndex];
+    voice.older = voiceGroup.newest;
+    voice.newer = -1;
+    if ( voiceGroup.newest >= 0 ) voices_[voiceGroup.newest].newer = i;
+    else voiceGroup.oldest = i;
+    voiceGroup.newest = i;
+    voiceGroup.freeVoices.reserve( voiceGroup.freeVoices.capacity() + 1 );
+  }
+
+  for ( i=0; i<voices_.size(); i++ ) {
+    Voicer::Voice& voice = voices_[i];
+    if ( voice.tag != 0 ) tagIndex_[voice.tag] = i;
+    voice.indexedNote = -1.0;
+    if ( voice.noteNumber < 0 ) {
+      std::vector<unsigned int>& freeVoices = groups_[voice.groupIndex].freeVoices;
+      freeVoices.push_back( i );
+      std::push_heap( freeVoices.begin(), freeVoices.end(), std::greater<unsigned int>() );
+    }
+    else
+      this->indexNote( i, voice.noteNumber );
+    if ( voice.sounding != 0 ) soundingVoices_.push_back( i );
+  }
+}
+
+void Voicer :: activateVoice( unsigned int index )
+{
+  // Keep the list sorted so that voices are always mixed in the same
+  // order as the voice pool.
+  std::vector<unsigned int>::iterator it = std::lower_bound( soundingVoices_.begin(), soundingVoices_.end(), index );
+  if ( it == soundingVoices_.end() || *it != index )
+    soundingVoices_.insert( it, index );
+}
+
+void Voicer :: renderVoice( unsigned int task )
+{
+  Instrmnt *instrument = voices_[ soundingVoices_[task] ].instrument;
+  voiceFrames_[task].resize( voiceLengths_[task], instrument->channelsOut() );
+  instrument->tick( voiceFrames_[task] );
+}
+
+void Voicer :: mixFrames( StkFrames& voiceFrames, StkFrames& frames, unsigned int channel, unsigned int nFrames )
+{
+  unsigned int nChannels = voiceFrames.channels();
+  StkFloat *samples = &frames[channel];
+  StkFloat *voiceSamples = &voiceFrames[0];
+  if ( frames.channels() == nChannels ) {
+    // Contiguous accumulate (vectorizable).
+    unsigned int nSamples = nFrames * nChannels;
+    for ( unsigned int i=0; i<nSamples; i++ )
+      samples[i] += voiceSamples[i];
+  }
+  else {
+    unsigned int j, hop = frames.channels() - nChannels;
+    for ( unsigned int i=0; i<nFrames; i++, samples += hop ) {
+      for ( j=0; j<nChannels; j++ )
+        *samples++ += *voiceSamples++;
+    }
+  }
+}
+
+StkFrames& Voicer :: tick( StkFrames& frames, unsigned int channel )
+{
+  unsigned int nChannels = lastFrame_.channels();
+#if defined(_STK_DEBUG_)
+  if ( channel > frames.channels() - nChannels ) {
+    oStream_ << "Voicer::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  unsigned int i, j, hop = frames.channels() - nChannels;
+  StkFloat *samples = &frames[channel];
+  for ( i=0; i<frames.frames(); i++, samples += hop ) {
+    for ( j=0; j<nChannels; j++ )
+      *samples++ = 0.0;
+  }
+
+  // Each sounding voice is rendered for the whole block (or only
+  // until its decay time runs out, exactly as the single-frame tick()
+  // would).
+  unsigned int nFrames, nTasks = soundingVoices_.size();
+  for ( i=0; i<nTasks; i++ ) {
+    Voicer::Voice& voice = voices_[ soundingVoices_[i] ];
+    nFrames = frames.frames();
+    if ( voice.sounding == 0 )
+      nFrames = 0;
+    else if ( voice.sounding < 0 && (unsigned int) -voice.sounding < nFrames )
+      nFrames = -voice.sounding;
+    voiceLengths_[i] = nFrames;
+  }
+
+  if ( workers_.size() > 0 && nTasks > 1 && nTasks <= TASK_MASK ) {
+    this->renderParallel( nTasks );
+    for ( i=0; i<nTasks; i++ )
+      if ( voiceLengths_[i] > 0 ) this->mixFrames( voiceFrames_[i], frames, channel, voiceLengths_[i] );
+  }
+  else {
+    for ( i=0; i<nTasks; i++ ) {
+      if ( voiceLengths_[i] == 0 ) continue;
+      this->renderVoice( i );
+      this->mixFrames( voiceFrames_[i], frames, channel, voiceLengths_[i] );
     }
   }
+
+  unsigned int k = 0;
+  for ( i=0; i<nTasks; i++ ) {
+    Voicer::Voice& voice = voices_[ soundingVoices_[i] ];
+    if ( voice.sounding < 0 )
+      voice.sounding += voiceLengths_[i];
+    if ( voice.sounding == 0 )
+      this->releaseVoice( soundingVoices_[i] );
+    else
+      soundingVoices_[k++] = soundingVoices_[i];
+  }
+  soundingVoices_.resize( k );
+
+  if ( frames.frames() > 0 ) {
+    samples = &frames[(frames.frames() - 1) * frames.channels() + channel];
+    for ( j=0; j<nChannels; j++ )
+      lastFrame_[j] = samples[j];
+  }
+
+  return frames;
+}
+
+void Voicer :: setRenderThreads( unsigned int nThreads )
+{
+  if ( nThreads == 0 ) nThreads = 1;
+  this->stopWorkers();
+
+  delete [] ranges_;
+  ranges_ = new TaskRange[nThreads];
+  for ( unsigned int i=0; i<nThreads; i++ ) {
+    ranges_[i].tasks = 0;
+  }
+
+  quit_ = false;
+  for ( unsigned int i=1; i<nThreads; i++ )
+    workers_.push_back( std::thread( &Voicer::workerLoop, this, i ) );
+}
+
+void Voicer :: stopWorkers( void )
+{
+  if ( workers_.empty() ) return;
+
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    quit_ = true;
+  }
+  condition_.notify_all();
+  for ( unsigned int i=0; i<workers_.size(); i++ )
+    workers_[i].join();
+  workers_.clear();
+}
+
+void Voicer :: renderParallel( unsigned int nTasks )
+{
+  // Partition the tasks into one contiguous range per thread.  Only
+  // this thread advances the generation counter.
+  unsigned int nThreads = workers_.size() + 1;
+  unsigned long long generation = ( generation_.load( std::memory_order_relaxed ) + 1 ) & 0xffffffULL;
+  pending_.store( nTasks, std::memory_order_relaxed );
+  for ( unsigned int i=0; i<nThreads; i++ ) {
+    unsigned long long begin = (unsigned long long) i * nTasks / nThreads;
+    unsigned long long end = (unsigned long long) (i+1) * nTasks / nThreads;
+    ranges_[i].tasks.store( ( generation << ( 2 * TASK_BITS ) ) | ( end << TASK_BITS ) | begin, std::memory_order_release );
+  }
+
+  // Publish the block and wake any sleeping workers.  The mutex is
+  // only touched when a worker is actually blocked on it.
+  generation_.store( generation );
+  if ( sleepers_.load() > 0 ) {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    condition_.notify_all();
+  }
+
+  this->runTasks( 0, generation );
+  while ( pending_.load( std::memory_order_acquire ) > 0 )
+    std::this_thread::yield();
+}
+
+void Voicer :: runTasks( unsigned int thread, unsigned long long generation )
+{
+  // Start with our own range, then steal from the others.
+  unsigned int nThreads = workers_.size() + 1;
+  for ( unsigned int r=0; r<nThreads; r++ ) {
+    TaskRange& range = ranges_[ (thread + r) % nThreads ];
+    unsigned long long tasks = range.tasks.load( std::memory_order_acquire );
+    while ( ( tasks >> ( 2 * TASK_BITS ) ) == generation ) {
+      unsigned int task = (unsigned int) ( tasks & TASK_MASK );
+      if ( task >= ( ( tasks >> TASK_BITS ) & TASK_MASK ) ) break;
+      if ( range.tasks.compare_exchange_weak( tasks, tasks + 1, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+        if ( voiceLengths_[task] > 0 ) this->renderVoice( task );
+        pending_.fetch_sub( 1, std::memory_order_release );
+        tasks = range.tasks.load( std::memory_order_acquire );
+      }
+    }
+  }
+}
+
+void Voicer :: workerLoop( unsigned int thread )
+{
+  unsigned long long generation, seen = 0;
+  while ( true ) {
+
+    // Spin briefly for the next block, then sleep on the condition
+    // variable.
+    unsigned int spins = 0;
+    while ( ( generation = generation_.load() ) == seen && !quit_.load() ) {
+      if ( ++spins < 64 ) continue;
+      std::unique_lock<std::mutex> lock( mutex_ );
+      sleepers_++;
+      while ( generation_.load() == seen && !quit_.load() )
+        condition_.wait( lock );
+      sleepers_--;
+    }
+
+    if ( quit_.load() ) return;
+    this->runTasks( thread, generation );
+    seen = generation;
+  }
 }
 
 void Voicer :: silence( void )
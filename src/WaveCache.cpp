@@ -0,0 +1,169 @@
+/***************************************************/
+/*! \class WaveCache
+    \brief STK process-wide cache of audio file data.
+
+    This class keeps a single, read-only copy of the sample data of
+    each audio file that has been completely loaded into memory, so
+    that instruments which use the same rawwaves share their
+    wavetables.  Entries are keyed on the file name and a
+    caller-defined variant value and are validated against the file
+    modification time and size.  All functions are static and
+    thread-safe.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "WaveCache.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sys/stat.h>
+
+namespace stk {
+
+struct WaveCacheEntry {
+  std::shared_ptr<const StkFrames> frames;
+  long long modified;
+  long long bytes;
+};
+
+typedef std::map< std::pair<std::string, unsigned int>, WaveCacheEntry > WaveCacheMap;
+
+struct WaveCacheTable {
+  std::mutex mutex;
+  WaveCacheMap entries;
+  std::atomic<bool> enabled;
+  unsigned long hits;
+  unsigned long misses;
+
+  WaveCacheTable() : enabled( true ), hits( 0 ), misses( 0 ) {}
+};
+
+// The table is a function-local static so that it is constructed
+// before first use, even by FileWvIn instances with static storage.
+static WaveCacheTable& cacheTable( void )
+{
+  static WaveCacheTable table;
+  return table;
+}
+
+// Get the modification time and size of a file, returning false if
+// the file does not exist.
+static bool fileStamp( const std::string& fileName, long long *modified, long long *bytes )
+{
+  struct stat info;
+  if ( stat( fileName.c_str(), &info ) != 0 ) return false;
+  *modified = (long long) info.st_mtime;
+  *bytes = (long long) info.st_size;
+  return true;
+}
+
+void WaveCache :: setEnabled( bool enabled )
+{
+  cacheTable().enabled = enabled;
+}
+
+bool WaveCache :: isEnabled( void )
+{
+  return cacheTable().enabled;
+}
+
+std::shared_ptr<const StkFrames> WaveCache :: find( const std::string& fileName, unsigned int variant )
+{
+  WaveCacheTable& table = cacheTable();
+  long long modified = 0, bytes = 0;
+  bool exists = fileStamp( fileName, &modified, &bytes );
+
+  std::lock_guard<std::mutex> lock( table.mutex );
+  WaveCacheMap::iterator it = table.entries.find( std::make_pair( fileName, variant ) );
+  if ( it != table.entries.end() ) {
+    if ( exists && it->second.modified == modified && it->second.bytes == bytes ) {
+      table.hits++;
+      return it->second.frames;
+    }
+
+    // The file has changed or disappeared since it was cached.
+    table.entries.erase( it );
+  }
+
+  table.misses++;
+  return std::shared_ptr<const StkFrames>();
+}
+
+std::shared_ptr<const StkFrames> WaveCache :: insert( const std::string& fileName, unsigned int variant,
+                                                      const std::shared_ptr<const StkFrames>& frames )
+{
+  WaveCacheTable& table = cacheTable();
+  WaveCacheEntry entry;
+  entry.frames = frames;
+  if ( !fileStamp( fileName, &entry.modified, &entry.bytes ) ) return frames;
+
+  std::lock_guard<std::mutex> lock( table.mutex );
+  std::pair<WaveCacheMap::iterator, bool> result = table.entries.insert( std::make_pair( std::make_pair( fileName, variant ), entry ) );
+  if ( !result.second ) {
+    if ( result.first->second.modified == entry.modified && result.first->second.bytes == entry.bytes )
+      return result.first->second.frames;
+    result.first->second = entry;
+  }
+
+  return frames;
+}
+
+void WaveCache :: clear( void )
+{
+  WaveCacheTable& table = cacheTable();
+  std::lock_guard<std::mutex> lock( table.mutex );
+  table.entries.clear();
+}
+
+void WaveCache :: purge( void )
+{
+  WaveCacheTable& table = cacheTable();
+  std::lock_guard<std::mutex> lock( table.mutex );
+  for ( WaveCacheMap::iterator it = table.entries.begin(); it != table.entries.end(); ) {
+    if ( it->second.frames.use_count() == 1 ) it = table.entries.erase( it );
+    else ++it;
+  }
+}
+
+unsigned long WaveCache :: getHitCount( void )
+{
+  WaveCacheTable& table = cacheTable();
+  std::lock_guard<std::mutex> lock( table.mutex );
+  return table.hits;
+}
+
+unsigned long WaveCache :: getMissCount( void )
+{
+  WaveCacheTable& table = cacheTable();
+  std::lock_guard<std::mutex> lock( table.mutex );
+  return table.misses;
+}
+
+unsigned long WaveCache :: getEntryCount( void )
+{
+  WaveCacheTable& table = cacheTable();
+  std::lock_guard<std::mutex> lock( table.mutex );
+  return (unsigned long) table.entries.size();
+}
+
+unsigned long WaveCache :: getMemoryUsage( void )
+{
+  WaveCacheTable& table = cacheTable();
+  std::lock_guard<std::mutex> lock( table.mutex );
+  unsigned long bytes = 0;
+  for ( WaveCacheMap::iterator it = table.entries.begin(); it != table.entries.end(); ++it )
+    bytes += (unsigned long) ( it->second.frames->size() * sizeof( StkFloat ) );
+  return bytes;
+}
+
+void WaveCache :: resetStatistics( void )
+{
+  WaveCacheTable& table = cacheTable();
+  std::lock_guard<std::mutex> lock( table.mutex );
+  table.hits = 0;
+  table.misses = 0;
+}
+
+} // stk namespace
@@ -0,0 +1,172 @@
+/***************************************************/
+/*! \class WaveTable
+    \brief STK band-limited wavetable oscillator class.
+
+    This class generates band-limited sawtooth, square, triangle and
+    impulse train waveforms by reading precomputed tables, which
+    costs one linearly interpolated table lookup per sample.  Each
+    waveform is stored as a set of tables, one for each octave of the
+    fundamental frequency (mipmaps), containing 1, 2, 4 ... 1024
+    harmonics.  The table with the most harmonics which are all below
+    half the sample rate is used for the current frequency, so that
+    the signal contains no aliasing.  Since the number of harmonics
+    changes by octaves, the highest harmonics are up to one octave
+    below half the sample rate.
+
+    The tables are computed with an inverse FFT when a waveform is
+    first used, and are shared by all instances.  Each table is
+    oversampled by a factor of at least eight relative to its highest
+    harmonic, which keeps the interpolation error small.  The phase
+    is a 32-bit fixed-point value, which wraps around without a test.
+
+    The sawtooth, square and triangle waveforms have a nominal peak
+    value of +/-1.0 (with the overshoot of the band-limited
+    discontinuities), the sawtooth falls linearly within each period
+    like that of the BlitSaw class, and the impulse train is
+    normalized to a peak value of 1.0 like that of the Blit class.
+
+    by Perry R. Cook and Gary P. Scavone, 1995--2023.
+*/
+/***************************************************/
+
+#include "WaveTable.h"
+#include "FFT.h"
+#include <cmath>
+
+namespace stk {
+
+const StkFloat WaveTable :: ONE_OVER_PHASE = 1.0 / 4294967296.0;
+
+WaveTable :: Table :: Table( Shape shape )
+{
+  FFT fft;
+  for ( unsigned int level=0; level<LEVELS; level++ ) {
+    unsigned int k, nHarmonics = 1 << level;
+    unsigned int size = ( nHarmonics < 16 ) ? 256 : 16 * nHarmonics;
+
+    // The inverse FFT gives a sin( k x ) component for an imaginary
+    // part of -size / 2 and a cos( k x ) component for a real part of
+    // size / 2.
+    std::vector<StkFloat> real( size / 2 + 1, 0.0 ), imag( size / 2 + 1, 0.0 );
+    StkFloat half = 0.5 * size;
+    for ( k=1; k<=nHarmonics; k++ ) {
+      switch ( shape ) {
+      case SAWTOOTH:
+        imag[k] = -half * 2.0 / ( PI * k );
+        break;
+      case SQUARE:
+        if ( k & 1 ) imag[k] = -half * 4.0 / ( PI * k );
+        break;
+      case TRIANGLE:
+        if ( k & 1 ) imag[k] = -half * 8.0 / ( PI * PI * k * k ) * ( ( k & 2 ) ? -1.0 : 1.0 );
+        break;
+      case IMPULSE:
+        real[k] = half * 2.0 / ( 2 * nHarmonics + 1 );
+        break;
+      }
+    }
+    if ( shape == IMPULSE ) real[0] = size / ( 2.0 * nHarmonics + 1.0 );
+
+    fft.setSize( size );
+    levels[level].resize( size + 1 );
+    fft.inverse( &real[0], &imag[0], &levels[level][0] );
+    levels[level][size] = levels[level][0];
+  }
+}
+
+const WaveTable::Table& WaveTable :: getTable( Shape shape )
+{
+  switch ( shape ) {
+  case SQUARE: { static const Table square( SQUARE ); return square; }
+  case TRIANGLE: { static const Table triangle( TRIANGLE ); return triangle; }
+  case IMPULSE: { static const Table impulse( IMPULSE ); return impulse; }
+  default: { static const Table sawtooth( SAWTOOTH ); return sawtooth; }
+  }
+}
+
+WaveTable :: WaveTable( Shape shape, StkFloat frequency )
+  : shape_( shape ), frequency_( 220.0 ), nHarmonics_( 0 ), phase_( 0 ), increment_( 0 )
+{
+  if ( frequency <= 0.0 ) {
+    oStream_ << "WaveTable::WaveTable: argument (" << frequency << ") must be positive!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  this->setShape( shape );
+  this->setFrequency( frequency );
+  Stk::addSampleRateAlert( this );
+}
+
+WaveTable :: ~WaveTable( void )
+{
+  Stk::removeSampleRateAlert( this );
+}
+
+void WaveTable :: sampleRateChanged( StkFloat /*newRate*/, StkFloat /*oldRate*/ )
+{
+  // Keep the frequency in Hz, which also updates the table level.
+  if ( !ignoreSampleRateChange_ )
+    this->setFrequency( frequency_ );
+}
+
+void WaveTable :: reset( void )
+{
+  phase_ = 0;
+  lastFrame_[0] = 0.0;
+}
+
+void WaveTable :: setShape( Shape shape )
+{
+  if ( shape < SAWTOOTH || shape > IMPULSE ) {
+    oStream_ << "WaveTable::setShape: unknown waveform shape!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  shape_ = shape;
+  table_ = &getTable( shape );
+  this->updateLevel();
+}
+
+void WaveTable :: setFrequency( StkFloat frequency )
+{
+  if ( frequency <= 0.0 ) {
+    oStream_ << "WaveTable::setFrequency: argument (" << frequency << ") must be positive!";
+    handleError( StkError::WARNING ); return;
+  }
+
+  frequency_ = frequency;
+  StkFloat cycles = frequency / Stk::sampleRate();
+  increment_ = (UINT32) ( ( cycles - floor( cycles ) ) * 4294967296.0 );
+  this->updateLevel();
+}
+
+void WaveTable :: setHarmonics( unsigned int nHarmonics )
+{
+  nHarmonics_ = nHarmonics;
+  this->updateLevel();
+}
+
+void WaveTable :: setPhase( StkFloat phase )
+{
+  phase_ = (UINT32) ( ( phase - floor( phase ) ) * 4294967296.0 );
+}
+
+void WaveTable :: updateLevel( void )
+{
+  unsigned long nHarmonics = (unsigned long) ( 0.5 * Stk::sampleRate() / frequency_ );
+  if ( nHarmonics_ > 0 && nHarmonics_ < nHarmonics ) nHarmonics = nHarmonics_;
+
+  unsigned int level = 0;
+  while ( level < LEVELS - 1 && ( 2UL << level ) <= nHarmonics ) level++;
+
+  // The table index is given by the highest bits of the phase.
+  const std::vector<StkFloat>& data = table_->levels[level];
+  unsigned int bits = 0;
+  while ( ( 1UL << bits ) < data.size() - 1 ) bits++;
+  data_ = &data[0];
+  shift_ = 32 - bits;
+  mask_ = ( (UINT32) 1 << shift_ ) - 1;
+  scale_ = 1.0 / ( (StkFloat) mask_ + 1.0 );
+}
+
+} // stk namespace